@@ -0,0 +1,74 @@
+// Бенчмарк оценщиков ориентации на плате MCU1: средние такты на
+// обновление для комплементарного фильтра (float или ATTITUDE_FIXED —
+// как собран) и для Mahony. Результат — текстом в UART (57600).
+//
+// Отсчёты синтетические, но с настоящим разбросом: качание по крену и
+// тангажу с шумом, чтобы сработали все ветки весов и коррекции.
+//
+//   make bench-attitude && make flash-bench-attitude
+#include "./lib/Attitude/attitude.h"
+#include "./lib/Print/print.h"
+#include "./lib/UART/uart.h"
+
+#include <avr/io.h>
+#include <stdint.h>
+
+#define N 256
+#define DT_US 2000
+
+static volatile int16_t sink;
+
+// Отсчёт i: треугольная волна по крену и тангажу, без тригонометрии —
+// чтобы генератор не мерил сам себя
+static void make_sample(uint16_t i, int16_t accel[3], int16_t gyro[3]) {
+  static uint16_t lfsr = 0xACE1;
+  lfsr = (lfsr >> 1) ^ (-(lfsr & 1u) & 0xB400u);
+  int16_t noise = (int16_t)(lfsr & 0x1FF) - 256;
+
+  int16_t phase = (int16_t)(i & 0x7F) - 64; // -64..63
+  int16_t tri = (phase < 0) ? -phase : phase;
+  accel[0] = tri * 64 - 2048 + noise;
+  accel[1] = tri * 96 - 3072 - noise;
+  accel[2] = 16000 + noise;
+  gyro[0] = (phase < 0) ? -300 : 300;
+  gyro[1] = (phase < 0) ? 200 : -200;
+  gyro[2] = noise >> 4;
+}
+
+static void bench(const Estimator *e) {
+  int16_t accel[3], gyro[3];
+  uint32_t cycles = 0;
+
+  e->reset();
+  make_sample(0, accel, gyro);
+  e->update(accel, gyro, DT_US); // первый отсчёт выставляет начальный угол
+
+  for (uint16_t i = 1; i <= N; i++) {
+    make_sample(i, accel, gyro);
+    uint16_t t0 = TCNT1;
+    e->update(accel, gyro, DT_US);
+    cycles += (uint16_t)(TCNT1 - t0);
+  }
+  sink = e->roll() + e->pitch();
+
+  print_str(uart_putc, e->name);
+  print_str(uart_putc, " cycles/update=");
+  print_u32(uart_putc, cycles / N);
+  print_str(uart_putc, "\r\n");
+}
+
+int main(void) {
+  uart_init_send();
+
+  TCCR1A = 0;
+  TCCR1B = (1 << CS10); // без делителя: 1 тик = 1 такт
+
+  print_str(uart_putc, "\r\nEstimators, accel decimation ");
+  print_u32(uart_putc, ATTITUDE_ACCEL_DECIM);
+  print_str(uart_putc, "\r\n");
+  bench(&COMPLEMENTARY_ESTIMATOR);
+  bench(&MAHONY_ESTIMATOR);
+
+  while (1)
+    ;
+}
@@ -0,0 +1,202 @@
+// Бенчмарк FastMath против avr-libm на плате MCU1.
+// Для каждой функции: средние такты на вызов и наибольшее расхождение
+// с libm на тех же входах. Результат — текстом в UART (57600).
+//
+//   make bench-fastmath && make flash-bench-fastmath
+#include "./lib/FastMath/fastmath.h"
+#include "./lib/Print/print.h"
+#include "./lib/UART/uart.h"
+
+#include <avr/io.h>
+#include <math.h>
+#include <stdint.h>
+
+#define N 64
+#define PI_F 3.14159265f
+
+static float in_a[N], in_b[N];
+static volatile float sink;
+
+// Аргументы и результаты замеряемого вызова идут через volatile: иначе
+// компилятор свернёт вызов libm с известным аргументом или вынесет его
+// за чтение TCNT1
+static volatile float arg_a, arg_b, out_f;
+static volatile int32_t arg_y, arg_x;
+static volatile uint32_t arg_v;
+static volatile uint16_t arg_angle;
+static volatile int16_t out_i;
+static volatile uint16_t out_u;
+
+// Такты пустого замера с одним и двумя аргументами (загрузка volatile
+// и запись результата): вычитаются из каждого результата
+static uint16_t overhead1, overhead2;
+
+// Один вызов < 65536 тактов, поэтому хватает TCNT1 без делителя
+#define MEASURE(total, base, expr)                                             \
+  do {                                                                         \
+    uint16_t t0 = TCNT1;                                                       \
+    expr;                                                                      \
+    total += (uint16_t)(TCNT1 - t0) - base;                                    \
+  } while (0)
+
+static void report(const char *name, uint32_t libm, uint32_t fast, float err) {
+  print_str(uart_putc, name);
+  print_str(uart_putc, " libm=");
+  print_u32(uart_putc, libm / N);
+  print_str(uart_putc, " fast=");
+  print_u32(uart_putc, fast / N);
+  // Расхождение — в миллионных долях единицы результата
+  print_str(uart_putc, " maxerr_e6=");
+  print_u32(uart_putc, (uint32_t)(err * 1e6f));
+  print_str(uart_putc, "\r\n");
+}
+
+static float max_err(float err, float a, float b) {
+  float d = fabsf(a - b);
+  return (d > err) ? d : err;
+}
+
+// Псевдослучайные входы в [lo, hi]: LFSR, чтобы не тянуть rand()
+static void fill_inputs(float lo, float hi) {
+  static uint16_t lfsr = 0xACE1;
+  for (uint8_t i = 0; i < N; i++) {
+    lfsr = (lfsr >> 1) ^ (-(lfsr & 1u) & 0xB400u);
+    in_a[i] = lo + (hi - lo) * (lfsr / 65535.0f);
+    lfsr = (lfsr >> 1) ^ (-(lfsr & 1u) & 0xB400u);
+    in_b[i] = lo + (hi - lo) * (lfsr / 65535.0f);
+  }
+}
+
+int main(void) {
+  uart_init_send();
+
+  TCCR1A = 0;
+  TCCR1B = (1 << CS10); // без делителя: 1 тик = 1 такт
+  uint32_t empty = 0;
+  MEASURE(empty, 0, out_f = arg_a);
+  overhead1 = (uint16_t)empty;
+  empty = 0;
+  MEASURE(empty, 0, (void)arg_b; out_f = arg_a);
+  overhead2 = (uint16_t)empty;
+
+  print_str(uart_putc, "\r\nFastMath vs libm, cycles per call\r\n");
+
+  uint32_t t_libm, t_fast;
+  float err, a, b;
+
+  fill_inputs(-2.0f, 2.0f);
+  t_libm = t_fast = 0;
+  err = 0;
+  for (uint8_t i = 0; i < N; i++) {
+    arg_a = in_a[i];
+    arg_b = in_b[i];
+    MEASURE(t_libm, overhead2, out_f = atan2f(arg_a, arg_b));
+    a = out_f;
+    MEASURE(t_fast, overhead2, out_f = fm_atan2f(arg_a, arg_b));
+    b = out_f;
+    err = max_err(err, a, b);
+  }
+  report("atan2f", t_libm, t_fast, err);
+
+  fill_inputs(0.0f, 4.0f);
+  t_libm = t_fast = 0;
+  err = 0;
+  for (uint8_t i = 0; i < N; i++) {
+    arg_a = in_a[i];
+    MEASURE(t_libm, overhead1, out_f = sqrtf(arg_a));
+    a = out_f;
+    MEASURE(t_fast, overhead1, out_f = fm_sqrtf(arg_a));
+    b = out_f;
+    err = max_err(err, a, b);
+  }
+  report("sqrtf", t_libm, t_fast, err);
+
+  fill_inputs(-2 * PI_F, 2 * PI_F);
+  t_libm = t_fast = 0;
+  err = 0;
+  for (uint8_t i = 0; i < N; i++) {
+    arg_a = in_a[i];
+    MEASURE(t_libm, overhead1, out_f = sinf(arg_a));
+    a = out_f;
+    MEASURE(t_fast, overhead1, out_f = fm_sinf(arg_a));
+    b = out_f;
+    err = max_err(err, a, b);
+  }
+  report("sinf", t_libm, t_fast, err);
+
+  t_libm = t_fast = 0;
+  err = 0;
+  for (uint8_t i = 0; i < N; i++) {
+    arg_a = in_a[i];
+    MEASURE(t_libm, overhead1, out_f = cosf(arg_a));
+    a = out_f;
+    MEASURE(t_fast, overhead1, out_f = fm_cosf(arg_a));
+    b = out_f;
+    err = max_err(err, a, b);
+  }
+  report("cosf", t_libm, t_fast, err);
+
+  fill_inputs(-100.0f, 100.0f);
+  t_libm = t_fast = 0;
+  err = 0;
+  for (uint8_t i = 0; i < N; i++) {
+    arg_a = in_a[i];
+    MEASURE(t_libm, overhead1, out_f = roundf(arg_a));
+    a = out_f;
+    MEASURE(t_fast, overhead1, out_f = fm_roundf(arg_a));
+    b = out_f;
+    err = max_err(err, a, b);
+  }
+  report("roundf", t_libm, t_fast, err);
+
+  // Целые варианты — против float libm на тех же значениях.
+  // Ошибка atan2_bam — в радианах, sin_bam — в долях единицы.
+  fill_inputs(-16384.0f, 16384.0f);
+  t_libm = t_fast = 0;
+  err = 0;
+  for (uint8_t i = 0; i < N; i++) {
+    arg_y = (int32_t)in_a[i];
+    arg_x = (int32_t)in_b[i];
+    MEASURE(t_libm, overhead2, out_f = atan2f(arg_y, arg_x));
+    a = out_f;
+    MEASURE(t_fast, overhead2, out_i = fm_atan2_bam(arg_y, arg_x));
+    int16_t bam = out_i;
+    float d = fabsf(a - bam * (PI_F / 32768.0f));
+    if (d > PI_F)
+      d = 2 * PI_F - d; // ±π — один и тот же угол
+    err = (d > err) ? d : err;
+  }
+  report("atan2_bam", t_libm, t_fast, err);
+
+  // Для больших v float sqrt сам ошибается на единицу — это не ошибка isqrt
+  fill_inputs(0.0f, 2.0e9f);
+  t_libm = t_fast = 0;
+  err = 0;
+  for (uint8_t i = 0; i < N; i++) {
+    arg_v = (uint32_t)in_a[i];
+    MEASURE(t_libm, overhead1, out_f = sqrtf(arg_v));
+    a = out_f;
+    MEASURE(t_fast, overhead1, out_u = fm_isqrt32(arg_v));
+    uint16_t r = out_u;
+    err = max_err(err, floorf(a), r);
+  }
+  report("isqrt32", t_libm, t_fast, err);
+
+  fill_inputs(-PI_F, PI_F);
+  t_libm = t_fast = 0;
+  err = 0;
+  for (uint8_t i = 0; i < N; i++) {
+    arg_a = in_a[i];
+    arg_angle = (uint16_t)(int32_t)(in_a[i] * (32768.0f / PI_F));
+    MEASURE(t_libm, overhead1, out_f = sinf(arg_a));
+    a = out_f;
+    MEASURE(t_fast, overhead1, out_i = fm_sin_bam(arg_angle));
+    int16_t q15 = out_i;
+    err = max_err(err, a, q15 * (1.0f / 32767.0f));
+  }
+  report("sin_bam", t_libm, t_fast, err);
+
+  sink = err;
+  while (1)
+    ;
+}
@@ -0,0 +1,260 @@
+// Бенчмарк MCU1/MCU2 в simavr: такты на операцию и на кадр по
+// скриптованному качанию. Прошивку запускает tools/simavr_bench, он же
+// изображает MPU6050 на шине TWI и замыкает TX на RX для приёма.
+//
+// Разметка для симулятора: номер операции в GPIOR0 перед ней и 0 после,
+// вложенные операции — стопкой (кадр включает чтения и фильтр). Время
+// обработчиков прерываний симулятор меряет сам — по входу и reti.
+// GPIOR1 = 1 — петля TX → RX включена. Имена операций прошивка печатает
+// в UART строками «op <номер> <имя>», такт рендера — «period <мкс>»,
+// конец прогона — «done».
+//
+// Кадр — такт рендера MCU1 (RENDER_PERIOD_US): SENSOR_TICKS чтений с
+// фильтром, отрисовка с present и пакет на MCU2. Без ожиданий: шаг
+// фильтра фиксированный, качание задаёт модель датчика — по отсчёту на
+// каждое чтение.
+//
+//   make bench-sim
+//   make bench-sim BENCH_FRAME_BUDGET_US=20000 SCREEN_COMPOSITOR=1
+#include "./lib/Attitude/attitude.h"
+#include "./lib/Link/link.h"
+#include "./lib/MPU6050/MPU6050.h"
+#include "./lib/Print/print.h"
+#include "./lib/Timebase/timebase.h"
+#include "./lib/UART/uart.h"
+
+#include <avr/interrupt.h>
+#include <avr/io.h>
+#include <avr/sleep.h>
+#include <stdint.h>
+
+#include "mcu.h"
+
+// Шаг фильтра и отсчётов на кадр — как у задач mcu1.c
+#define SENSOR_PERIOD_US 10000
+#ifndef RENDER_PERIOD_US
+#define RENDER_PERIOD_US 30000 // задаёт Makefile
+#endif
+#define SENSOR_TICKS (RENDER_PERIOD_US / SENSOR_PERIOD_US)
+// Кадров на режим: качание модели датчика — 0 → 45° → -45° → 0 за 180
+// отсчётов, 60 кадров его проходят
+#ifndef BENCH_FRAMES
+#define BENCH_FRAMES 60
+#endif
+// Повторов отдельных примитивов рендера
+#define UI_REPEAT 4
+// Пакетов через петлю TX → RX
+#define LINK_PACKETS 32
+
+#ifdef ATTITUDE_MAHONY
+static const Estimator *estimator = &MAHONY_ESTIMATOR;
+#else
+static const Estimator *estimator = &COMPLEMENTARY_ESTIMATOR;
+#endif
+
+// Номера операций для симулятора; 0 — конец операции
+enum {
+  OP_READ = 1,
+  OP_FILTER,
+  OP_SEND,
+  OP_ROLL_UI,
+  OP_PITCH_UI,
+  OP_SKY_GROUND,
+  OP_RENDER_ROLL,
+  OP_RENDER_PITCH,
+  OP_FRAME_ROLL,
+  OP_FRAME_PITCH,
+  OP_LINK_DECODE,
+  OP_COUNT
+};
+
+static const char *const op_names[OP_COUNT] = {
+    [OP_READ] = "mpu6050_read_all",
+    [OP_FILTER] = "filter_update",
+    [OP_SEND] = "send_attitude_packet",
+    [OP_ROLL_UI] = "draw_roll_ui",
+    [OP_PITCH_UI] = "draw_pitch_ui_full",
+    [OP_SKY_GROUND] = "update_sky_ground",
+    [OP_RENDER_ROLL] = "render_roll",
+    [OP_RENDER_PITCH] = "render_pitch",
+    [OP_FRAME_ROLL] = "frame_roll",
+    [OP_FRAME_PITCH] = "frame_pitch",
+    [OP_LINK_DECODE] = "link_decode",
+};
+
+#define MARK(op) (GPIOR0 = (op))
+#define DONE() (GPIOR0 = 0)
+
+static float roll_angle = 0.0f;
+static float pitch_angle = 0.0f;
+static uint16_t read_errors = 0;
+
+// Отсчёт и фильтр, как task_sensor на MCU1
+static void sensor_tick(void) {
+  MPU6050Sample sample;
+  MARK(OP_READ);
+  MPU6050Status status = mpu6050_read_all(&sample);
+  DONE();
+  if (status != MPU6050_OK) {
+    read_errors++;
+    return;
+  }
+  MARK(OP_FILTER);
+  estimator->update(sample.accel, sample.gyro, SENSOR_PERIOD_US);
+  DONE();
+  roll_angle = ATTITUDE_TO_RAD(estimator->roll());
+  pitch_angle = ATTITUDE_TO_RAD(estimator->pitch());
+}
+
+static void mode_reset(void) {
+  st7735s_flush();
+  if (screen->scroll)
+    screen->scroll(0);
+  screen->clear(&BLACK);
+  roll_first_draw = true;
+  pitch_first_draw = true;
+  pitch_last_horizon_y = -1;
+}
+
+// Такт рендера MCU1: отсчёты, кадр, пакет
+static void frame(uint8_t pitch_mode) {
+  MARK(pitch_mode ? OP_FRAME_PITCH : OP_FRAME_ROLL);
+  for (uint8_t i = 0; i < SENSOR_TICKS; i++)
+    sensor_tick();
+
+  MARK(pitch_mode ? OP_RENDER_PITCH : OP_RENDER_ROLL);
+  if (pitch_mode)
+    draw_pitch_mode(screen, pitch_angle);
+  else
+    draw_roll_mode(screen, roll_angle);
+  if (screen->present)
+    screen->present();
+  st7735s_flush();
+  DONE();
+
+  MARK(OP_SEND);
+  send_attitude_packet(roll_angle, pitch_angle, pitch_mode);
+  DONE();
+  DONE();
+}
+
+// Примитивы рендера по отдельности
+static void bench_primitives(void) {
+  mode_reset();
+  for (uint8_t i = 0; i < UI_REPEAT; i++) {
+    MARK(OP_ROLL_UI);
+    draw_roll_ui(screen);
+    st7735s_flush();
+    DONE();
+  }
+
+  mode_reset();
+  for (uint8_t i = 0; i < UI_REPEAT; i++) {
+    MARK(OP_PITCH_UI);
+    draw_pitch_ui_full(screen, 0.0f);
+    st7735s_flush();
+    DONE();
+  }
+
+  // Горизонт по шагам 5° от -45° до 45° и обратно
+  mode_reset();
+  for (int8_t deg = -45; deg <= 45; deg += 5) {
+    MARK(OP_SKY_GROUND);
+    update_sky_ground(screen, deg * (M_PI / 180.0f));
+    st7735s_flush();
+    DONE();
+  }
+  for (int8_t deg = 40; deg >= -45; deg -= 5) {
+    MARK(OP_SKY_GROUND);
+    update_sky_ground(screen, deg * (M_PI / 180.0f));
+    st7735s_flush();
+    DONE();
+  }
+}
+
+// Приём MCU2: пакеты уходят в петлю, байты копит USART_RX_vect,
+// разбор — как task_link на MCU2
+static void bench_link(void) {
+  LinkDecoder rx;
+  link_decoder_init(&rx);
+  uart_init_read();
+  uint16_t frames = 0;
+
+  GPIOR1 = 1;
+  for (uint8_t i = 0; i < LINK_PACKETS; i++) {
+    send_attitude_packet(roll_angle, pitch_angle, i & 1);
+    uart_flush();
+    // Последний байт ещё идёт по петле
+    uint32_t t0 = timebase_micros();
+    while (timebase_micros() - t0 < 2 * 10 * 1000000UL / UART_BAUD)
+      ;
+
+    MARK(OP_LINK_DECODE);
+    uint8_t buf[16];
+    uint8_t n;
+    while ((n = uart_read(buf, sizeof(buf)))) {
+      for (uint8_t k = 0; k < n; k++) {
+        LinkFrame frame;
+        if (link_decode_byte(&rx, buf[k], &frame))
+          frames++;
+      }
+    }
+    DONE();
+  }
+  GPIOR1 = 0;
+
+  print_str(uart_putc, "link frames=");
+  print_u32(uart_putc, frames);
+  print_str(uart_putc, " errors=");
+  print_u32(uart_putc, rx.errors);
+  print_str(uart_putc, " overflows=");
+  print_u32(uart_putc, uart_rx_overflows);
+  print_str(uart_putc, "\r\n");
+}
+
+int main(void) {
+  timebase_init(); // метки времени отсчётов
+  uart_init_send();
+  sei();
+
+  for (uint8_t i = 1; i < OP_COUNT; i++) {
+    print_str(uart_putc, "op ");
+    print_u32(uart_putc, i);
+    print_str(uart_putc, " ");
+    print_str(uart_putc, op_names[i]);
+    print_str(uart_putc, "\r\n");
+  }
+  print_str(uart_putc, "period ");
+  print_u32(uart_putc, RENDER_PERIOD_US);
+  print_str(uart_putc, "\r\n");
+  uart_flush();
+
+  st7735s_init();
+  mpu6050_init();
+  estimator->reset();
+
+  bench_primitives();
+
+  mode_reset();
+  for (uint8_t i = 0; i < BENCH_FRAMES; i++)
+    frame(0);
+  mode_reset();
+  for (uint8_t i = 0; i < BENCH_FRAMES; i++)
+    frame(1);
+  uart_flush();
+
+  bench_link();
+
+  print_str(uart_putc, "read errors=");
+  print_u32(uart_putc, read_errors);
+  print_str(uart_putc, "\r\ndone\r\n");
+  uart_flush();
+
+  // Сон с запрещёнными прерываниями — simavr завершает прогон
+  cli();
+  set_sleep_mode(SLEEP_MODE_PWR_DOWN);
+  sleep_enable();
+  sleep_cpu();
+  while (1)
+    ;
+}
@@ -0,0 +1,131 @@
+#include "attitude.h"
+
+#include "../FastMath/fastmath.h"
+#include <math.h>
+
+#ifndef ATTITUDE_FIXED
+
+// --- float: прежний фильтр из mcu1.c ---
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846f
+#endif
+
+static float roll_angle = 0.0f;
+static float pitch_angle = 0.0f;
+
+void attitude_reset(void) {
+  roll_angle = 0.0f;
+  pitch_angle = 0.0f;
+}
+
+void attitude_update(const int16_t accel[3], const int16_t gyro[3],
+                     uint16_t dt_us) {
+  const float dt = dt_us * 1e-6f;
+  const float accel_scale = 16384.0f;
+  const float gyro_scale = 131.0f;
+  float ax = (float)accel[0] / accel_scale;
+  float ay = (float)accel[1] / accel_scale;
+  float az = (float)accel[2] / accel_scale;
+  float gx = (float)gyro[0] / gyro_scale;
+
+  // Обновление roll
+  float roll_gyro = roll_angle + (gx * (M_PI / 180.0f)) * dt;
+  float roll_accel = FM_ATAN2(ay, az);
+  float acc_mag = FM_SQRT(ax * ax + ay * ay + az * az);
+  float acc_error = fabsf(acc_mag - 1.0f);
+  float w = (acc_error < 0.05f)   ? 0.10f
+            : (acc_error < 0.15f) ? 0.05f
+                                  : 0.015f;
+  w *= dt_us * (1.0f / ATTITUDE_NOMINAL_DT_US);
+  roll_angle = (1.0f - w) * roll_gyro + w * roll_accel;
+  if (roll_angle > M_PI)
+    roll_angle -= 2.0f * M_PI;
+  if (roll_angle < -M_PI)
+    roll_angle += 2.0f * M_PI;
+
+  // Обновление pitch
+  pitch_angle = FM_ATAN2(-ax, FM_SQRT(ay * ay + az * az));
+}
+
+static int16_t to_bam(float rad) {
+  return (int16_t)(int32_t)FM_ROUND(rad * (32768.0f / M_PI));
+}
+
+int16_t attitude_roll(void) { return to_bam(roll_angle); }
+int16_t attitude_pitch(void) { return to_bam(pitch_angle); }
+
+#else
+
+// --- целочисленный вариант ---
+
+// Скорость от отсчёта гироскопа: 2^32 на оборот за мкс на LSB, Q19:
+// 2^32 / (360° * 131 LSB * 10^6) * 2^19 — константа времени компиляции
+#define GYRO_K_US ((int32_t)(4294967296.0 / (360.0 * 131.0 * 1e6) * 524288.0 + 0.5))
+
+// Приращение угла за dt_us: rate * dt как 48-битное произведение
+// из двух умножений 32×16, без int64
+static int32_t gyro_increment(int16_t gyro, uint16_t dt_us) {
+  int32_t rate = (int32_t)gyro * GYRO_K_US;
+  int32_t hi = (rate >> 16) * (int32_t)dt_us;
+  uint32_t lo = (uint32_t)(rate & 0xFFFF) * dt_us;
+  return (hi + (int32_t)(lo >> 16)) >> 3;
+}
+
+// Границы |a| = 1g ± 5% и ± 15% в квадратах отсчётов (1g = 16384)
+#define G2 (16384.0 * 16384.0)
+#define MAG2_LO_5 ((uint32_t)(0.95 * 0.95 * G2))
+#define MAG2_HI_5 ((uint32_t)(1.05 * 1.05 * G2))
+#define MAG2_LO_15 ((uint32_t)(0.85 * 0.85 * G2))
+#define MAG2_HI_15 ((uint32_t)(1.15 * 1.15 * G2))
+
+// Вес акселерометра (1 - alpha) для alpha = 0.90 / 0.95 / 0.985 на шаге
+// 10 мс, на микросекунду в Q32: вес в Q16 = (W * dt_us) >> 16
+#define W_US(w) ((uint32_t)((w) * 65536.0 * 65536.0 / ATTITUDE_NOMINAL_DT_US + 0.5))
+#define W_5 W_US(0.10)
+#define W_15 W_US(0.05)
+#define W_REST W_US(0.015)
+
+static uint32_t roll_angle = 0; // 2^32 = оборот
+static int16_t pitch_angle = 0; // 2^16 = оборот
+
+void attitude_reset(void) {
+  roll_angle = 0;
+  pitch_angle = 0;
+}
+
+void attitude_update(const int16_t accel[3], const int16_t gyro[3],
+                     uint16_t dt_us) {
+  const int32_t ax = accel[0], ay = accel[1], az = accel[2];
+
+  // Гироскоп: интегрирование по кругу 2^32
+  uint32_t roll_gyro = roll_angle + (uint32_t)gyro_increment(gyro[0], dt_us);
+
+  // Акселерометр и его вес по отклонению |a| от 1g
+  uint32_t yz2 = (uint32_t)(ay * ay) + (uint32_t)(az * az);
+  uint32_t mag2 = yz2 + (uint32_t)(ax * ax);
+  uint32_t w_us = (mag2 > MAG2_LO_5 && mag2 < MAG2_HI_5)     ? W_5
+                  : (mag2 > MAG2_LO_15 && mag2 < MAG2_HI_15) ? W_15
+                                                             : W_REST;
+  uint16_t w = (w_us * dt_us) >> 16;
+
+  // roll = roll_gyro + w * (roll_accel - roll_gyro) по кратчайшей дуге
+  int16_t roll_accel = fm_atan2_bam(ay, az);
+  int16_t diff = roll_accel - (int16_t)(roll_gyro >> 16);
+  roll_angle = roll_gyro + (uint32_t)((int32_t)diff * w);
+
+  pitch_angle = fm_atan2_bam(-ax, fm_isqrt32(yz2));
+}
+
+int16_t attitude_roll(void) { return (int16_t)(roll_angle >> 16); }
+int16_t attitude_pitch(void) { return pitch_angle; }
+
+#endif // ATTITUDE_FIXED
+
+const Estimator COMPLEMENTARY_ESTIMATOR = {
+    .name = "compl",
+    .reset = attitude_reset,
+    .update = attitude_update,
+    .roll = attitude_roll,
+    .pitch = attitude_pitch,
+};
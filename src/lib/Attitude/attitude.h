@@ -0,0 +1,72 @@
+#ifndef ATTITUDE_H
+#define ATTITUDE_H
+
+#include <stdint.h>
+
+// Комплементарный фильтр крена и тангаж по акселерометру.
+// На входе — сырые отсчёты MPU6050 (±2g: 16384 LSB/g, ±250°/с: 131 LSB/(°/с),
+// гироскоп уже без смещений), на выходе — двоичные углы.
+//
+// Две реализации с одинаковым поведением:
+//  - по умолчанию float, как раньше в mcu1.c;
+//  - ATTITUDE_FIXED: только целые. Крен хранится как uint32_t, где 2^32 —
+//    полный оборот, поэтому переход через ±180° получается сам собой;
+//    atan2 и корень — целочисленные из FastMath, модуль ускорения
+//    сравнивается в квадратах, без sqrt.
+// Float-вариант с USE_FASTMATH берёт atan2/sqrt из FastMath.
+
+// Вес акселерометра задан для шага 10 мс и масштабируется пропорционально
+// фактическому шагу, поэтому постоянная времени фильтра от частоты
+// отсчётов не зависит.
+#define ATTITUDE_NOMINAL_DT_US 10000
+
+// Двоичный угол: 65536 = полный оборот, -32768..32767 = -π..π
+#define ATTITUDE_TO_RAD(a) ((float)(a) * (3.14159265f / 32768.0f))
+#define ATTITUDE_TO_DEG(a) ((float)(a) * (180.0f / 32768.0f))
+
+void attitude_reset(void);
+// dt_us — время с прошлого отсчёта по часам Timebase или датчика
+void attitude_update(const int16_t accel[3], const int16_t gyro[3],
+                     uint16_t dt_us);
+
+int16_t attitude_roll(void);
+int16_t attitude_pitch(void);
+
+// Сменный оценщик ориентации: фильтр выше или кватернионный Mahony
+// (mahony.c). Прошивка держит указатель и не знает, который из них.
+typedef struct {
+  const char *name;
+  void (*reset)(void);
+  void (*update)(const int16_t accel[3], const int16_t gyro[3],
+                 uint16_t dt_us);
+  int16_t (*roll)(void);
+  int16_t (*pitch)(void);
+
+  // Необязательные (могут быть NULL)
+  // Курс относительно старта; без магнитометра медленно дрейфует
+  int16_t (*yaw)(void);
+} Estimator;
+
+// Комплементарный фильтр выше: крен с гироскопом, тангаж по акселерометру
+extern const Estimator COMPLEMENTARY_ESTIMATOR;
+
+// Mahony: кватернион по всем трём осям гироскопа, акселерометр тянет
+// крен и тангаж через ПИ-регулятор. Тангаж тоже сглажен гироскопом.
+//
+// Коррекция по акселерометру (нормировка, векторное произведение)
+// дороже интегрирования, поэтому её можно делать раз в
+// ATTITUDE_ACCEL_DECIM отсчётов — обратная связь держится до следующей.
+// Кватернион нормируется одним шагом Ньютона от 1: |q| всегда рядом
+// с единицей, корень не нужен.
+#ifndef ATTITUDE_MAHONY_KP
+#define ATTITUDE_MAHONY_KP 2.0f // 1/с: постоянная времени ~0.5 с
+#endif
+#ifndef ATTITUDE_MAHONY_KI
+#define ATTITUDE_MAHONY_KI 0.05f
+#endif
+#ifndef ATTITUDE_ACCEL_DECIM
+#define ATTITUDE_ACCEL_DECIM 1
+#endif
+extern const Estimator MAHONY_ESTIMATOR;
+
+#endif // ATTITUDE_H
@@ -0,0 +1,161 @@
+#include "attitude.h"
+
+#include "../FastMath/fastmath.h"
+
+#include <stdbool.h>
+
+// --- Mahony: кватернион + ПИ-коррекция по акселерометру ---
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846f
+#endif
+
+// Отсчёт гироскопа (131 LSB на °/с) → рад/с
+#define GYRO_TO_RAD_S (M_PI / (180.0f * 131.0f))
+
+// |a|² в отсчётах (1g = 16384): за пределами ±15% акселерометр меряет
+// не только тяжесть, коррекцию пропускаем
+#define ACCEL_G2 (16384.0f * 16384.0f)
+#define ACCEL_MAG2_LO (0.85f * 0.85f * ACCEL_G2)
+#define ACCEL_MAG2_HI (1.15f * 1.15f * ACCEL_G2)
+
+static float q0 = 1.0f, q1 = 0.0f, q2 = 0.0f, q3 = 0.0f;
+// Интегральная часть и текущая обратная связь, рад/с
+static float ix, iy, iz;
+static float fx, fy, fz;
+static uint8_t decim_count;
+// Сумма акселерометра за окно прореживания: коррекция идёт по среднему,
+// а не по одному шумному отсчёту
+static int32_t acc_sum[3];
+// Первый отсчёт задаёт кватернион сразу по акселерометру
+static bool aligned;
+
+static void mahony_reset(void) {
+  q0 = 1.0f;
+  q1 = q2 = q3 = 0.0f;
+  ix = iy = iz = 0.0f;
+  fx = fy = fz = 0.0f;
+  decim_count = 0;
+  acc_sum[0] = acc_sum[1] = acc_sum[2] = 0;
+  aligned = false;
+}
+
+// Крен и тангаж по акселерометру, курс 0
+static void align_to_accel(float ax, float ay, float az) {
+  float roll = FM_ATAN2(ay, az);
+  float pitch = FM_ATAN2(-ax, FM_SQRT(ay * ay + az * az));
+  float cr = FM_COS(roll * 0.5f), sr = FM_SIN(roll * 0.5f);
+  float cp = FM_COS(pitch * 0.5f), sp = FM_SIN(pitch * 0.5f);
+  q0 = cr * cp;
+  q1 = sr * cp;
+  q2 = cr * sp;
+  q3 = -sr * sp;
+}
+
+static void mahony_update(const int16_t accel[3], const int16_t gyro[3],
+                          uint16_t dt_us) {
+  if (!aligned) {
+    align_to_accel(accel[0], accel[1], accel[2]);
+    aligned = true;
+    return;
+  }
+
+  const float dt = dt_us * 1e-6f;
+  float gx = gyro[0] * GYRO_TO_RAD_S;
+  float gy = gyro[1] * GYRO_TO_RAD_S;
+  float gz = gyro[2] * GYRO_TO_RAD_S;
+
+  acc_sum[0] += accel[0];
+  acc_sum[1] += accel[1];
+  acc_sum[2] += accel[2];
+  if (++decim_count >= ATTITUDE_ACCEL_DECIM) {
+    const float k = 1.0f / ATTITUDE_ACCEL_DECIM;
+    float ax = acc_sum[0] * k, ay = acc_sum[1] * k, az = acc_sum[2] * k;
+    acc_sum[0] = acc_sum[1] = acc_sum[2] = 0;
+    decim_count = 0;
+
+    float mag2 = ax * ax + ay * ay + az * az;
+    if (mag2 > ACCEL_MAG2_LO && mag2 < ACCEL_MAG2_HI) {
+      float r = FM_RSQRT(mag2);
+      ax *= r;
+      ay *= r;
+      az *= r;
+
+      // Направление тяжести по кватерниону
+      float vx = 2.0f * (q1 * q3 - q0 * q2);
+      float vy = 2.0f * (q0 * q1 + q2 * q3);
+      float vz = q0 * q0 - q1 * q1 - q2 * q2 + q3 * q3;
+
+      // Ошибка — векторное произведение измеренной и оценённой тяжести
+      float ex = ay * vz - az * vy;
+      float ey = az * vx - ax * vz;
+      float ez = ax * vy - ay * vx;
+
+      // Обратная связь действует до следующей коррекции
+      const float step = dt * ATTITUDE_ACCEL_DECIM;
+      ix += ATTITUDE_MAHONY_KI * ex * step;
+      iy += ATTITUDE_MAHONY_KI * ey * step;
+      iz += ATTITUDE_MAHONY_KI * ez * step;
+      fx = ATTITUDE_MAHONY_KP * ex + ix;
+      fy = ATTITUDE_MAHONY_KP * ey + iy;
+      fz = ATTITUDE_MAHONY_KP * ez + iz;
+    } else {
+      fx = ix;
+      fy = iy;
+      fz = iz;
+    }
+  }
+  gx += fx;
+  gy += fy;
+  gz += fz;
+
+  // q += 0.5 * q ⊗ (0, g) * dt
+  float h = 0.5f * dt;
+  gx *= h;
+  gy *= h;
+  gz *= h;
+  float a0 = q0, a1 = q1, a2 = q2;
+  q0 += -a1 * gx - a2 * gy - q3 * gz;
+  q1 += a0 * gx + a2 * gz - q3 * gy;
+  q2 += a0 * gy - a1 * gz + q3 * gx;
+  q3 += a0 * gz + a1 * gy - a2 * gx;
+
+  // |q|² ≈ 1: 1/sqrt(n) ≈ 1.5 - 0.5 n, ошибка второго порядка
+  float n = q0 * q0 + q1 * q1 + q2 * q2 + q3 * q3;
+  float r = 1.5f - 0.5f * n;
+  q0 *= r;
+  q1 *= r;
+  q2 *= r;
+  q3 *= r;
+}
+
+static int16_t to_bam(float rad) {
+  return (int16_t)(int32_t)FM_ROUND(rad * (32768.0f / M_PI));
+}
+
+static int16_t mahony_roll(void) {
+  return to_bam(FM_ATAN2(2.0f * (q0 * q1 + q2 * q3),
+                         q0 * q0 - q1 * q1 - q2 * q2 + q3 * q3));
+}
+
+// Через atan2, а не asin: не нужен asin и не чувствительно к |q|
+static int16_t mahony_pitch(void) {
+  float s = 2.0f * (q0 * q2 - q1 * q3);
+  float y = 2.0f * (q0 * q1 + q2 * q3);
+  float x = q0 * q0 - q1 * q1 - q2 * q2 + q3 * q3;
+  return to_bam(FM_ATAN2(s, FM_SQRT(y * y + x * x)));
+}
+
+static int16_t mahony_yaw(void) {
+  return to_bam(FM_ATAN2(2.0f * (q0 * q3 + q1 * q2),
+                         q0 * q0 + q1 * q1 - q2 * q2 - q3 * q3));
+}
+
+const Estimator MAHONY_ESTIMATOR = {
+    .name = "mahony",
+    .reset = mahony_reset,
+    .update = mahony_update,
+    .roll = mahony_roll,
+    .pitch = mahony_pitch,
+    .yaw = mahony_yaw,
+};
@@ -0,0 +1,75 @@
+#include "boot.h"
+#include "../Print/print.h"
+#include "../Timebase/timebase.h"
+#include "../UART/uart.h"
+
+static uint32_t boot_start_us;
+static uint32_t boot_total_us;
+
+void boot_start(BootTask *tasks, uint8_t count) {
+  boot_start_us = timebase_micros();
+  boot_total_us = 0;
+  for (uint8_t i = 0; i < count; i++) {
+    tasks[i].next_us = boot_start_us;
+    tasks[i].done_us = 0;
+  }
+}
+
+bool boot_poll(BootTask *tasks, uint8_t count) {
+  if (boot_total_us)
+    return true;
+
+  uint8_t left = 0;
+  uint32_t now = timebase_micros();
+  for (uint8_t i = 0; i < count; i++) {
+    BootTask *t = &tasks[i];
+    if (t->done_us)
+      continue;
+    left++;
+    if ((int32_t)(now - t->next_us) < 0)
+      continue;
+
+    uint16_t ms = t->step();
+    now = timebase_micros();
+    if (ms == BOOT_DONE) {
+      // 0 занят под «ещё нет»: мгновенное устройство — 1 мкс
+      uint32_t at = now - boot_start_us;
+      t->done_us = at ? at : 1;
+      left--;
+    } else {
+      // От момента после шага: шаг мог занять время (I2C, SPI)
+      t->next_us = now + ms * 1000UL;
+    }
+  }
+  if (left)
+    return false;
+
+  uint32_t total = timebase_micros() - boot_start_us;
+  boot_total_us = total ? total : 1;
+  return true;
+}
+
+void boot_run(BootTask *tasks, uint8_t count) {
+  boot_start(tasks, count);
+  while (!boot_poll(tasks, count))
+    ;
+}
+
+uint32_t boot_elapsed_us(void) { return timebase_micros() - boot_start_us; }
+
+// «boot <имя> <мс>.<десятые>»
+void boot_report_line(const char *name, uint32_t us) {
+  print_str(uart_putc, "boot ");
+  print_str(uart_putc, name);
+  print_str(uart_putc, " ");
+  print_u32(uart_putc, us / 1000);
+  print_str(uart_putc, ".");
+  print_u32(uart_putc, us / 100 % 10);
+  print_str(uart_putc, " ms\r\n");
+}
+
+void boot_report(const BootTask *tasks, uint8_t count) {
+  for (uint8_t i = 0; i < count; i++)
+    boot_report_line(tasks[i].name, tasks[i].done_us);
+  boot_report_line("total", boot_total_us);
+}
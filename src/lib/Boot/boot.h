@@ -0,0 +1,45 @@
+#ifndef BOOT_H
+#define BOOT_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Параллельная инициализация устройств на часах Timebase.
+//
+// Каждое устройство — шаг-функция: делает очередную порцию работы без
+// ожидания и возвращает паузу до следующего шага в мс (0 — сразу же)
+// или BOOT_DONE. boot_run крутит все шаги вперемешку, пока не закончат
+// все, так что старт длится столько, сколько самое медленное устройство,
+// а не сумму их пауз.
+//
+// boot_start и boot_poll — то же без ожидания: boot_poll делает
+// наступившие шаги и сразу возвращается, так что основной цикл может
+// между шагами работать с уже готовыми устройствами.
+//
+// Нужны timebase_init и разрешённые прерывания: паузы меряет Timebase.
+
+#define BOOT_DONE 0xFFFF
+
+typedef struct {
+  const char *name;
+  uint16_t (*step)(void);
+
+  // Заполняет boot_run
+  uint32_t next_us; // срок следующего шага
+  uint32_t done_us; // готово, мкс от начала boot_run; 0 — ещё нет
+} BootTask;
+
+void boot_run(BootTask *tasks, uint8_t count);
+void boot_start(BootTask *tasks, uint8_t count);
+// true, когда закончили все
+bool boot_poll(BootTask *tasks, uint8_t count);
+// Мкс от boot_start
+uint32_t boot_elapsed_us(void);
+
+// Хронология старта текстом в UART: строка на устройство и итог.
+// Передатчик UART должен быть включён.
+void boot_report(const BootTask *tasks, uint8_t count);
+// Ещё одна строка того же вида, например момент первых углов
+void boot_report_line(const char *name, uint32_t us);
+
+#endif // BOOT_H
@@ -1,4 +1,5 @@
 #include "Button.h"
+#include "../Timebase/timebase.h"
 
 volatile bool button_pressed = false;
 
@@ -14,4 +15,20 @@ void button_init(void) {
 
 ISR(INT0_vect) {
     button_pressed = true;   // флаг для обработки в основном цикле
-}
\ No newline at end of file
+}
+
+bool button_poll(void) {
+    static bool waiting = false;
+    static uint32_t pressed_at;
+
+    if (button_pressed) {
+        button_pressed = false;
+        waiting = true;
+        pressed_at = timebase_micros();
+    }
+    if (!waiting || timebase_micros() - pressed_at < BUTTON_DEBOUNCE_US)
+        return false;
+
+    waiting = false;
+    return (PIND & (1 << PD2)) == 0;
+}
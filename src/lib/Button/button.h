@@ -5,8 +5,17 @@
 #include <stdbool.h>
 #include <avr/interrupt.h>
 
+// Время, через которое нажатие перепроверяется по уровню PD2, мкс
+#ifndef BUTTON_DEBOUNCE_US
+#define BUTTON_DEBOUNCE_US 30000UL
+#endif
+
 extern volatile bool button_pressed;
 
 void button_init(void);
+// Антидребезг без задержки: вызывать в каждом проходе цикла. true — один
+// раз на нажатие, если кнопка всё ещё нажата через BUTTON_DEBOUNCE_US.
+// Время — timebase_micros().
+bool button_poll(void);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,34 @@
+#ifndef BYTES_H
+#define BYTES_H
+
+#include <stdint.h>
+
+// Целые в буфер и из буфера побайтно, без требований к выравниванию.
+// Кадры канала (lib/Link, lib/Record, lib/Telemetry) — младшим байтом
+// первым, регистры MPU6050 — старшим. Знаковые — через приведение:
+// (int16_t)get_le16(p).
+
+static inline void put_le16(uint8_t *p, uint16_t v) {
+  p[0] = v & 0xFF;
+  p[1] = v >> 8;
+}
+
+static inline uint16_t get_le16(const uint8_t *p) {
+  return p[0] | ((uint16_t)p[1] << 8);
+}
+
+static inline void put_le32(uint8_t *p, uint32_t v) {
+  put_le16(p, v & 0xFFFF);
+  put_le16(p + 2, v >> 16);
+}
+
+static inline uint32_t get_le32(const uint8_t *p) {
+  return get_le16(p) | ((uint32_t)get_le16(p + 2) << 16);
+}
+
+static inline void put_be16(uint8_t *p, uint16_t v) {
+  p[0] = v >> 8;
+  p[1] = v & 0xFF;
+}
+
+#endif // BYTES_H
@@ -0,0 +1,144 @@
+#include "fastmath.h"
+
+#include <avr/pgmspace.h>
+
+#define PI_F 3.14159265f
+#define HALF_PI_F 1.57079633f
+#define QUARTER_PI_F 0.78539816f
+
+// --- float ---
+
+// atan(z) на 0..1: π/4·z + z·(1 - z)·(0.2447 + 0.0663·z)
+static float atan_unit_f(float z) {
+  return z * (QUARTER_PI_F + (1.0f - z) * (0.2447f + 0.0663f * z));
+}
+
+float fm_atan2f(float y, float x) {
+  float ax = (x < 0) ? -x : x;
+  float ay = (y < 0) ? -y : y;
+  if (ax == 0.0f && ay == 0.0f)
+    return 0.0f;
+
+  float a = (ay <= ax) ? atan_unit_f(ay / ax) : HALF_PI_F - atan_unit_f(ax / ay);
+  if (x < 0)
+    a = PI_F - a;
+  return (y < 0) ? -a : a;
+}
+
+float fm_rsqrtf(float x) {
+  // Начальное 1/sqrt(x) по битам порядка, затем один шаг Ньютона
+  union {
+    float f;
+    uint32_t i;
+  } u = {.f = x};
+  u.i = 0x5F375A86UL - (u.i >> 1);
+  float r = u.f;
+  return r * (1.5f - 0.5f * x * r * r);
+}
+
+float fm_sqrtf(float x) {
+  if (x <= 0.0f)
+    return 0.0f;
+  return x * fm_rsqrtf(x);
+}
+
+// Радианы → двоичный угол с округлением
+static uint16_t rad_to_bam(float x) {
+  float b = x * (32768.0f / PI_F);
+  return (uint16_t)(int32_t)(b + ((b >= 0) ? 0.5f : -0.5f));
+}
+
+float fm_sinf(float x) { return fm_sin_bam(rad_to_bam(x)) * (1.0f / 32767.0f); }
+float fm_cosf(float x) { return fm_cos_bam(rad_to_bam(x)) * (1.0f / 32767.0f); }
+
+float fm_roundf(float x) {
+  // x + 0.5 округлился бы вверх у 0.49999997, поэтому смотрим дробную часть
+  int32_t i = (int32_t)x;
+  float frac = x - (float)i;
+  if (frac >= 0.5f)
+    i++;
+  else if (frac <= -0.5f)
+    i--;
+  return (float)i;
+}
+
+// --- целые ---
+
+uint16_t fm_isqrt32(uint32_t v) {
+  uint32_t root = 0;
+  uint32_t bit = 1UL << 30;
+  while (bit > v)
+    bit >>= 2;
+  while (bit) {
+    if (v >= root + bit) {
+      v -= root + bit;
+      root = (root >> 1) + bit;
+    } else {
+      root >>= 1;
+    }
+    bit >>= 2;
+  }
+  return (uint16_t)root;
+}
+
+// atan(t) для t = 0..1 (Q15) в двоичных углах: 0..8192.
+// Минимаксный полином 9-й степени в Q15 (ошибка самого полинома ~1e-5 рад).
+static uint16_t atan_unit_bam(uint16_t t) {
+  int32_t x2 = ((int32_t)t * t) >> 15;
+  int32_t p = 683;                 //  0.0208351
+  p = -2790 + ((p * x2) >> 15);    // -0.0851330
+  p = 5903 + ((p * x2) >> 15);     //  0.1801410
+  p = -10823 + ((p * x2) >> 15);   // -0.3302995
+  p = 32764 + ((p * x2) >> 15);    //  0.9998660
+  int32_t rad_q15 = (p * t) >> 15; // 0..25736 (π/4)
+  return (uint16_t)((rad_q15 * 20861 + 32768) >> 16); // × 2^16 / (2π) / 2^15
+}
+
+int16_t fm_atan2_bam(int32_t y, int32_t x) {
+  uint32_t ax = (x < 0) ? -x : x;
+  uint32_t ay = (y < 0) ? -y : y;
+  if (ax == 0 && ay == 0)
+    return 0;
+
+  uint16_t a;
+  if (ay <= ax)
+    a = atan_unit_bam((uint16_t)((ay << 15) / ax));
+  else
+    a = 16384 - atan_unit_bam((uint16_t)((ax << 15) / ay));
+
+  if (x < 0)
+    a = 32768 - a;
+  return (y < 0) ? -(int16_t)a : (int16_t)a;
+}
+
+// sin(i · π/128), i = 0..64, Q15
+static const int16_t sin_quarter[65] PROGMEM = {
+    0, 804, 1608, 2410, 3212, 4011, 4808, 5602,
+    6393, 7179, 7962, 8739, 9512, 10278, 11039, 11793,
+    12539, 13279, 14010, 14732, 15446, 16151, 16846, 17530,
+    18204, 18868, 19519, 20159, 20787, 21403, 22005, 22594,
+    23170, 23731, 24279, 24811, 25329, 25832, 26319, 26790,
+    27245, 27683, 28105, 28510, 28898, 29268, 29621, 29956,
+    30273, 30571, 30852, 31113, 31356, 31580, 31785, 31971,
+    32137, 32285, 32412, 32521, 32609, 32678, 32728, 32757,
+    32767,
+};
+
+int16_t fm_sin_bam(uint16_t a) {
+  uint8_t quadrant = a >> 14;
+  uint16_t r = a & 0x3FFF;
+  if (quadrant & 1)
+    r = 16384 - r;
+
+  // 6 бит — точка таблицы, 8 бит — доля до следующей
+  uint8_t i = r >> 8;
+  uint8_t frac = r & 0xFF;
+  int16_t s = pgm_read_word(&sin_quarter[i]);
+  if (frac) {
+    int16_t next = pgm_read_word(&sin_quarter[i + 1]);
+    s += ((int32_t)(next - s) * frac) >> 8;
+  }
+  return (quadrant & 2) ? -s : s;
+}
+
+int16_t fm_cos_bam(uint16_t a) { return fm_sin_bam(a + 16384); }
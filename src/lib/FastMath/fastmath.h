@@ -0,0 +1,54 @@
+#ifndef FASTMATH_H
+#define FASTMATH_H
+
+#include <stdint.h>
+
+// Быстрые приближения вместо avr-libm. Погрешности измерены на хосте
+// перебором по всему диапазону (float — IEEE single, как у avr-gcc).
+//
+//   fm_atan2f    ≤ 0.00151 рад (0.087°)    деление + полином 3-й степени
+//   fm_sqrtf     ≤ 0.18% относительной     обратный корень + шаг Ньютона
+//   fm_rsqrtf    ≤ 0.18% относительной     то же, 1/sqrt(x) при x > 0
+//   fm_sinf/cosf ≤ 1.3e-4                  таблица четверти периода, 65 точек
+//   fm_roundf    точно при |x| < 2^31      половины — от нуля, как roundf
+//
+// Целочисленные варианты работают с двоичными углами (65536 = оборот):
+//
+//   fm_atan2_bam ≤ 2 единицы (0.01°)       |x|, |y| < 2^16
+//   fm_isqrt32   точно: floor(sqrt(v))
+//   fm_sin_bam   ≤ 4 единицы Q15 (1.1e-4)
+//
+// Выбор для рендера и фильтра — макросы FM_* ниже: с USE_FASTMATH они
+// ведут сюда, без него — в libm.
+
+float fm_atan2f(float y, float x);
+float fm_sqrtf(float x);
+float fm_rsqrtf(float x);
+float fm_sinf(float x);
+float fm_cosf(float x);
+float fm_roundf(float x);
+
+int16_t fm_atan2_bam(int32_t y, int32_t x);
+uint16_t fm_isqrt32(uint32_t v);
+// Синус и косинус двоичного угла в Q15 (±32767)
+int16_t fm_sin_bam(uint16_t a);
+int16_t fm_cos_bam(uint16_t a);
+
+#ifdef USE_FASTMATH
+#define FM_ATAN2(y, x) fm_atan2f((y), (x))
+#define FM_SQRT(x) fm_sqrtf(x)
+#define FM_RSQRT(x) fm_rsqrtf(x)
+#define FM_SIN(x) fm_sinf(x)
+#define FM_COS(x) fm_cosf(x)
+#define FM_ROUND(x) fm_roundf(x)
+#else
+#include <math.h>
+#define FM_ATAN2(y, x) atan2f((y), (x))
+#define FM_SQRT(x) sqrtf(x)
+#define FM_RSQRT(x) (1.0f / sqrtf(x))
+#define FM_SIN(x) sinf(x)
+#define FM_COS(x) cosf(x)
+#define FM_ROUND(x) roundf(x)
+#endif
+
+#endif // FASTMATH_H
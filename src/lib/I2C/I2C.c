@@ -1,10 +1,16 @@
 #include "I2C.h"
+#include "i2c_async.h"
 #include <avr/io.h>
+#include <stdbool.h>
 #include <util/twi.h>
 
 // Тайм-аут для ожидания TWINT (подберите под вашу частоту)
 #define I2C_TIMEOUT 30000
 
+// Шина за побайтовым доступом: от первого i2c_start до i2c_stop
+static bool held = false;
+static I2CStatus held_result;
+
 void i2c_init(void) {
   TWSR = 0; // Предделитель = 1
   TWBR = ((F_CPU / TWI_FREQ) - 16) / 2;
@@ -13,20 +19,32 @@ void i2c_init(void) {
 static uint8_t i2c_wait_for_completion(void) {
   uint16_t timeout = I2C_TIMEOUT;
   while (!(TWCR & (1 << TWINT))) {
-    if (--timeout == 0)
+    if (--timeout == 0) {
+      held_result = I2C_ERR_TIMEOUT;
       return 1; // Тайм-аут
+    }
   }
   return 0;
 }
 
 uint8_t i2c_start(uint8_t address) {
+  // Повторный START — шина уже наша
+  if (!held) {
+    if (!i2c_async_claim())
+      return 1;
+    held = true;
+    held_result = I2C_OK;
+  }
+
   TWCR = (1 << TWINT) | (1 << TWSTA) | (1 << TWEN);
   if (i2c_wait_for_completion())
     return 1;
 
   uint8_t status = TWSR & 0xF8;
-  if (status != TW_START && status != TW_REP_START)
+  if (status != TW_START && status != TW_REP_START) {
+    held_result = I2C_ERR_BUS;
     return 1;
+  }
 
   TWDR = address;
   TWCR = (1 << TWINT) | (1 << TWEN);
@@ -36,8 +54,8 @@ uint8_t i2c_start(uint8_t address) {
   status = TWSR & 0xF8;
   if (status == TW_MT_SLA_ACK || status == TW_MR_SLA_ACK)
     return 0;
-  else
-    return 1;
+  held_result = (address & 0x01) ? I2C_ERR_SLA_R : I2C_ERR_SLA_W;
+  return 1;
 }
 
 void i2c_stop(void) {
@@ -47,6 +65,10 @@ void i2c_stop(void) {
   while ((TWCR & (1 << TWSTO)) && --timeout) {
     // Ждём завершения STOP
   }
+  if (held) {
+    held = false;
+    i2c_async_release(held_result);
+  }
 }
 
 uint8_t i2c_write(uint8_t data) {
@@ -55,7 +77,10 @@ uint8_t i2c_write(uint8_t data) {
   if (i2c_wait_for_completion())
     return 1;
 
-  return ((TWSR & 0xF8) == TW_MT_DATA_ACK) ? 0 : 1;
+  if ((TWSR & 0xF8) == TW_MT_DATA_ACK)
+    return 0;
+  held_result = I2C_ERR_DATA;
+  return 1;
 }
 
 uint8_t i2c_read_ack(void) {
@@ -70,4 +95,14 @@ uint8_t i2c_read_nack(void) {
   if (i2c_wait_for_completion())
     return 0;
   return TWDR;
-}
\ No newline at end of file
+}
+
+uint8_t i2c_write_reg(uint8_t address, uint8_t reg, uint8_t value) {
+  const uint8_t tx[2] = {reg, value};
+  return i2c_transfer(address, tx, 2, 0, 0);
+}
+
+uint8_t i2c_read_regs(uint8_t address, uint8_t reg, uint8_t *data,
+                      uint8_t len) {
+  return i2c_transfer(address, &reg, 1, data, len);
+}
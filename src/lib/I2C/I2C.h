@@ -6,10 +6,21 @@
 #define TWI_FREQ 400000UL // 400 kHz
 
 void i2c_init(void);
+
+// Побайтовый блокирующий доступ, как прежде: 0 — успех (ACK), 1 —
+// ошибка или тайм-аут. Первый i2c_start дожидается фоновой транзакции
+// и забирает шину у автомата из i2c_async.h, i2c_stop её возвращает.
 uint8_t i2c_start(uint8_t address);
 void i2c_stop(void);
 uint8_t i2c_write(uint8_t data);
 uint8_t i2c_read_ack(void);
 uint8_t i2c_read_nack(void);
 
-#endif
\ No newline at end of file
+// Доступ к регистрам одной транзакцией автомата (i2c_transfer): запуск
+// и ожидание конца. Работает и при запрещённых прерываниях. 0 — успех,
+// иначе I2CStatus.
+uint8_t i2c_write_reg(uint8_t address, uint8_t reg, uint8_t value);
+uint8_t i2c_read_regs(uint8_t address, uint8_t reg, uint8_t *data,
+                      uint8_t len);
+
+#endif
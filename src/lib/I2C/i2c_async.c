@@ -0,0 +1,173 @@
+#include "i2c_async.h"
+
+#include <avr/interrupt.h>
+#include <avr/io.h>
+#include <util/atomic.h>
+#include <util/twi.h>
+
+// Опросов на байт в i2c_async_wait
+#define I2C_ASYNC_TIMEOUT_PER_BYTE 30000UL
+
+#define TWCR_GO ((1 << TWINT) | (1 << TWEN) | (1 << TWIE))
+
+static const I2CTransaction *volatile current;
+static volatile I2CStatus status = I2C_OK;
+
+// Метка шины, занятой побайтовым доступом: автомат её не шагает
+static const I2CTransaction manual;
+
+// Состояние автомата (только в прерывании и при запуске)
+static uint8_t tx_pos, rx_pos;
+static bool reading;
+
+static void finish(I2CStatus result) {
+  // STOP без TWIE: дальше шина снова в распоряжении опроса
+  TWCR = (1 << TWINT) | (1 << TWEN) | (1 << TWSTO);
+  const I2CTransaction *t = current;
+  current = 0;
+  status = result;
+  if (t->done)
+    t->done(result);
+}
+
+// Приём следующего байта: ACK, если после него будут ещё
+static inline void read_next(const I2CTransaction *t) {
+  if (rx_pos + 1 < t->rx_len)
+    TWCR = TWCR_GO | (1 << TWEA);
+  else
+    TWCR = TWCR_GO;
+}
+
+// Один шаг автомата по событию TWINT
+static void i2c_async_step(void) {
+  const I2CTransaction *t = current;
+  if (!t) {
+    TWCR = (1 << TWINT) | (1 << TWEN); // чужое событие — гасим
+    return;
+  }
+
+  switch (TW_STATUS) {
+  case TW_START:
+  case TW_REP_START:
+    TWDR = t->address | (reading ? 0x01 : 0x00);
+    TWCR = TWCR_GO;
+    break;
+
+  case TW_MT_SLA_ACK:
+  case TW_MT_DATA_ACK:
+    if (tx_pos < t->tx_len) {
+      TWDR = t->tx[tx_pos++];
+      TWCR = TWCR_GO;
+    } else if (t->rx_len) {
+      reading = true;
+      TWCR = TWCR_GO | (1 << TWSTA); // повторный START
+    } else {
+      finish(I2C_OK);
+    }
+    break;
+
+  case TW_MR_SLA_ACK:
+    read_next(t);
+    break;
+
+  case TW_MR_DATA_ACK:
+    t->rx[rx_pos++] = TWDR;
+    read_next(t);
+    break;
+
+  case TW_MR_DATA_NACK:
+    t->rx[rx_pos++] = TWDR;
+    finish(I2C_OK);
+    break;
+
+  case TW_MT_SLA_NACK:
+    finish(I2C_ERR_SLA_W);
+    break;
+
+  case TW_MT_DATA_NACK:
+    finish(I2C_ERR_DATA);
+    break;
+
+  case TW_MR_SLA_NACK:
+    finish(I2C_ERR_SLA_R);
+    break;
+
+  default: // TW_MT_ARB_LOST, TW_BUS_ERROR
+    finish(I2C_ERR_BUS);
+    break;
+  }
+}
+
+ISR(TWI_vect) { i2c_async_step(); }
+
+bool i2c_async_start(const I2CTransaction *t) {
+  if (current)
+    return false;
+
+  // Предыдущий STOP мог ещё не уйти на шину
+  uint16_t timeout = 30000;
+  while ((TWCR & (1 << TWSTO)) && --timeout)
+    ;
+
+  tx_pos = 0;
+  rx_pos = 0;
+  // Без байтов на запись сразу читаем
+  reading = (t->tx_len == 0 && t->rx_len != 0);
+  status = I2C_BUSY;
+  current = t;
+  TWCR = TWCR_GO | (1 << TWSTA);
+  return true;
+}
+
+bool i2c_async_busy(void) { return current != 0; }
+
+I2CStatus i2c_async_status(void) { return status; }
+
+I2CStatus i2c_async_wait(void) {
+  const I2CTransaction *t = current;
+  if (!t || t == &manual)
+    return status;
+
+  uint32_t timeout =
+      I2C_ASYNC_TIMEOUT_PER_BYTE * (3 + t->tx_len + t->rx_len);
+  while (current && --timeout) {
+    // С запрещёнными прерываниями (например, до sei() в init) автомат
+    // крутим отсюда
+    if (!(SREG & (1 << SREG_I)) && (TWCR & (1 << TWINT)))
+      i2c_async_step();
+  }
+
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    if (current)
+      finish(I2C_ERR_TIMEOUT);
+  }
+  return status;
+}
+
+I2CStatus i2c_transfer(uint8_t address, const uint8_t *tx, uint8_t tx_len,
+                       uint8_t *rx, uint8_t rx_len) {
+  I2CTransaction t = {address, tx, tx_len, rx, rx_len, 0};
+  i2c_async_wait();
+  // Шину успели занять из обработчика: итог чужой транзакции не наш
+  if (!i2c_async_start(&t))
+    return I2C_BUSY;
+  return i2c_async_wait();
+}
+
+bool i2c_async_claim(void) {
+  i2c_async_wait();
+  bool claimed = false;
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    if (!current) {
+      status = I2C_BUSY;
+      current = &manual;
+      claimed = true;
+    }
+  }
+  return claimed;
+}
+
+void i2c_async_release(I2CStatus result) {
+  status = result;
+  current = 0;
+}
@@ -0,0 +1,62 @@
+#ifndef I2C_ASYNC_H
+#define I2C_ASYNC_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Транзакция I2C в фоне: обработчик TWI_vect проходит её целиком —
+// START, адрес на запись, tx_len байт (номер регистра и данные), затем
+// повторный START, адрес на чтение и rx_len байт, STOP. Основной цикл
+// в это время свободен; о завершении сообщают флаг и обратный вызов.
+//
+// В полёте одна транзакция. Из I2C.h i2c_write_reg и i2c_read_regs —
+// обёртки над i2c_transfer, а побайтовые i2c_start … i2c_stop ведут
+// шину сами, забрав её через i2c_async_claim. Оба сначала дожидаются
+// текущей транзакции, так что интерфейсы можно смешивать.
+
+typedef enum {
+  I2C_OK = 0,
+  I2C_BUSY,          // транзакция ещё идёт
+  I2C_ERR_SLA_W,     // нет ACK на адрес при записи
+  I2C_ERR_DATA,      // нет ACK на байт данных
+  I2C_ERR_SLA_R,     // нет ACK на адрес при повторном START
+  I2C_ERR_BUS,       // потеря арбитража или ошибка шины
+  I2C_ERR_TIMEOUT    // i2c_async_wait не дождалась конца
+} I2CStatus;
+
+// Вызывается из прерывания: коротко, без ожиданий
+typedef void (*I2CCallback)(I2CStatus status);
+
+typedef struct {
+  uint8_t address; // сдвинутый адрес на запись, как MPU6050_ADDR
+  const uint8_t *tx;
+  uint8_t tx_len;
+  uint8_t *rx;
+  uint8_t rx_len;
+  I2CCallback done; // может быть NULL
+} I2CTransaction;
+
+// Запускает транзакцию; false, если предыдущая ещё идёт.
+// Структура и буферы должны жить до завершения.
+bool i2c_async_start(const I2CTransaction *t);
+bool i2c_async_busy(void);
+// Итог последней транзакции (I2C_BUSY, пока идёт)
+I2CStatus i2c_async_status(void);
+// Ждёт конца транзакции с тайм-аутом по числу опросов; при тайм-ауте
+// выдаёт STOP, освобождает шину и вызывает done с I2C_ERR_TIMEOUT
+I2CStatus i2c_async_wait(void);
+
+// Блокирующая обёртка: запуск и ожидание. Работает и при запрещённых
+// прерываниях — тогда автомат крутится опросом TWINT. I2C_BUSY, если
+// транзакцию не удалось запустить.
+I2CStatus i2c_transfer(uint8_t address, const uint8_t *tx, uint8_t tx_len,
+                       uint8_t *rx, uint8_t rx_len);
+
+// Шина для побайтового доступа (I2C.h): claim дожидается текущей
+// транзакции и занимает шину — false, если её успели занять. Пока шина
+// занята, i2c_async_start отказывает. release отдаёт шину с итогом для
+// i2c_async_status; STOP выдаёт вызывающий.
+bool i2c_async_claim(void);
+void i2c_async_release(I2CStatus result);
+
+#endif // I2C_ASYNC_H
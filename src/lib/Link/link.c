@@ -0,0 +1,132 @@
+#include "link.h"
+#include "../Bytes/bytes.h"
+
+#include <avr/pgmspace.h>
+
+// CRC-8, полином 0x07 (как _crc8_ccitt_update из avr-libc). Своя, чтобы
+// кодек собирался и на хосте. По таблице: байт за один просмотр вместо
+// восьми сдвигов — пачки телеметрии по 80+ байт считаются на частоте
+// датчика.
+static const uint8_t crc8_table[256] PROGMEM = {
+    0x00, 0x07, 0x0E, 0x09, 0x1C, 0x1B, 0x12, 0x15, 0x38, 0x3F, 0x36, 0x31,
+    0x24, 0x23, 0x2A, 0x2D, 0x70, 0x77, 0x7E, 0x79, 0x6C, 0x6B, 0x62, 0x65,
+    0x48, 0x4F, 0x46, 0x41, 0x54, 0x53, 0x5A, 0x5D, 0xE0, 0xE7, 0xEE, 0xE9,
+    0xFC, 0xFB, 0xF2, 0xF5, 0xD8, 0xDF, 0xD6, 0xD1, 0xC4, 0xC3, 0xCA, 0xCD,
+    0x90, 0x97, 0x9E, 0x99, 0x8C, 0x8B, 0x82, 0x85, 0xA8, 0xAF, 0xA6, 0xA1,
+    0xB4, 0xB3, 0xBA, 0xBD, 0xC7, 0xC0, 0xC9, 0xCE, 0xDB, 0xDC, 0xD5, 0xD2,
+    0xFF, 0xF8, 0xF1, 0xF6, 0xE3, 0xE4, 0xED, 0xEA, 0xB7, 0xB0, 0xB9, 0xBE,
+    0xAB, 0xAC, 0xA5, 0xA2, 0x8F, 0x88, 0x81, 0x86, 0x93, 0x94, 0x9D, 0x9A,
+    0x27, 0x20, 0x29, 0x2E, 0x3B, 0x3C, 0x35, 0x32, 0x1F, 0x18, 0x11, 0x16,
+    0x03, 0x04, 0x0D, 0x0A, 0x57, 0x50, 0x59, 0x5E, 0x4B, 0x4C, 0x45, 0x42,
+    0x6F, 0x68, 0x61, 0x66, 0x73, 0x74, 0x7D, 0x7A, 0x89, 0x8E, 0x87, 0x80,
+    0x95, 0x92, 0x9B, 0x9C, 0xB1, 0xB6, 0xBF, 0xB8, 0xAD, 0xAA, 0xA3, 0xA4,
+    0xF9, 0xFE, 0xF7, 0xF0, 0xE5, 0xE2, 0xEB, 0xEC, 0xC1, 0xC6, 0xCF, 0xC8,
+    0xDD, 0xDA, 0xD3, 0xD4, 0x69, 0x6E, 0x67, 0x60, 0x75, 0x72, 0x7B, 0x7C,
+    0x51, 0x56, 0x5F, 0x58, 0x4D, 0x4A, 0x43, 0x44, 0x19, 0x1E, 0x17, 0x10,
+    0x05, 0x02, 0x0B, 0x0C, 0x21, 0x26, 0x2F, 0x28, 0x3D, 0x3A, 0x33, 0x34,
+    0x4E, 0x49, 0x40, 0x47, 0x52, 0x55, 0x5C, 0x5B, 0x76, 0x71, 0x78, 0x7F,
+    0x6A, 0x6D, 0x64, 0x63, 0x3E, 0x39, 0x30, 0x37, 0x22, 0x25, 0x2C, 0x2B,
+    0x06, 0x01, 0x08, 0x0F, 0x1A, 0x1D, 0x14, 0x13, 0xAE, 0xA9, 0xA0, 0xA7,
+    0xB2, 0xB5, 0xBC, 0xBB, 0x96, 0x91, 0x98, 0x9F, 0x8A, 0x8D, 0x84, 0x83,
+    0xDE, 0xD9, 0xD0, 0xD7, 0xC2, 0xC5, 0xCC, 0xCB, 0xE6, 0xE1, 0xE8, 0xEF,
+    0xFA, 0xFD, 0xF4, 0xF3,
+};
+
+uint8_t link_crc8(const uint8_t *data, uint8_t n) {
+  uint8_t crc = 0;
+  for (uint8_t i = 0; i < n; i++)
+    crc = pgm_read_byte(&crc8_table[crc ^ data[i]]);
+  return crc;
+}
+
+uint8_t link_encode(const LinkFrame *frame, uint8_t out[LINK_FRAME_MAX]) {
+  uint8_t p[LINK_PAYLOAD_LEN];
+  p[0] = (LINK_VERSION << 4) | (frame->mode & 0x0F);
+  p[1] = frame->seq;
+  put_le16(p + 2, frame->roll_cd);
+  put_le16(p + 4, frame->pitch_cd);
+  p[6] = link_crc8(p, LINK_PAYLOAD_LEN - 1);
+  return link_cobs_encode(p, LINK_PAYLOAD_LEN, out);
+}
+
+uint8_t link_cobs_encode(const uint8_t *payload, uint8_t n, uint8_t *out) {
+  // Разделитель и перед кадром: текст или обрывок, ушедший в линию до
+  // него, закончится на этом нуле и не склеится с кадром
+  out[0] = 0x00;
+  // COBS: каждый ноль заменяется расстоянием до следующего нуля
+  uint8_t code_pos = 1, len = 2;
+  for (uint8_t i = 0; i < n; i++) {
+    if (payload[i] == 0) {
+      out[code_pos] = len - code_pos;
+      code_pos = len++;
+    } else {
+      out[len++] = payload[i];
+    }
+  }
+  out[code_pos] = len - code_pos;
+  out[len++] = 0x00; // разделитель
+  return len;
+}
+
+void link_decoder_init(LinkDecoder *d) {
+  d->len = 0;
+  d->overflow = false;
+  d->have_seq = false;
+  d->frames = 0;
+  d->errors = 0;
+  d->lost = 0;
+}
+
+bool link_cobs_decode(uint8_t *buf, uint8_t len, uint8_t *out_len) {
+  uint8_t in = 0, out = 0;
+  while (in < len) {
+    uint8_t code = buf[in++];
+    if (code == 0 || in + code - 1 > len)
+      return false;
+    for (uint8_t i = 1; i < code; i++)
+      buf[out++] = buf[in++];
+    // После блока — ноль, кроме последнего и полного (0xFF) блоков
+    if (in < len && code != 0xFF)
+      buf[out++] = 0;
+  }
+  *out_len = out;
+  return true;
+}
+
+static bool frame_end(LinkDecoder *d, LinkFrame *frame) {
+  uint8_t *p = d->buf;
+  uint8_t n;
+  if (d->overflow || d->len == 0 || !link_cobs_decode(p, d->len, &n) ||
+      n != LINK_PAYLOAD_LEN || p[6] != link_crc8(p, LINK_PAYLOAD_LEN - 1) ||
+      (p[0] >> 4) != LINK_VERSION) {
+    if (d->len || d->overflow)
+      d->errors++; // одиночный разделитель — не ошибка
+    return false;
+  }
+
+  frame->mode = p[0] & 0x0F;
+  frame->seq = p[1];
+  frame->roll_cd = (int16_t)get_le16(p + 2);
+  frame->pitch_cd = (int16_t)get_le16(p + 4);
+
+  if (d->have_seq)
+    d->lost += (uint8_t)(frame->seq - d->last_seq - 1);
+  d->last_seq = frame->seq;
+  d->have_seq = true;
+  d->frames++;
+  return true;
+}
+
+bool link_decode_byte(LinkDecoder *d, uint8_t c, LinkFrame *frame) {
+  if (c == 0x00) {
+    bool ok = frame_end(d, frame);
+    d->len = 0;
+    d->overflow = false;
+    return ok;
+  }
+  if (d->len < sizeof(d->buf))
+    d->buf[d->len++] = c;
+  else
+    d->overflow = true;
+  return false;
+}
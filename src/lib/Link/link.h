@@ -0,0 +1,70 @@
+#ifndef LINK_H
+#define LINK_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Протокол канала MCU1 → MCU2, версия 2.
+//
+// Полезная нагрузка (7 байт, младший байт первым):
+//   [версия << 4 | режим] [номер] [крен, int16] [тангаж, int16] [CRC-8]
+// Углы — в сотых долях градуса (±180° влезает в int16), CRC-8 с
+// полиномом 0x07 — по всем байтам до него.
+//
+// Кадр — разделитель 0x00, COBS от нагрузки и снова 0x00: внутри кадра
+// нулей нет, поэтому приёмник после любого сбоя находит границу на
+// следующем нуле, а ложного начала кадра, как у 0xFE внутри float в
+// версии 1, не бывает. Ноль в начале отделяет кадр от всего, что ушло
+// в линию перед ним без разделителя (текст отчётов, оборванный кадр).
+// Два нуля подряд между кадрами — пустой кадр, его пропускают молча.
+// Кадр — 10 байт на линии против 11 у версии 1.
+//
+// Другие потоки MCU1 (запись отсчётов, lib/Record) обрамляются так же,
+// но с другим старшим полубайтом первого байта — MCU2 их отбрасывает.
+
+#define LINK_VERSION 2
+#define LINK_PAYLOAD_LEN 7
+// COBS добавляет байт на каждые 254, плюс два разделителя
+#define LINK_FRAME_MAX (LINK_PAYLOAD_LEN + 3)
+
+// Сотые доли градуса из радиан и обратно
+#define LINK_RAD_TO_CD (18000.0f / 3.14159265f)
+#define LINK_CD_TO_RAD (3.14159265f / 18000.0f)
+
+typedef struct {
+  uint8_t seq;      // номер кадра, растёт на 1 по кругу
+  uint8_t mode;     // 0..15; 0 — MCU2 рисует тангаж, 1 — крен
+  int16_t roll_cd;  // крен, 0.01°
+  int16_t pitch_cd; // тангаж, 0.01°
+} LinkFrame;
+
+// Приёмник: копит байты до разделителя. Счётчики — для диагностики.
+typedef struct {
+  uint8_t buf[LINK_PAYLOAD_LEN + 1]; // COBS без разделителей
+  uint8_t len;
+  bool overflow; // кадр длиннее допустимого — ждём разделитель
+  bool have_seq;
+  uint8_t last_seq;
+
+  uint16_t frames;   // принято целыми
+  uint16_t errors;   // отброшено: длина, COBS, CRC или версия
+  uint16_t lost;     // пропущено по номерам
+} LinkDecoder;
+
+// Кодирует кадр в out, возвращает его длину вместе с разделителями
+uint8_t link_encode(const LinkFrame *frame, uint8_t out[LINK_FRAME_MAX]);
+
+void link_decoder_init(LinkDecoder *d);
+// Очередной байт с линии; true, если им закончился целый кадр — он в
+// frame. Коротко и без ожиданий: годится для прерывания приёма.
+bool link_decode_byte(LinkDecoder *d, uint8_t c, LinkFrame *frame);
+
+// Обрамление для других потоков: CRC-8 (полином 0x07) и COBS.
+uint8_t link_crc8(const uint8_t *data, uint8_t n);
+// Разделитель, COBS от n < 254 байт нагрузки и разделитель: n + 3 байта
+// в out
+uint8_t link_cobs_encode(const uint8_t *payload, uint8_t n, uint8_t *out);
+// Обратный COBS на месте, без разделителя; false — испорченная цепочка кодов
+bool link_cobs_decode(uint8_t *buf, uint8_t len, uint8_t *out_len);
+
+#endif // LINK_H
@@ -1,92 +1,303 @@
 #include "../I2C/I2C.h"
+#include "../I2C/i2c_async.h"
 #include "../MPU6050/MPU6050.h"
+#include <avr/interrupt.h>
 #include <avr/io.h>
 #include <util/delay.h>
 
+// Итог транзакции I2C в терминах датчика
+static MPU6050Status mpu6050_status(uint8_t status) {
+  switch (status) {
+  case I2C_OK:
+    return MPU6050_OK;
+  case I2C_BUSY:
+    return MPU6050_BUSY;
+  case I2C_ERR_SLA_W:
+    return MPU6050_ERR_ADDR;
+  case I2C_ERR_DATA:
+    return MPU6050_ERR_REG;
+  case I2C_ERR_SLA_R:
+    return MPU6050_ERR_RESTART;
+  default:
+    return MPU6050_ERR_READ;
+  }
+}
+
+static MPU6050Status mpu6050_write_reg(uint8_t reg, uint8_t value) {
+  return mpu6050_status(i2c_write_reg(MPU6050_ADDR, reg, value));
+}
+
 void mpu6050_init(void) {
   i2c_init();
 
-  // Отправляем: START + ADDR(W) + REG + DATA + STOP
-  if (i2c_start(MPU6050_ADDR))
-    goto error;
-  if (i2c_write(MPU6050_REG_PWR_MGMT_1))
-    goto error;
-  if (i2c_write(0x00))
-    goto error; // Wake up
-  i2c_stop();
-  int16_t gx_off, gy_off, gz_off;
-  mpu6050_calibrate_gyro(&gx_off, &gy_off, &gz_off);
-  mpu6050_set_gyro_offsets(gx_off, gy_off, gz_off);
-  return;
-
-error:
-  i2c_stop(); // На всякий случай
-              // Можно добавить обработку ошибки (мигание LED и т.п.)
-}
-
-static void mpu6050_read_burst(uint8_t reg, uint8_t *buf, uint8_t len) {
-  // Запись адреса регистра БЕЗ STOP
-  if (i2c_start(MPU6050_ADDR))
-    goto error;
-  if (i2c_write(reg))
-    goto error;
-
-  // Repeated START для чтения
-  if (i2c_start(MPU6050_ADDR | 0x01))
-    goto error;
-
-  for (uint8_t i = 0; i < len - 1; i++) {
-    buf[i] = i2c_read_ack();
+  // Wake up; ошибку увидит первое же чтение.
+  // Смещения гироскопа не калибруем: их задаёт GyroBias из EEPROM
+  // и уточняет на ходу
+  mpu6050_write_reg(MPU6050_REG_PWR_MGMT_1, 0x00);
+}
+
+static int16_t gyro_offset_x = 0;
+static int16_t gyro_offset_y = 0;
+static int16_t gyro_offset_z = 0;
+
+// Запись номера регистра, повторный START и чтение len байт
+static MPU6050Status mpu6050_read_burst(uint8_t reg, uint8_t *buf,
+                                        uint8_t len) {
+  return mpu6050_status(i2c_read_regs(MPU6050_ADDR, reg, buf, len));
+}
+
+// Буфер последнего чтения всех датчиков
+static uint8_t burst_buf[MPU6050_BURST_LEN];
+static uint32_t burst_timestamp;
+
+#ifdef I2C_ASYNC
+static volatile MPU6050Status burst_status = MPU6050_ERR_READ;
+
+// Итог именно этой транзакции: общий i2c_async_status мог смениться
+// чужой транзакцией между start и poll
+static void burst_done(I2CStatus status) {
+  burst_status = mpu6050_status(status);
+}
+
+static const uint8_t burst_reg = MPU6050_REG_ACCEL_XOUT_H;
+static const I2CTransaction burst_xfer = {
+    MPU6050_ADDR, &burst_reg, 1, burst_buf, MPU6050_BURST_LEN, burst_done};
+#else
+static MPU6050Status burst_status = MPU6050_ERR_READ;
+#endif
+
+MPU6050Status mpu6050_read_all_start(void) {
+  burst_timestamp = MPU6050_TIMESTAMP();
+#ifdef I2C_ASYNC
+  burst_status = MPU6050_BUSY;
+  if (!i2c_async_start(&burst_xfer)) {
+    burst_status = MPU6050_ERR_READ; // не запущено — буфер не обновится
+    return MPU6050_BUSY;
   }
-  buf[len - 1] = i2c_read_nack();
-  i2c_stop();
-  return;
+  return MPU6050_OK;
+#else
+  burst_status = mpu6050_read_burst(MPU6050_REG_ACCEL_XOUT_H, burst_buf,
+                                    MPU6050_BURST_LEN);
+  return MPU6050_OK;
+#endif
+}
+
+MPU6050Status mpu6050_read_all_poll(MPU6050Sample *sample) {
+  MPU6050Status status = burst_status;
+  if (status != MPU6050_OK)
+    return status;
 
-error:
-  i2c_stop();
-  // При ошибке заполняем нулями (или обрабатываем иначе)
-  for (uint8_t i = 0; i < len; i++)
-    buf[i] = 0;
+  const uint8_t *buf = burst_buf;
+  sample->accel[0] = (buf[0] << 8) | buf[1];
+  sample->accel[1] = (buf[2] << 8) | buf[3];
+  sample->accel[2] = (buf[4] << 8) | buf[5];
+  sample->temp = (buf[6] << 8) | buf[7];
+  sample->gyro[0] = ((buf[8] << 8) | buf[9]) - gyro_offset_x;
+  sample->gyro[1] = ((buf[10] << 8) | buf[11]) - gyro_offset_y;
+  sample->gyro[2] = ((buf[12] << 8) | buf[13]) - gyro_offset_z;
+  sample->timestamp = burst_timestamp;
+  return MPU6050_OK;
 }
 
-void mpu6050_read_accel(float *ax, float *ay, float *az) {
+MPU6050Status mpu6050_read_all_wait(MPU6050Sample *sample) {
+#ifdef I2C_ASYNC
+  if (burst_status == MPU6050_BUSY)
+    i2c_async_wait();
+#endif
+  return mpu6050_read_all_poll(sample);
+}
+
+MPU6050Status mpu6050_read_all(MPU6050Sample *sample) {
+  i2c_async_wait(); // чужая транзакция держит шину
+  MPU6050Status status = mpu6050_read_all_start();
+  if (status != MPU6050_OK)
+    return status;
+  return mpu6050_read_all_wait(sample);
+}
+
+MPU6050Status mpu6050_configure(uint8_t smplrt_div, uint8_t dlpf_cfg) {
+  MPU6050Status status = mpu6050_write_reg(MPU6050_REG_SMPLRT_DIV, smplrt_div);
+  if (status != MPU6050_OK)
+    return status;
+  return mpu6050_write_reg(MPU6050_REG_CONFIG, dlpf_cfg & 0x07);
+}
+
+#ifdef MPU6050_FIFO
+
+// Отсчёт в FIFO: акселерометр и гироскоп, без температуры
+#define FIFO_FRAME 12
+
+#define FIFO_EN_ACCEL_GYRO 0x78 // ACCEL, XG, YG, ZG
+#define USER_CTRL_FIFO_EN 0x40
+#define USER_CTRL_FIFO_RESET 0x04
+#define INT_ENABLE_DATA_RDY 0x01
+#define INT_FIFO_OFLOW 0x10 // в INT_ENABLE и INT_STATUS
+
+#define RING_MASK (MPU6050_RING_SIZE - 1)
+
+volatile bool mpu6050_data_ready = false;
+uint16_t mpu6050_fifo_overflows = 0;
+
+static MPU6050Sample ring[MPU6050_RING_SIZE];
+static uint8_t ring_head, ring_tail;
+static uint32_t fifo_seq;
+
+ISR(INT1_vect) { mpu6050_data_ready = true; }
+
+static MPU6050Status fifo_reset(void) {
+  MPU6050Status status =
+      mpu6050_write_reg(MPU6050_REG_USER_CTRL, USER_CTRL_FIFO_RESET);
+  if (status != MPU6050_OK)
+    return status;
+  return mpu6050_write_reg(MPU6050_REG_USER_CTRL, USER_CTRL_FIFO_EN);
+}
+
+MPU6050Status mpu6050_fifo_start(void) {
+  MPU6050Status status;
+  if ((status = mpu6050_configure(MPU6050_SMPLRT_DIV, MPU6050_DLPF)) ||
+      (status = mpu6050_write_reg(MPU6050_REG_FIFO_EN, FIFO_EN_ACCEL_GYRO)) ||
+      // INT: активный высокий, push-pull, импульс 50 мкс
+      (status = mpu6050_write_reg(MPU6050_REG_INT_PIN_CFG, 0x00)) ||
+      (status = mpu6050_write_reg(MPU6050_REG_INT_ENABLE,
+                                  INT_ENABLE_DATA_RDY | INT_FIFO_OFLOW)) ||
+      (status = fifo_reset()))
+    return status;
+
+  ring_head = ring_tail = 0;
+  fifo_seq = 0;
+
+  DDRD &= ~(1 << PD3);                    // PD3 (INT1) как вход
+  EICRA |= (1 << ISC11) | (1 << ISC10);   // по нарастающему фронту
+  EIMSK |= (1 << INT1);
+  return MPU6050_OK;
+}
+
+MPU6050Status mpu6050_fifo_drain(void) {
+  mpu6050_data_ready = false;
+
+  // Переполненный FIFO теряет старые байты и сбивает границы отсчётов.
+  // Полный, но не переполненный FIFO (1020 байт) — законные 85 отсчётов:
+  // судим по флагу датчика, а не по счётчику. Чтение INT_STATUS его
+  // сбрасывает.
+  uint8_t buf[FIFO_FRAME * MPU6050_FIFO_BURST];
+  MPU6050Status status = mpu6050_read_burst(MPU6050_REG_INT_STATUS, buf, 1);
+  if (status != MPU6050_OK)
+    return status;
+  if (buf[0] & INT_FIFO_OFLOW) {
+    mpu6050_fifo_overflows++;
+    fifo_reset();
+    return MPU6050_ERR_FIFO;
+  }
+
+  status = mpu6050_read_burst(MPU6050_REG_FIFO_COUNTH, buf, 2);
+  if (status != MPU6050_OK)
+    return status;
+  uint16_t count = ((uint16_t)buf[0] << 8) | buf[1];
+
+  uint8_t frames = count / FIFO_FRAME;
+  while (frames) {
+    uint8_t space = MPU6050_RING_SIZE - (uint8_t)(ring_head - ring_tail);
+    uint8_t n = frames;
+    if (n > MPU6050_FIFO_BURST)
+      n = MPU6050_FIFO_BURST;
+    if (n > space)
+      n = space;
+    if (n == 0)
+      break; // кольцо полно — остальное в следующий раз
+
+    status = mpu6050_read_burst(MPU6050_REG_FIFO_R_W, buf, n * FIFO_FRAME);
+    if (status != MPU6050_OK)
+      return status;
+
+    for (const uint8_t *p = buf; p < buf + n * FIFO_FRAME; p += FIFO_FRAME) {
+      MPU6050Sample *sample = &ring[ring_head & RING_MASK];
+      sample->accel[0] = (p[0] << 8) | p[1];
+      sample->accel[1] = (p[2] << 8) | p[3];
+      sample->accel[2] = (p[4] << 8) | p[5];
+      sample->temp = 0; // в FIFO не пишется
+      sample->gyro[0] = ((p[6] << 8) | p[7]) - gyro_offset_x;
+      sample->gyro[1] = ((p[8] << 8) | p[9]) - gyro_offset_y;
+      sample->gyro[2] = ((p[10] << 8) | p[11]) - gyro_offset_z;
+      sample->timestamp = fifo_seq++;
+      ring_head++;
+    }
+    frames -= n;
+  }
+  return MPU6050_OK;
+}
+
+uint8_t mpu6050_fifo_available(void) {
+  return (uint8_t)(ring_head - ring_tail);
+}
+
+bool mpu6050_fifo_pop(MPU6050Sample *sample) {
+  if (ring_head == ring_tail)
+    return false;
+  *sample = ring[ring_tail & RING_MASK];
+  ring_tail++;
+  return true;
+}
+
+#endif // MPU6050_FIFO
+
+// Старые читатели: при ошибке — нули, как раньше
+static void mpu6050_read_burst_or_zero(uint8_t reg, uint8_t *buf,
+                                       uint8_t len) {
+  if (mpu6050_read_burst(reg, buf, len) != MPU6050_OK)
+    for (uint8_t i = 0; i < len; i++)
+      buf[i] = 0;
+}
+
+void mpu6050_read_accel_raw(int16_t accel[3]) {
   uint8_t buf[6];
-  mpu6050_read_burst(MPU6050_REG_ACCEL_XOUT_H, buf, 6);
+  mpu6050_read_burst_or_zero(MPU6050_REG_ACCEL_XOUT_H, buf, 6);
 
   // Данные в формате Big-Endian, знаковые 16-битные
-  int16_t x = (buf[0] << 8) | buf[1];
-  int16_t y = (buf[2] << 8) | buf[3];
-  int16_t z = (buf[4] << 8) | buf[5];
+  accel[0] = (buf[0] << 8) | buf[1];
+  accel[1] = (buf[2] << 8) | buf[3];
+  accel[2] = (buf[4] << 8) | buf[5];
+}
+
+void mpu6050_read_accel(float *ax, float *ay, float *az) {
+  int16_t raw[3];
+  mpu6050_read_accel_raw(raw);
 
   // Масштаб: по умолчанию ±2g → 16384 LSB/g
   const float accel_scale = 16384.0f;
-  *ax = (float)x / accel_scale;
-  *ay = (float)y / accel_scale;
-  *az = (float)z / accel_scale;
+  *ax = (float)raw[0] / accel_scale;
+  *ay = (float)raw[1] / accel_scale;
+  *az = (float)raw[2] / accel_scale;
 }
 
-static int16_t gyro_offset_x = 0;
-static int16_t gyro_offset_y = 0;
-static int16_t gyro_offset_z = 0;
-
 void mpu6050_set_gyro_offsets(int16_t x, int16_t y, int16_t z) {
   gyro_offset_x = x;
   gyro_offset_y = y;
   gyro_offset_z = z;
 }
 
-void mpu6050_read_gyro(float *gx, float *gy, float *gz) {
+void mpu6050_get_gyro_offsets(int16_t offsets[3]) {
+  offsets[0] = gyro_offset_x;
+  offsets[1] = gyro_offset_y;
+  offsets[2] = gyro_offset_z;
+}
+
+void mpu6050_read_gyro_raw(int16_t gyro[3]) {
   uint8_t buf[6];
-  mpu6050_read_burst(MPU6050_REG_GYRO_XOUT_H, buf, 6);
+  mpu6050_read_burst_or_zero(MPU6050_REG_GYRO_XOUT_H, buf, 6);
+
+  gyro[0] = ((buf[0] << 8) | buf[1]) - gyro_offset_x;
+  gyro[1] = ((buf[2] << 8) | buf[3]) - gyro_offset_y;
+  gyro[2] = ((buf[4] << 8) | buf[5]) - gyro_offset_z;
+}
 
-  int16_t raw_x = ((buf[0] << 8) | buf[1]) - gyro_offset_x;
-  int16_t raw_y = ((buf[2] << 8) | buf[3]) - gyro_offset_y;
-  int16_t raw_z = ((buf[4] << 8) | buf[5]) - gyro_offset_z;
+void mpu6050_read_gyro(float *gx, float *gy, float *gz) {
+  int16_t raw[3];
+  mpu6050_read_gyro_raw(raw);
 
   const float gyro_scale = 131.0f;
-  *gx = (float)raw_x / gyro_scale;
-  *gy = (float)raw_y / gyro_scale;
-  *gz = (float)raw_z / gyro_scale;
+  *gx = (float)raw[0] / gyro_scale;
+  *gy = (float)raw[1] / gyro_scale;
+  *gz = (float)raw[2] / gyro_scale;
 }
 
 void mpu6050_calibrate_gyro(int16_t *gx_offset, int16_t *gy_offset,
@@ -96,7 +307,7 @@ void mpu6050_calibrate_gyro(int16_t *gx_offset, int16_t *gy_offset,
 
   for (int i = 0; i < samples; i++) {
     uint8_t buf[6];
-    mpu6050_read_burst(MPU6050_REG_GYRO_XOUT_H, buf, 6);
+    mpu6050_read_burst_or_zero(MPU6050_REG_GYRO_XOUT_H, buf, 6);
     sum_x += (buf[0] << 8) | buf[1];
     sum_y += (buf[2] << 8) | buf[3];
     sum_z += (buf[4] << 8) | buf[5];
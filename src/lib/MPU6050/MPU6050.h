@@ -1,6 +1,7 @@
 #ifndef MPU6050_H
 #define MPU6050_H
 
+#include <stdbool.h>
 #include <stdint.h>
 
 // Адрес по умолчанию: AD0 = GND → 0x68 → сдвинутый = 0xD0
@@ -10,11 +11,111 @@
 #define MPU6050_REG_PWR_MGMT_1 0x6B
 #define MPU6050_REG_ACCEL_XOUT_H 0x3B
 #define MPU6050_REG_GYRO_XOUT_H 0x43
+#define MPU6050_REG_SMPLRT_DIV 0x19
+#define MPU6050_REG_CONFIG 0x1A
+#define MPU6050_REG_FIFO_EN 0x23
+#define MPU6050_REG_INT_PIN_CFG 0x37
+#define MPU6050_REG_INT_ENABLE 0x38
+#define MPU6050_REG_INT_STATUS 0x3A
+#define MPU6050_REG_USER_CTRL 0x6A
+#define MPU6050_REG_FIFO_COUNTH 0x72
+#define MPU6050_REG_FIFO_R_W 0x74
+
+// ACCEL_XOUT_H..GYRO_ZOUT_L идут подряд: акселерометр, температура, гироскоп
+#define MPU6050_BURST_LEN 14
+
+// Метка времени отсчёта, мкс. По умолчанию — общие часы Timebase;
+// можно переопределить флагом компилятора.
+#ifndef MPU6050_TIMESTAMP
+#include "../Timebase/timebase.h"
+#define MPU6050_TIMESTAMP() timebase_micros()
+#endif
+
+typedef enum {
+  MPU6050_OK = 0,
+  MPU6050_ERR_ADDR,    // нет ACK на адрес при записи
+  MPU6050_ERR_REG,     // нет ACK на номер регистра
+  MPU6050_ERR_RESTART, // нет ACK на адрес при повторном START
+  MPU6050_ERR_READ,    // тайм-аут при приёме байта
+  MPU6050_BUSY,        // фоновое чтение ещё идёт
+  MPU6050_ERR_FIFO     // FIFO переполнился и сброшен, отсчёты потеряны
+} MPU6050Status;
+
+// Один согласованный отсчёт: всё из одной транзакции I2C
+typedef struct {
+  int16_t accel[3];   // X, Y, Z
+  int16_t temp;       // сырое: °C = temp / 340 + 36.53
+  int16_t gyro[3];    // X, Y, Z за вычетом смещений
+  // read_all: MPU6050_TIMESTAMP() перед START, мкс;
+  // FIFO: номер отсчёта по часам датчика, шаг MPU6050_SAMPLE_PERIOD_US
+  uint32_t timestamp;
+} MPU6050Sample;
+
+// Режим FIFO: частоту отсчётов задают часы датчика, а не Timer1.
+// Акселерометр и гироскоп (12 байт на отсчёт) копятся в FIFO датчика,
+// вывод INT на каждом отсчёте дёргает INT1 (PD3), а mpu6050_fifo_drain
+// забирает накопленное пачками в кольцевой буфер.
+//
+// Частота = частота гироскопа / (1 + SMPLRT_DIV); частота гироскопа —
+// 1 кГц с DLPF (1..6) и 8 кГц без него (0, 7). По умолчанию 500 Гц.
+#ifndef MPU6050_SMPLRT_DIV
+#define MPU6050_SMPLRT_DIV 1
+#endif
+// DLPF_CFG: 3 — полоса 44 Гц (акселерометр) / 42 Гц (гироскоп)
+#ifndef MPU6050_DLPF
+#define MPU6050_DLPF 3
+#endif
+#define MPU6050_GYRO_RATE_HZ                                                   \
+  ((MPU6050_DLPF == 0 || MPU6050_DLPF == 7) ? 8000UL : 1000UL)
+#define MPU6050_SAMPLE_PERIOD_US                                               \
+  (1000000UL / MPU6050_GYRO_RATE_HZ * (1 + MPU6050_SMPLRT_DIV))
+
+// Отсчётов в кольцевом буфере, степень двойки
+#ifndef MPU6050_RING_SIZE
+#define MPU6050_RING_SIZE 8
+#endif
+// Отсчётов за одну транзакцию чтения FIFO
+#ifndef MPU6050_FIFO_BURST
+#define MPU6050_FIFO_BURST 4
+#endif
+
+// Выставляется по INT датчика, сбрасывается в mpu6050_fifo_drain
+extern volatile bool mpu6050_data_ready;
+// Сколько раз FIFO переполнялся
+extern uint16_t mpu6050_fifo_overflows;
 
 void mpu6050_init(void);
+// Акселерометр, температура и гироскоп одним чтением 14 байт.
+// При ошибке sample не меняется.
+MPU6050Status mpu6050_read_all(MPU6050Sample *sample);
+// То же по частям: start запускает чтение, poll отдаёт MPU6050_BUSY, пока
+// оно идёт, затем результат; wait ждёт конца. С I2C_ASYNC шина работает
+// в фоне, без него start читает сразу.
+MPU6050Status mpu6050_read_all_start(void);
+MPU6050Status mpu6050_read_all_poll(MPU6050Sample *sample);
+MPU6050Status mpu6050_read_all_wait(MPU6050Sample *sample);
+
+// Делитель частоты и DLPF (регистры SMPLRT_DIV и CONFIG)
+MPU6050Status mpu6050_configure(uint8_t smplrt_div, uint8_t dlpf_cfg);
+// Дальше — только со сборкой MPU6050_FIFO.
+// Настраивает частоту по MPU6050_SMPLRT_DIV/MPU6050_DLPF, сбрасывает и
+// включает FIFO, прерывание готовности данных и INT1 на PD3
+MPU6050Status mpu6050_fifo_start(void);
+// Переносит из FIFO в кольцо сколько влезет, пачками по
+// MPU6050_FIFO_BURST. При переполнении (флаг FIFO_OFLOW_INT) сбрасывает
+// FIFO и возвращает MPU6050_ERR_FIFO.
+MPU6050Status mpu6050_fifo_drain(void);
+uint8_t mpu6050_fifo_available(void);
+bool mpu6050_fifo_pop(MPU6050Sample *sample);
 void mpu6050_read_accel(float *ax, float *ay, float *az);
 void mpu6050_read_gyro(float *gx, float *gy, float *gz);
+// Сырые отсчёты без перевода во float: X, Y, Z (гироскоп — за вычетом смещений)
+void mpu6050_read_accel_raw(int16_t accel[3]);
+void mpu6050_read_gyro_raw(int16_t gyro[3]);
 void mpu6050_set_gyro_offsets(int16_t x, int16_t y, int16_t z);
+void mpu6050_get_gyro_offsets(int16_t offsets[3]);
+// Полная калибровка: 1000 отсчётов, больше 2 с неподвижности.
+// mpu6050_init её не вызывает — см. gyro_bias.h
 void mpu6050_calibrate_gyro(int16_t *gx_offset, int16_t *gy_offset,
                             int16_t *gz_offset);
 
@@ -0,0 +1,276 @@
+#include "gyro_bias.h"
+#include "../Timebase/timebase.h"
+
+#include <avr/eeprom.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <util/crc16.h>
+#include <util/delay.h>
+
+#define GYRO_BIAS_MAGIC 0x4247 // "GB"
+#define GYRO_BIAS_VERSION 1
+
+// |a|² в отсчётах (1g = 16384): неподвижен — в пределах 1g ± 5%
+#define G2 (16384.0 * 16384.0)
+#define STILL_A2_MIN ((uint32_t)(G2 * 0.95 * 0.95))
+#define STILL_A2_MAX ((uint32_t)(G2 * 1.05 * 1.05))
+// Отклонение гироскопа от первого отсчёта окна больше этого — точно
+// движение (шум ~4 LSB); заодно суммы за окно остаются в 32 битах
+#define GYRO_MAX_DEV 256
+
+#define SAVE_INTERVAL_US (GYRO_BIAS_SAVE_INTERVAL_S * 1000000UL)
+
+// Запись в EEPROM; CRC закрывает и порчу, и запись, прерванную
+// выключением питания
+typedef struct {
+  uint16_t magic;
+  uint8_t version;
+  int16_t bias[3];
+  uint8_t crc; // CRC-8 по всем полям выше
+} GyroBiasRecord;
+
+static GyroBiasRecord EEMEM stored;
+
+// Смещения с дробной частью, Q4: целые уходят в датчик
+static int32_t bias_q4[3];
+// То, что сейчас лежит в EEPROM (или уйдёт туда текущей записью)
+static int16_t saved[3];
+static bool saved_valid = false;
+
+// Накопление окна неподвижности: отклонения от первого отсчёта окна,
+// чтобы дисперсию не съело округление среднего
+typedef struct {
+  int16_t ref[3];
+  int32_t sum[3];
+  int32_t sumsq[3];
+  uint8_t count;
+  bool still;
+} Window;
+
+static Window window;
+
+// Разрешение записи: интервал отсчитывается от старта и от прошлой записи
+static uint32_t interval_start;
+static bool save_allowed = false;
+
+// Побайтовая запись записи в EEPROM
+static GyroBiasRecord pending;
+static uint8_t write_pos = sizeof(GyroBiasRecord); // = размер — простой
+
+static uint8_t record_crc(const GyroBiasRecord *r) {
+  const uint8_t *p = (const uint8_t *)r;
+  uint8_t crc = 0;
+  for (uint8_t i = 0; i < offsetof(GyroBiasRecord, crc); i++)
+    crc = _crc8_ccitt_update(crc, p[i]);
+  return crc;
+}
+
+static void window_reset(Window *w) {
+  for (uint8_t i = 0; i < 3; i++) {
+    w->sum[i] = 0;
+    w->sumsq[i] = 0;
+  }
+  w->count = 0;
+  w->still = true;
+}
+
+static void window_add(Window *w, const MPU6050Sample *s) {
+  uint32_t a2 = 0;
+  for (uint8_t i = 0; i < 3; i++)
+    a2 += (uint32_t)((int32_t)s->accel[i] * s->accel[i]);
+  if (a2 < STILL_A2_MIN || a2 > STILL_A2_MAX)
+    w->still = false;
+
+  for (uint8_t i = 0; i < 3; i++) {
+    if (w->count == 0)
+      w->ref[i] = s->gyro[i];
+    int16_t d = s->gyro[i] - w->ref[i];
+    if (d > GYRO_MAX_DEV || d < -GYRO_MAX_DEV) {
+      w->still = false;
+      d = 0;
+    }
+    w->sum[i] += d;
+    w->sumsq[i] += (int32_t)d * d;
+  }
+  w->count++;
+}
+
+// Неподвижен ли прибор за окно; mean_q4 — среднее остатка по осям, Q4
+static bool window_still(const Window *w, int32_t mean_q4[3]) {
+  if (!w->still || w->count == 0)
+    return false;
+  for (uint8_t i = 0; i < 3; i++) {
+    int32_t var = (w->sumsq[i] - w->sum[i] * w->sum[i] / w->count) / w->count;
+    if (var > GYRO_BIAS_MAX_VAR)
+      return false;
+    mean_q4[i] = (int32_t)w->ref[i] * 16 + w->sum[i] * 16 / w->count;
+  }
+  return true;
+}
+
+// |среднее| больше limit хотя бы по одной оси
+static bool mean_exceeds(const int32_t mean_q4[3], int16_t limit) {
+  for (uint8_t i = 0; i < 3; i++) {
+    if (mean_q4[i] > limit * 16L || mean_q4[i] < -limit * 16L)
+      return true;
+  }
+  return false;
+}
+
+static void apply(void) {
+  // Q4 → целые с округлением (сдвиг знаковый)
+  mpu6050_set_gyro_offsets((bias_q4[0] + 8) >> 4, (bias_q4[1] + 8) >> 4,
+                           (bias_q4[2] + 8) >> 4);
+}
+
+static bool load(int16_t bias[3]) {
+  GyroBiasRecord r;
+  eeprom_read_block(&r, &stored, sizeof(r));
+  if (r.magic != GYRO_BIAS_MAGIC || r.version != GYRO_BIAS_VERSION ||
+      r.crc != record_crc(&r))
+    return false;
+  for (uint8_t i = 0; i < 3; i++)
+    bias[i] = r.bias[i];
+  return true;
+}
+
+// Проверка при старте: этап 0 — загрузка и пауза на выход гироскопа
+// на режим, дальше по отсчёту в миллисекунду
+static uint8_t boot_stage = 0;
+static Window boot_window;
+static GyroBiasSource boot_source = GYRO_BIAS_NONE;
+
+static void save_start(const int16_t offsets[3]);
+
+static void boot_finish(void) {
+  boot_source = saved_valid ? GYRO_BIAS_STORED : GYRO_BIAS_NONE;
+  int32_t mean_q4[3];
+  if (boot_window.count == GYRO_BIAS_BOOT_SAMPLES &&
+      window_still(&boot_window, mean_q4) &&
+      (!saved_valid || mean_exceeds(mean_q4, GYRO_BIAS_BOOT_TOL))) {
+    for (uint8_t i = 0; i < 3; i++)
+      bias_q4[i] += mean_q4[i];
+    apply();
+    boot_source = GYRO_BIAS_MEASURED;
+  }
+  // Прибор двигался: записанным верим, без записи — нули, остальное
+  // сделает оценка на ходу
+
+  window_reset(&window);
+  interval_start = timebase_micros();
+  if (boot_source == GYRO_BIAS_MEASURED) {
+    // Записи не было или она устарела: измеренное пишем сразу, а не
+    // через GYRO_BIAS_SAVE_INTERVAL_S
+    int16_t offsets[3];
+    mpu6050_get_gyro_offsets(offsets);
+    save_start(offsets);
+    save_allowed = false;
+  } else {
+    // Без записи — первое же окно неподвижности уходит в EEPROM
+    save_allowed = !saved_valid;
+  }
+}
+
+uint16_t gyro_bias_boot_step(void) {
+  if (boot_stage == 0) {
+    saved_valid = load(saved);
+    for (uint8_t i = 0; i < 3; i++)
+      bias_q4[i] = saved_valid ? (int32_t)saved[i] * 16 : 0;
+    apply();
+    window_reset(&boot_window);
+    boot_stage = 1;
+    return GYRO_BIAS_SETTLE_MS;
+  }
+
+  // Короткая проверка вместо полной калибровки
+  MPU6050Sample sample;
+  if (mpu6050_read_all(&sample) == MPU6050_OK)
+    window_add(&boot_window, &sample);
+  if (boot_stage++ < GYRO_BIAS_BOOT_SAMPLES)
+    return 1;
+
+  boot_finish();
+  boot_stage = 0;
+  return GYRO_BIAS_BOOT_DONE;
+}
+
+GyroBiasSource gyro_bias_boot(void) {
+  uint16_t ms;
+  while ((ms = gyro_bias_boot_step()) != GYRO_BIAS_BOOT_DONE) {
+    while (ms--)
+      _delay_ms(1);
+  }
+  return boot_source;
+}
+
+GyroBiasSource gyro_bias_source(void) { return boot_source; }
+
+// Нужна ли запись: сдвиг от записанного хотя бы на GYRO_BIAS_SAVE_DELTA
+static bool save_needed(const int16_t offsets[3]) {
+  if (!saved_valid)
+    return true;
+  for (uint8_t i = 0; i < 3; i++) {
+    int16_t d = offsets[i] - saved[i];
+    if (d >= GYRO_BIAS_SAVE_DELTA || d <= -GYRO_BIAS_SAVE_DELTA)
+      return true;
+  }
+  return false;
+}
+
+// Один байт за вызов: EEPROM пишет байт ~3.4 мс, ждать его нельзя
+static void write_step(void) {
+  if (write_pos >= sizeof(GyroBiasRecord) || !eeprom_is_ready())
+    return;
+  eeprom_update_byte((uint8_t *)&stored + write_pos,
+                     ((const uint8_t *)&pending)[write_pos]);
+  write_pos++;
+}
+
+static void save_start(const int16_t offsets[3]) {
+  pending.magic = GYRO_BIAS_MAGIC;
+  pending.version = GYRO_BIAS_VERSION;
+  for (uint8_t i = 0; i < 3; i++) {
+    pending.bias[i] = offsets[i];
+    saved[i] = offsets[i];
+  }
+  pending.crc = record_crc(&pending);
+  saved_valid = true;
+  write_pos = 0;
+}
+
+void gyro_bias_update(const MPU6050Sample *sample) {
+  write_step();
+
+  // Интервал проверяется на каждом отсчёте — задолго до переполнения
+  // timebase_micros()
+  if (!save_allowed &&
+      timebase_micros() - interval_start >= SAVE_INTERVAL_US)
+    save_allowed = true;
+
+  window_add(&window, sample);
+  if (window.count < GYRO_BIAS_WINDOW)
+    return;
+
+  // Медленный поворот тоже даёт малый разброс — его отсекает среднее
+  int32_t mean_q4[3];
+  if (window_still(&window, mean_q4) &&
+      !mean_exceeds(mean_q4, GYRO_BIAS_MAX_MEAN)) {
+    // Смещение = текущее + среднее остатка; сглаживаем с весом 1/4
+    int16_t offsets[3];
+    mpu6050_get_gyro_offsets(offsets);
+    for (uint8_t i = 0; i < 3; i++) {
+      int32_t target = (int32_t)offsets[i] * 16 + mean_q4[i];
+      bias_q4[i] += (target - bias_q4[i]) / 4;
+    }
+    apply();
+
+    mpu6050_get_gyro_offsets(offsets);
+    if (save_allowed && write_pos >= sizeof(GyroBiasRecord) &&
+        save_needed(offsets)) {
+      save_start(offsets);
+      save_allowed = false;
+      interval_start = timebase_micros();
+    }
+  }
+  window_reset(&window);
+}
@@ -0,0 +1,75 @@
+#ifndef GYRO_BIAS_H
+#define GYRO_BIAS_H
+
+#include "MPU6050.h"
+
+#include <stdint.h>
+
+// Смещения гироскопа без двухсекундной калибровки при включении.
+//
+// Смещения хранятся в EEPROM (сигнатура, версия, CRC-8). При старте
+// gyro_bias_boot берёт их оттуда и за несколько десятков миллисекунд
+// проверяет: если прибор неподвижен, а остаток заметно отличается от
+// нуля, записанные смещения устарели и заменяются измеренными.
+//
+// Дальше gyro_bias_update на каждом отсчёте уточняет смещения, пока
+// прибор неподвижен: |a| близко к 1g, разброс гироскопа за окно мал и
+// среднее остатка невелико (медленный поворот — не смещение).
+// Уточнённые смещения пишутся обратно в EEPROM не чаще раза в
+// GYRO_BIAS_SAVE_INTERVAL_S и только при сдвиге от записанных хотя бы
+// на GYRO_BIAS_SAVE_DELTA — ресурс EEPROM ~100 000 записей. Смещения,
+// измеренные при старте, и первые, когда записи ещё нет, пишутся сразу.
+// Запись идёт по байту за вызов и не ждёт готовности EEPROM.
+
+// Пауза после пробуждения датчика: гироскоп выходит на режим ~30 мс
+#ifndef GYRO_BIAS_SETTLE_MS
+#define GYRO_BIAS_SETTLE_MS 30
+#endif
+// Отсчётов проверки при старте, по одному в миллисекунду
+#ifndef GYRO_BIAS_BOOT_SAMPLES
+#define GYRO_BIAS_BOOT_SAMPLES 16
+#endif
+// Допустимый остаток при старте, LSB (131 LSB = 1 °/с)
+#ifndef GYRO_BIAS_BOOT_TOL
+#define GYRO_BIAS_BOOT_TOL 16
+#endif
+
+// Окно оценки неподвижности на ходу, отсчётов (степень двойки)
+#ifndef GYRO_BIAS_WINDOW
+#define GYRO_BIAS_WINDOW 64
+#endif
+// Наибольшая дисперсия гироскопа за окно, LSB² (шум датчика ~4 LSB)
+#ifndef GYRO_BIAS_MAX_VAR
+#define GYRO_BIAS_MAX_VAR 100
+#endif
+// Наибольшее среднее остатка за окно, LSB: больше — это поворот
+#ifndef GYRO_BIAS_MAX_MEAN
+#define GYRO_BIAS_MAX_MEAN 64
+#endif
+
+// Запись в EEPROM: не чаще, с, и при сдвиге не меньше, LSB
+#ifndef GYRO_BIAS_SAVE_INTERVAL_S
+#define GYRO_BIAS_SAVE_INTERVAL_S 600
+#endif
+#ifndef GYRO_BIAS_SAVE_DELTA
+#define GYRO_BIAS_SAVE_DELTA 2
+#endif
+
+// Откуда взялись смещения при старте
+typedef enum {
+  GYRO_BIAS_NONE = 0, // записи нет, прибор двигался — нули до уточнения
+  GYRO_BIAS_STORED,   // из EEPROM, проверка прошла или была невозможна
+  GYRO_BIAS_MEASURED  // измерены при старте (записи нет или устарела)
+} GyroBiasSource;
+
+// После mpu6050_init, до mpu6050_fifo_start. Ставит смещения датчику.
+GyroBiasSource gyro_bias_boot(void);
+// То же по шагам, без ожидания: пауза до следующего шага в мс или
+// GYRO_BIAS_BOOT_DONE. Итог — gyro_bias_source().
+#define GYRO_BIAS_BOOT_DONE 0xFFFF
+uint16_t gyro_bias_boot_step(void);
+GyroBiasSource gyro_bias_source(void);
+// На каждом отсчёте после вычета смещений (sample->gyro — остаток)
+void gyro_bias_update(const MPU6050Sample *sample);
+
+#endif // GYRO_BIAS_H
@@ -0,0 +1,31 @@
+#include "mailbox.h"
+
+#include <string.h>
+
+// Копирование данных не должно переезжать через обращения к seq
+#define BARRIER() __asm__ __volatile__("" ::: "memory")
+
+void mailbox_write(Mailbox *m, const void *src) {
+  uint8_t seq = m->seq;
+  if (m->read_seq != seq)
+    m->overwritten++; // прошлое значение так и не прочитали
+  m->seq = seq + 1;
+  BARRIER();
+  memcpy(m->data, src, m->size);
+  BARRIER();
+  m->seq = seq + 2;
+}
+
+bool mailbox_read(Mailbox *m, void *dst) {
+  uint8_t seq;
+  do {
+    seq = m->seq;
+    if (seq == m->read_seq)
+      return false;
+    BARRIER();
+    memcpy(dst, m->data, m->size);
+    BARRIER();
+  } while ((seq & 1) || seq != m->seq);
+  m->read_seq = seq;
+  return true;
+}
@@ -0,0 +1,36 @@
+#ifndef MAILBOX_H
+#define MAILBOX_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Почтовый ящик «последнее значение» для одного писателя и одного
+// читателя, без запрета прерываний (seqlock).
+//
+// Писатель увеличивает счётчик до и после копирования: нечётный — запись
+// идёт. Читатель копирует значение и повторяет, если счётчик за это время
+// сменился. Писатель — прерывание или основной цикл, читатель — только
+// основной цикл: прерывание-читатель ждало бы писателя, которого само
+// прервало.
+//
+// Новое значение затирает непрочитанное; такие случаи считает overwritten —
+// по нему видно, что читатель (рендер) не успевает за писателем (каналом).
+// Счётчик восьмибитный, чтобы читаться атомарно: ровно 128 записей без
+// чтения читатель примет за «нового нет».
+
+typedef struct {
+  void *data;
+  uint8_t size;
+  volatile uint8_t seq;      // пишет только писатель
+  volatile uint8_t read_seq; // пишет только читатель
+  volatile uint16_t overwritten;
+} Mailbox;
+
+// Ящик поверх переменной: static Mailbox box = MAILBOX(value);
+#define MAILBOX(var) {.data = &(var), .size = sizeof(var)}
+
+void mailbox_write(Mailbox *m, const void *src);
+// Копирует значение в dst; false, если нового с прошлого чтения нет
+bool mailbox_read(Mailbox *m, void *dst);
+
+#endif // MAILBOX_H
@@ -0,0 +1,25 @@
+#include "print.h"
+
+#include <avr/pgmspace.h>
+
+void print_str(void (*put)(uint8_t c), const char *s) {
+  while (*s)
+    put(*s++);
+}
+
+void print_str_P(void (*put)(uint8_t c), const char *s) {
+  char c;
+  while ((c = pgm_read_byte(s++)))
+    put(c);
+}
+
+void print_u32(void (*put)(uint8_t c), uint32_t v) {
+  char buf[10];
+  uint8_t i = sizeof(buf);
+  do {
+    buf[--i] = '0' + v % 10;
+    v /= 10;
+  } while (v);
+  while (i < sizeof(buf))
+    put(buf[i++]);
+}
@@ -0,0 +1,16 @@
+#ifndef PRINT_H
+#define PRINT_H
+
+#include <stdint.h>
+
+// Текстовый вывод без printf: посимвольно через put — uart_putc,
+// кольцо передачи или stdout на хосте. Отчёты старта, профилировщика
+// и бенчмарков.
+
+void print_str(void (*put)(uint8_t c), const char *s);
+// Строка из PROGMEM (PSTR)
+void print_str_P(void (*put)(uint8_t c), const char *s);
+// Десятичное без знака
+void print_u32(void (*put)(uint8_t c), uint32_t v);
+
+#endif // PRINT_H
@@ -0,0 +1,42 @@
+#include "record.h"
+#include "../Bytes/bytes.h"
+#include "../Link/link.h"
+
+void record_pack(const MPU6050Sample *sample, uint8_t out[RECORD_SAMPLE_LEN]) {
+  put_le32(out, sample->timestamp);
+  for (uint8_t i = 0; i < 3; i++) {
+    put_le16(out + 4 + 2 * i, sample->accel[i]);
+    put_le16(out + 12 + 2 * i, sample->gyro[i]);
+  }
+  put_le16(out + 10, sample->temp);
+}
+
+void record_unpack(const uint8_t in[RECORD_SAMPLE_LEN], MPU6050Sample *sample) {
+  sample->timestamp = get_le32(in);
+  for (uint8_t i = 0; i < 3; i++) {
+    sample->accel[i] = (int16_t)get_le16(in + 4 + 2 * i);
+    sample->gyro[i] = (int16_t)get_le16(in + 12 + 2 * i);
+  }
+  sample->temp = (int16_t)get_le16(in + 10);
+}
+
+uint8_t record_encode(const MPU6050Sample *sample, uint8_t seq, uint8_t flags,
+                      uint8_t out[RECORD_FRAME_MAX]) {
+  uint8_t p[RECORD_PAYLOAD_LEN];
+  p[0] = (RECORD_TAG << 4) | (flags & 0x0F);
+  p[1] = seq;
+  record_pack(sample, p + 2);
+  p[RECORD_PAYLOAD_LEN - 1] = link_crc8(p, RECORD_PAYLOAD_LEN - 1);
+  return link_cobs_encode(p, RECORD_PAYLOAD_LEN, out);
+}
+
+bool record_parse(const uint8_t *payload, uint8_t n, MPU6050Sample *sample,
+                  uint8_t *seq, uint8_t *flags) {
+  if (n != RECORD_PAYLOAD_LEN || (payload[0] >> 4) != RECORD_TAG ||
+      payload[n - 1] != link_crc8(payload, n - 1))
+    return false;
+  *flags = payload[0] & 0x0F;
+  *seq = payload[1];
+  record_unpack(payload + 2, sample);
+  return true;
+}
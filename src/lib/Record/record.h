@@ -0,0 +1,48 @@
+#ifndef RECORD_H
+#define RECORD_H
+
+#include "../MPU6050/MPU6050.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Запись отсчётов MPU6050 для воспроизведения фильтра на хосте
+// (tools/imu_replay.c).
+//
+// Отсчёт — ровно то, что MCU1 подаёт в оценщик: гироскоп уже без
+// смещений, метка времени в мкс (в режиме FIFO — по часам датчика).
+// 18 байт, младший байт первым:
+//   [метка времени, uint32] [accel X, Y, Z] [temp] [gyro X, Y, Z]
+//
+// Поток по UART — кадр на отсчёт, обрамление как у канала (lib/Link):
+//   [RECORD_TAG << 4 | флаги] [номер] [отсчёт, 18 байт] [CRC-8]
+// COBS и разделители — 24 байта на линии. Номер растёт на каждый отсчёт,
+// и на пропущенный тоже: по разрывам видно, сколько не влезло в линию.
+//
+// Файл записи (.imu) — заголовок и отсчёты подряд:
+//   ["IMUR"] [версия] [флаги] [период, мкс, uint16] [8 байт нулей]
+// Период — шаг первого отсчёта, как у фильтра на MCU1.
+
+#define RECORD_TAG 0xA // старший полубайт; у кадров ориентации — LINK_VERSION
+#define RECORD_SAMPLE_LEN 18
+#define RECORD_PAYLOAD_LEN (2 + RECORD_SAMPLE_LEN + 1)
+#define RECORD_FRAME_MAX (RECORD_PAYLOAD_LEN + 3)
+
+// Флаги кадра и файла
+#define RECORD_FIFO 0x01 // отсчёты из FIFO датчика, шаг — период датчика
+
+#define RECORD_FILE_MAGIC "IMUR"
+#define RECORD_FILE_VERSION 1
+#define RECORD_FILE_HEADER_LEN 16
+
+void record_pack(const MPU6050Sample *sample, uint8_t out[RECORD_SAMPLE_LEN]);
+void record_unpack(const uint8_t in[RECORD_SAMPLE_LEN], MPU6050Sample *sample);
+
+// Кадр потока в out, возвращает его длину вместе с разделителем
+uint8_t record_encode(const MPU6050Sample *sample, uint8_t seq, uint8_t flags,
+                      uint8_t out[RECORD_FRAME_MAX]);
+// Нагрузка после link_cobs_decode; false — чужой или испорченный кадр
+bool record_parse(const uint8_t *payload, uint8_t n, MPU6050Sample *sample,
+                  uint8_t *seq, uint8_t *flags);
+
+#endif // RECORD_H
@@ -0,0 +1,193 @@
+#include "spi_queue.h"
+
+#include <avr/interrupt.h>
+#include <util/atomic.h>
+
+#define DC_HIGH() (SPIQ_PORT |= (1 << SPIQ_DC_PIN))
+#define DC_LOW() (SPIQ_PORT &= ~(1 << SPIQ_DC_PIN))
+#ifdef SPIQ_CS_PIN
+#define CS_HIGH() (SPIQ_PORT |= (1 << SPIQ_CS_PIN))
+#define CS_LOW() (SPIQ_PORT &= ~(1 << SPIQ_CS_PIN))
+#else
+#define CS_HIGH() ((void)0)
+#define CS_LOW() ((void)0)
+#endif
+
+// Заголовок операции: 2 старших бита — тип, 6 младших — длина
+#define OP_CMD 0x00  // [hdr|n] [cmd] [n аргументов]
+#define OP_DATA 0x40 // [hdr|n] [n байт]
+#define OP_FILL 0x80 // [hdr] [hi] [lo] [count lo] [count hi]
+#define OP_LEN_MASK 0x3F
+
+// Кусок, которым режутся длинные блоки данных
+#define DATA_CHUNK 32
+
+#define QUEUE_MASK (SPIQ_SIZE - 1)
+
+static uint8_t queue[SPIQ_SIZE];
+static volatile uint8_t queue_head; // пишет только основной цикл
+static volatile uint8_t queue_tail; // читает только прерывание
+static volatile bool busy = false;
+
+// Состояние передатчика (только в прерывании)
+enum { TX_NEXT_OP, TX_BYTES, TX_FILL };
+static uint8_t tx_state = TX_NEXT_OP;
+static uint8_t tx_left;
+static uint16_t fill_left;
+static uint8_t fill_hi, fill_lo;
+static bool fill_low_next;
+
+void spiq_init(void) {
+  DDRB |= (1 << PB3) | (1 << PB5); // MOSI, SCK
+  SPCR = SPIQ_SPCR;
+  SPSR = SPIQ_SPSR;
+}
+
+static inline uint8_t queue_pop(void) {
+  uint8_t tail = queue_tail;
+  uint8_t b = queue[tail];
+  queue_tail = (tail + 1) & QUEUE_MASK;
+  return b;
+}
+
+// Отправляет следующий байт. Вызывается из прерывания или при запуске
+// передачи с запрещёнными прерываниями.
+static void spiq_pump(void) {
+  if (tx_state == TX_BYTES) {
+    if (tx_left) {
+      tx_left--;
+      DC_HIGH();
+      SPDR = queue_pop();
+      return;
+    }
+  } else if (tx_state == TX_FILL) {
+    if (fill_low_next) {
+      fill_low_next = false;
+      SPDR = fill_lo;
+      return;
+    }
+    if (fill_left) {
+      fill_left--;
+      fill_low_next = true;
+      SPDR = fill_hi;
+      return;
+    }
+  }
+
+  if (queue_tail == queue_head) {
+    tx_state = TX_NEXT_OP;
+    CS_HIGH();
+    busy = false;
+    return;
+  }
+
+  uint8_t hdr = queue_pop();
+  switch (hdr & ~OP_LEN_MASK) {
+  case OP_CMD:
+    DC_LOW();
+    tx_state = TX_BYTES;
+    tx_left = hdr & OP_LEN_MASK;
+    SPDR = queue_pop();
+    break;
+  case OP_DATA:
+    DC_HIGH();
+    tx_state = TX_BYTES;
+    tx_left = (hdr & OP_LEN_MASK) - 1;
+    SPDR = queue_pop();
+    break;
+  default: // OP_FILL
+    DC_HIGH();
+    fill_hi = queue_pop();
+    fill_lo = queue_pop();
+    fill_left = queue_pop();
+    fill_left |= (uint16_t)queue_pop() << 8;
+    fill_left--;
+    fill_low_next = true;
+    tx_state = TX_FILL;
+    SPDR = fill_hi;
+    break;
+  }
+}
+
+ISR(SPI_STC_vect) { spiq_pump(); }
+
+// Ждёт n свободных байт и возвращает позицию записи
+static uint8_t queue_reserve(uint8_t n) {
+  while ((uint8_t)(QUEUE_MASK - ((queue_head - queue_tail) & QUEUE_MASK)) < n)
+    ;
+  return queue_head;
+}
+
+static inline uint8_t queue_put(uint8_t pos, uint8_t b) {
+  queue[pos] = b;
+  return (pos + 1) & QUEUE_MASK;
+}
+
+// Публикует операцию целиком и при необходимости запускает передачу
+static void queue_commit(uint8_t head) {
+  queue_head = head;
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    if (!busy) {
+      busy = true;
+      CS_LOW();
+      spiq_pump();
+    }
+  }
+}
+
+void spiq_command(uint8_t cmd, const uint8_t *args, uint8_t n) {
+  uint8_t pos = queue_reserve(2 + n);
+  pos = queue_put(pos, OP_CMD | n);
+  pos = queue_put(pos, cmd);
+  for (uint8_t i = 0; i < n; i++)
+    pos = queue_put(pos, args[i]);
+  queue_commit(pos);
+}
+
+void spiq_data(const uint8_t *data, uint16_t n) {
+  while (n) {
+    uint8_t chunk = (n > DATA_CHUNK) ? DATA_CHUNK : n;
+    uint8_t pos = queue_reserve(1 + chunk);
+    pos = queue_put(pos, OP_DATA | chunk);
+    for (uint8_t i = 0; i < chunk; i++)
+      pos = queue_put(pos, *data++);
+    queue_commit(pos);
+    n -= chunk;
+  }
+}
+
+void spiq_pixels(const uint16_t *pixels, uint16_t count) {
+  while (count) {
+    uint8_t chunk = (count > DATA_CHUNK / 2) ? DATA_CHUNK / 2 : count;
+    uint8_t pos = queue_reserve(1 + 2 * chunk);
+    pos = queue_put(pos, OP_DATA | (2 * chunk));
+    for (uint8_t i = 0; i < chunk; i++) {
+      pos = queue_put(pos, *pixels >> 8);
+      pos = queue_put(pos, *pixels & 0xFF);
+      pixels++;
+    }
+    queue_commit(pos);
+    count -= chunk;
+  }
+}
+
+void spiq_fill(uint16_t color, uint32_t count) {
+  while (count) {
+    uint16_t chunk = (count > 0xFFFF) ? 0xFFFF : count;
+    uint8_t pos = queue_reserve(5);
+    pos = queue_put(pos, OP_FILL);
+    pos = queue_put(pos, color >> 8);
+    pos = queue_put(pos, color & 0xFF);
+    pos = queue_put(pos, chunk & 0xFF);
+    pos = queue_put(pos, chunk >> 8);
+    queue_commit(pos);
+    count -= chunk;
+  }
+}
+
+void spiq_flush(void) {
+  while (busy)
+    ;
+}
+
+bool spiq_busy(void) { return busy; }
@@ -0,0 +1,65 @@
+#ifndef SPI_QUEUE_H
+#define SPI_QUEUE_H
+
+#include <avr/io.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+// Асинхронная передача на дисплей: драйвер кладёт в кольцевой буфер
+// компактные операции (команда с аргументами, блок данных, заливка цветом),
+// а обработчик SPI_STC_vect отправляет их побайтно в фоне.
+//
+// Заливка хранится как {цвет, количество}, а не развёрнутыми байтами,
+// поэтому fill_rect на весь экран занимает в очереди 5 байт.
+//
+// Прерывание на каждый байт дороже передачи байта на F_CPU/2, поэтому
+// в асинхронном режиме SPI по умолчанию работает на F_CPU/8: так основной
+// цикл получает заметную долю процессора между байтами. Делитель задаётся
+// SPIQ_SPCR/SPIQ_SPSR.
+
+// Размер очереди, степень двойки
+#ifndef SPIQ_SIZE
+#define SPIQ_SIZE 64
+#endif
+
+// Пины — те же, что у драйверов дисплея
+#ifndef SPIQ_PORT
+#define SPIQ_PORT PORTB
+#endif
+#ifndef SPIQ_DC_PIN
+#define SPIQ_DC_PIN PB0
+#endif
+// Для панелей без CS определи SPIQ_NO_CS
+#if !defined(SPIQ_CS_PIN) && !defined(SPIQ_NO_CS)
+#define SPIQ_CS_PIN PB2
+#endif
+
+// SPI Master, режим 0, прерывание по завершению байта, F_CPU/8
+#ifndef SPIQ_SPCR
+#define SPIQ_SPCR ((1 << SPIE) | (1 << SPE) | (1 << MSTR) | (1 << SPR0))
+#endif
+#ifndef SPIQ_SPSR
+#define SPIQ_SPSR (1 << SPI2X)
+#endif
+
+// Делитель SCK из SPR1:SPR0 (4, 16, 64, 128) и SPI2X (вдвое меньше)
+#define SPIQ_SPR (((SPIQ_SPCR) >> SPR0) & 3)
+#define SPIQ_SCK_DIV                                                           \
+  ((SPIQ_SPR == 3 ? 128 : 4 << (2 * SPIQ_SPR)) >> (((SPIQ_SPSR) >> SPI2X) & 1))
+
+void spiq_init(void);
+
+// Команда (DC=0) и её аргументы (DC=1); n <= SPIQ_SIZE - 3
+void spiq_command(uint8_t cmd, const uint8_t *args, uint8_t n);
+// Сырые байты данных (DC=1), любая длина — режется на куски
+void spiq_data(const uint8_t *data, uint16_t n);
+// Пиксели RGB565, старший байт первым
+void spiq_pixels(const uint16_t *pixels, uint16_t count);
+// count пикселей одного цвета
+void spiq_fill(uint16_t color, uint32_t count);
+
+// Барьер: ждёт, пока очередь опустеет и последний байт уйдёт в панель
+void spiq_flush(void);
+bool spiq_busy(void);
+
+#endif // SPI_QUEUE_H
@@ -1,13 +1,55 @@
 #include "ST7735S.h"
 #include "Font.h"
 
+#include <avr/pgmspace.h>
+
+#ifndef MIN
+#define MIN(a, b) ((a) < (b) ? (a) : (b))
+#endif
+#ifndef MAX
+#define MAX(a, b) ((a) > (b) ? (a) : (b))
+#endif
+
+// Счётчики шины (ST7735S_PROFILE): кадр CS и байты по видам
+#ifdef ST7735S_PROFILE
+static St7735sTraffic _traffic;
+#define _TRAFFIC(cmd, args, pixels)                                           \
+  (_traffic.cs_frames++, _traffic.cmd_bytes += (cmd),                         \
+   _traffic.arg_bytes += (args), _traffic.pixel_bytes += (pixels))
+
+const St7735sTraffic *st7735s_traffic(void) { return &_traffic; }
+#else
+#define _TRAFFIC(cmd, args, pixels) ((void)0)
+#endif
+
+#ifdef DISPLAY_ASYNC
+// Асинхронный режим: всё уходит через очередь SPI, отправляет прерывание
+static void _spi_init(void) { spiq_init(); }
+
+void _st7735s_write_command(uint8_t cmd) {
+  _TRAFFIC(1, 0, 0);
+  spiq_command(cmd, NULL, 0);
+}
+void _st7735s_write_data(uint8_t data) {
+  _TRAFFIC(0, 1, 0);
+  spiq_data(&data, 1);
+}
+void _st7735s_write_data_16(uint16_t data) {
+  _TRAFFIC(0, 0, 2);
+  spiq_pixels(&data, 1);
+}
+void _st7735s_write_command_args(uint8_t cmd, const uint8_t *args,
+                                 uint8_t n) {
+  _TRAFFIC(1, n, 0);
+  spiq_command(cmd, args, n);
+}
+#else
 static void _spi_init(void) {
   // Настройка пинов SPI: MOSI (PB3), SCK (PB5) как выходы
   DDRB |= (1 << PB3) | (1 << PB5);
 
-  // Включение SPI: Master, режим 0, частота F_CPU/4
-  SPCR = (1 << SPE) | (1 << MSTR);
-  SPSR = (1 << SPI2X); // Удвоение скорости (F_CPU/2)
+  SPCR = ST7735S_SPCR;
+  SPSR = ST7735S_SPSR;
 }
 static void _spi_write(uint8_t data) {
   SPDR = data;
@@ -16,139 +58,239 @@ static void _spi_write(uint8_t data) {
 }
 
 void _st7735s_write_command(uint8_t cmd) {
+  _TRAFFIC(1, 0, 0);
   DC_LOW();
   CS_LOW();
   _spi_write(cmd);
   CS_HIGH();
 }
 void _st7735s_write_data(uint8_t data) {
+  _TRAFFIC(0, 1, 0);
   DC_HIGH();
   CS_LOW();
   _spi_write(data);
   CS_HIGH();
 }
 void _st7735s_write_data_16(uint16_t data) {
+  _TRAFFIC(0, 0, 2);
   DC_HIGH();
   CS_LOW();
   _spi_write(data >> 8);   // Старший байт
   _spi_write(data & 0xFF); // Младший байт
   CS_HIGH();
 }
-void _st7735s_set_address_window(uint16_t x0, uint16_t y0, uint16_t x1,
-                                uint16_t y1) {
-  // Установка столбцов (CASET)
-  _st7735s_write_command(0x2A);
-  _st7735s_write_data(x0 >> 8);
-  _st7735s_write_data(x0 & 0xFF);
-  _st7735s_write_data(x1 >> 8);
-  _st7735s_write_data(x1 & 0xFF);
-
-  // Установка строк (RASET)
-  _st7735s_write_command(0x2B);
-  _st7735s_write_data(y0 >> 8);
-  _st7735s_write_data(y0 & 0xFF);
-  _st7735s_write_data(y1 >> 8);
-  _st7735s_write_data(y1 & 0xFF);
-
-  // Команда записи в память (RAMWR)
-  _st7735s_write_command(0x2C);
+// Команда и её аргументы одним кадром CS (DC переключается между байтами)
+void _st7735s_write_command_args(uint8_t cmd, const uint8_t *args,
+                                 uint8_t n) {
+  _TRAFFIC(1, n, 0);
+  CS_LOW();
+  DC_LOW();
+  _spi_write(cmd);
+  DC_HIGH();
+  for (uint8_t i = 0; i < n; i++)
+    _spi_write(args[i]);
+  CS_HIGH();
+}
+#endif
+
+// Кэш последнего окна: CASET/RASET не повторяем, если границы не менялись
+typedef struct {
+  uint16_t x0, x1, y0, y1;
+} _St7735sWindow;
+
+#define _WINDOW_INVALID {0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF}
+#define _WINDOW_COLS 0x01
+#define _WINDOW_ROWS 0x02
+
+static _St7735sWindow _window = _WINDOW_INVALID;
+
+// Обновляет кэш и возвращает, какие из CASET/RASET нужно отправить
+static uint8_t _st7735s_window_diff(_St7735sWindow *w, uint16_t x0,
+                                    uint16_t y0, uint16_t x1, uint16_t y1) {
+  uint8_t diff = 0;
+  if (x0 != w->x0 || x1 != w->x1) {
+    w->x0 = x0;
+    w->x1 = x1;
+    diff |= _WINDOW_COLS;
+  }
+  if (y0 != w->y0 || y1 != w->y1) {
+    w->y0 = y0;
+    w->y1 = y1;
+    diff |= _WINDOW_ROWS;
+  }
+  return diff;
 }
 
-void st7735s_init(void) {
-  // Настройка пинов управления
-  ST7735S_DDR |= (1 << DC_PIN) | (1 << RESET_PIN);
-  #ifdef ST7735S_USE_CS
-      ST7735S_DDR |= (1 << CS_PIN);
-  #endif
-
-  // Инициализация SPI
-  _spi_init();
-
-  // Процедура сброса дисплея
-  RESET_HIGH();
-  _delay_ms(10);
-  RESET_LOW();
-  _delay_ms(10);
-  RESET_HIGH();
-  _delay_ms(150);
-
-  // Последовательность инициализации ST7735S
-  _st7735s_write_command(0x01); // SWRESET: программный сброс
-  _delay_ms(150);
-
-  _st7735s_write_command(0x11); // SLPOUT: выход из спящего режима
-  _delay_ms(255);
+static uint8_t _st7735s_window_bytes(uint8_t diff) {
+  return 1 + ((diff & _WINDOW_COLS) ? 5 : 0) + ((diff & _WINDOW_ROWS) ? 5 : 0);
+}
 
-  _st7735s_write_command(0x3A); // COLMOD: установка формата цвета
-  _st7735s_write_data(0x05);    // 16 бит на пиксель (RGB565)
+// Возвращает число отправленных байт
+static uint8_t _st7735s_set_address_window(uint16_t x0, uint16_t y0,
+                                           uint16_t x1, uint16_t y1) {
+  uint8_t diff = _st7735s_window_diff(&_window, x0, y0, x1, y1);
+#ifdef ST7735S_PROFILE
+  _traffic.windows++;
+#endif
+
+  if (diff & _WINDOW_COLS) {
+    const uint8_t caset[4] = {x0 >> 8, x0 & 0xFF, x1 >> 8, x1 & 0xFF};
+    _st7735s_write_command_args(0x2A, caset, 4);
+  }
+  if (diff & _WINDOW_ROWS) {
+    const uint8_t raset[4] = {y0 >> 8, y0 & 0xFF, y1 >> 8, y1 & 0xFF};
+    _st7735s_write_command_args(0x2B, raset, 4);
+  }
 
-  // ВАЖНО: Установка горизонтальной ориентации
-  _st7735s_write_command(0x36);          // MADCTL: управление ориентацией
-  _st7735s_write_data(MADCTL_LANDSCAPE); // Горизонтальная ориентация
+  // RAMWR всегда: он же возвращает указатель записи в начало окна
+  _st7735s_write_command(0x2C);
+  return _st7735s_window_bytes(diff);
+}
 
-  // Дополнительные настройки для лучшего отображения
-  _st7735s_write_command(0xB2); // PORCTRL: настройка porch
-  _st7735s_write_data(0x0C);
-  _st7735s_write_data(0x0C);
-  _st7735s_write_data(0x00);
-  _st7735s_write_data(0x33);
-  _st7735s_write_data(0x33);
+void st7735s_set_window(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1) {
+  _st7735s_set_address_window(x0, y0, x1, y1);
+}
 
-  _st7735s_write_command(0xB7); // GCTRL: настройка gate control
-  _st7735s_write_data(0x35);
+void st7735s_write_color(uint16_t color, uint32_t count) {
+  _TRAFFIC(0, 0, 2 * count);
+#ifdef DISPLAY_ASYNC
+  spiq_fill(color, count);
+#else
+  uint8_t hi = color >> 8;
+  uint8_t lo = color & 0xFF;
 
-  _st7735s_write_command(0xBB); // VCOMS: настройка VCOM
-  _st7735s_write_data(0x2B);
+  DC_HIGH();
+  CS_LOW();
+  while (count--) {
+    _spi_write(hi);
+    _spi_write(lo);
+  }
+  CS_HIGH();
+#endif
+}
 
-  _st7735s_write_command(0xC0); // LCMCTRL: настройка LCM
-  _st7735s_write_data(0x2C);
+void st7735s_write_pixels(const uint16_t *pixels, uint16_t count) {
+  _TRAFFIC(0, 0, 2 * (uint32_t)count);
+#ifdef DISPLAY_ASYNC
+  spiq_pixels(pixels, count);
+#else
+  DC_HIGH();
+  CS_LOW();
+  for (uint16_t i = 0; i < count; i++) {
+    _spi_write(pixels[i] >> 8);
+    _spi_write(pixels[i] & 0xFF);
+  }
+  CS_HIGH();
+#endif
+}
 
-  _st7735s_write_command(0xC2); // VDVVRHEN: настройка VDV и VRH
-  _st7735s_write_data(0x01);
-  _st7735s_write_data(0xFF);
+void st7735s_flush(void) {
+#ifdef DISPLAY_ASYNC
+  spiq_flush();
+#endif
+}
 
-  _st7735s_write_command(0xC3); // VRHS: настройка VRH
-  _st7735s_write_data(0x11);
+// Последовательность инициализации ST7735S: код команды, число
+// аргументов (с _INIT_DELAY — после команды пауза), аргументы, пауза в мс
+#define _INIT_DELAY 0x80
+#define _INIT_MAX_ARGS 5
+
+static const uint8_t _st7735s_init_cmds[] PROGMEM = {
+    0x01, _INIT_DELAY, 150,                  // SWRESET: программный сброс
+    0x11, _INIT_DELAY, 255,                  // SLPOUT: выход из спящего режима
+    0x3A, 1, 0x05,                           // COLMOD: RGB565
+    0x36, 1, ST7735S_MADCTL,                 // MADCTL: ориентация
+    0xB2, 5, 0x0C, 0x0C, 0x00, 0x33, 0x33,   // PORCTRL: настройка porch
+    0xB7, 1, 0x35,                           // GCTRL: gate control
+    0xBB, 1, 0x2B,                           // VCOMS: настройка VCOM
+    0xC0, 1, 0x2C,                           // LCMCTRL: настройка LCM
+    0xC2, 2, 0x01, 0xFF,                     // VDVVRHEN: VDV и VRH
+    0xC3, 1, 0x11,                           // VRHS: настройка VRH
+    0xC4, 1, 0x20,                           // VDVS: настройка VDV
+    0xC6, 1, 0x0F,                           // FRCTRL2: частота
+    0xD0, 2, 0xA4, 0xA1,                     // PWCTRL1: питание
+    0x13, _INIT_DELAY, 10,                   // NORON: нормальный режим
+    0x29, _INIT_DELAY, 100,                  // DISPON: включение дисплея
+};
+
+// Этапы: 0..2 — аппаратный сброс, дальше — таблица команд
+static uint8_t _init_stage = 0;
+static uint8_t _init_pos;
+
+uint16_t st7735s_init_step(void) {
+  switch (_init_stage) {
+  case 0:
+    // Настройка пинов управления
+    ST7735S_DDR |= (1 << DC_PIN) | (1 << RESET_PIN);
+#ifdef ST7735S_USE_CS
+    ST7735S_DDR |= (1 << CS_PIN);
+#endif
+    _spi_init();
+
+    // Процедура сброса дисплея
+    RESET_HIGH();
+    _init_stage = 1;
+    return 10;
+  case 1:
+    RESET_LOW();
+    _init_stage = 2;
+    return 10;
+  case 2: {
+    RESET_HIGH();
+    // После сброса окно контроллера — весь экран, кэш недействителен
+    const _St7735sWindow invalid = _WINDOW_INVALID;
+    _window = invalid;
+    _init_pos = 0;
+    _init_stage = 3;
+    return 150;
+  }
+  }
 
-  _st7735s_write_command(0xC4); // VDVS: настройка VDV
-  _st7735s_write_data(0x20);
+  // Команды до ближайшей паузы
+  while (_init_pos < sizeof(_st7735s_init_cmds)) {
+    uint8_t cmd = pgm_read_byte(&_st7735s_init_cmds[_init_pos++]);
+    uint8_t n = pgm_read_byte(&_st7735s_init_cmds[_init_pos++]);
+    uint8_t args[_INIT_MAX_ARGS];
+    for (uint8_t i = 0; i < (n & ~_INIT_DELAY); i++)
+      args[i] = pgm_read_byte(&_st7735s_init_cmds[_init_pos++]);
+    _st7735s_write_command_args(cmd, args, n & ~_INIT_DELAY);
+
+    if (n & _INIT_DELAY) {
+      st7735s_flush(); // пауза отсчитывается от ухода команды в панель
+      return pgm_read_byte(&_st7735s_init_cmds[_init_pos++]);
+    }
+  }
 
-  _st7735s_write_command(0xC6); // FRCTRL2: настройка частоты
-  _st7735s_write_data(0x0F);
+  _init_stage = 0; // можно запустить заново
+  return ST7735S_INIT_DONE;
+}
 
-  _st7735s_write_command(0xD0); // PWCTRL1: настройка питания
-  _st7735s_write_data(0xA4);
-  _st7735s_write_data(0xA1);
+void st7735s_init(void) {
+  uint16_t ms;
+  while ((ms = st7735s_init_step()) != ST7735S_INIT_DONE) {
+    while (ms--)
+      _delay_ms(1);
+  }
+}
 
-  // Включение нормального режима и дисплея
-  _st7735s_write_command(0x13); // NORON: нормальный режим
-  _delay_ms(10);
+void st7735s_scroll_define(uint16_t tfa, uint16_t vsa, uint16_t bfa) {
+  const uint8_t args[] = {tfa >> 8, tfa & 0xFF, vsa >> 8,
+                          vsa & 0xFF, bfa >> 8, bfa & 0xFF};
+  _st7735s_write_command_args(0x33, args, 6); // VSCRDEF
+}
 
-  _st7735s_write_command(0x29); // DISPON: включение дисплея
-  _delay_ms(100);
+void st7735s_scroll_start(uint16_t line) {
+  const uint8_t args[] = {line >> 8, line & 0xFF};
+  _st7735s_write_command_args(0x37, args, 2); // VSCRSADD
 }
 
 void st7735s_fill_screen(uint16_t color) {
-  // Установка окна на весь экран
   _st7735s_set_address_window(0, 0, DISPLAY_WIDTH - 1, DISPLAY_HEIGHT - 1);
-
-  // Быстрая заливка через непрерывную передачу
-  DC_HIGH();
-  CS_LOW();
-
-  uint32_t total_pixels = (uint32_t)DISPLAY_WIDTH * DISPLAY_HEIGHT;
-
-  // Оптимизированная заливка экрана
-  for (uint32_t i = 0; i < total_pixels; i++) {
-    _spi_write(color >> 8);   // Старший байт цвета
-    _spi_write(color & 0xFF); // Младший байт цвета
-  }
-
-  CS_HIGH();
+  st7735s_write_color(color, (uint32_t)DISPLAY_WIDTH * DISPLAY_HEIGHT);
 }
 
 void st7735s_draw_hline(uint16_t x, uint16_t y, uint16_t length,
-                       uint16_t color) {
+                        uint16_t color) {
   // Проверка границ
   if (y >= DISPLAY_HEIGHT)
     return;
@@ -160,20 +302,11 @@ void st7735s_draw_hline(uint16_t x, uint16_t y, uint16_t length,
     x_end = DISPLAY_WIDTH - 1;
 
   _st7735s_set_address_window(x, y, x_end, y);
-
-  DC_HIGH();
-  CS_LOW();
-
-  for (uint16_t i = x; i <= x_end; i++) {
-    _spi_write(color >> 8);
-    _spi_write(color & 0xFF);
-  }
-
-  CS_HIGH();
+  st7735s_write_color(color, x_end - x + 1);
 }
 
 void st7735s_draw_vline(uint16_t x, uint16_t y, uint16_t length,
-                       uint16_t color) {
+                        uint16_t color) {
   // Проверка границ
   if (x >= DISPLAY_WIDTH)
     return;
@@ -185,64 +318,140 @@ void st7735s_draw_vline(uint16_t x, uint16_t y, uint16_t length,
     y_end = DISPLAY_HEIGHT - 1;
 
   _st7735s_set_address_window(x, y, x, y_end);
+  st7735s_write_color(color, y_end - y + 1);
+}
 
-  DC_HIGH();
-  CS_LOW();
+// Коды Коэна–Сазерленда для отсечения отрезка по границам экрана
+static uint8_t _st7735s_outcode(int16_t x, int16_t y) {
+  uint8_t code = 0;
+  if (x < 0)
+    code |= 1;
+  else if (x >= DISPLAY_WIDTH)
+    code |= 2;
+  if (y < 0)
+    code |= 4;
+  else if (y >= DISPLAY_HEIGHT)
+    code |= 8;
+  return code;
+}
 
-  for (uint16_t i = y; i <= y_end; i++) {
-    _spi_write(color >> 8);
-    _spi_write(color & 0xFF);
-  }
+// Отсекает отрезок по экрану. false — отрезок целиком за пределами.
+static bool _st7735s_clip_line(int16_t *x0, int16_t *y0, int16_t *x1,
+                               int16_t *y1) {
+  uint8_t c0 = _st7735s_outcode(*x0, *y0);
+  uint8_t c1 = _st7735s_outcode(*x1, *y1);
 
-  CS_HIGH();
-}
+  while (1) {
+    if (!(c0 | c1))
+      return true;
+    if (c0 & c1)
+      return false;
+
+    uint8_t c = c0 ? c0 : c1;
+    int32_t dx = (int32_t)*x1 - *x0;
+    int32_t dy = (int32_t)*y1 - *y0;
+    int32_t x, y;
+
+    if (c & 8) {
+      y = DISPLAY_HEIGHT - 1;
+      x = *x0 + dx * (y - *y0) / dy;
+    } else if (c & 4) {
+      y = 0;
+      x = *x0 + dx * (y - *y0) / dy;
+    } else if (c & 2) {
+      x = DISPLAY_WIDTH - 1;
+      y = *y0 + dy * (x - *x0) / dx;
+    } else {
+      x = 0;
+      y = *y0 + dy * (x - *x0) / dx;
+    }
 
-void st7735s_draw_line(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1,
-                      uint16_t color) {
-  // Оптимизация для горизонтальных и вертикальных линий
-  if (y0 == y1) {
-    if (x0 < x1)
-      st7735s_draw_hline(x0, y0, x1 - x0 + 1, color);
-    else
-      st7735s_draw_hline(x1, y0, x0 - x1 + 1, color);
-    return;
+    if (c == c0) {
+      *x0 = x;
+      *y0 = y;
+      c0 = _st7735s_outcode(*x0, *y0);
+    } else {
+      *x1 = x;
+      *y1 = y;
+      c1 = _st7735s_outcode(*x1, *y1);
+    }
   }
+}
 
-  if (x0 == x1) {
-    if (y0 < y1)
-      st7735s_draw_vline(x0, y0, y1 - y0 + 1, color);
-    else
-      st7735s_draw_vline(x0, y1, y0 - y1 + 1, color);
-    return;
+// Одна серия пикселей (горизонтальная или вертикальная) через одно окно.
+// Возвращает стоимость серии в байтах SPI; без draw только считает её
+// по теневой копии кэша окна.
+static uint16_t _st7735s_span(_St7735sWindow *shadow, int16_t xa, int16_t ya,
+                              int16_t xb, int16_t yb, uint16_t color,
+                              bool draw) {
+  uint16_t x0 = MIN(xa, xb), x1 = MAX(xa, xb);
+  uint16_t y0 = MIN(ya, yb), y1 = MAX(ya, yb);
+  uint16_t len = (x1 - x0 + 1) * (y1 - y0 + 1);
+  uint16_t bytes;
+
+  if (draw) {
+    bytes = _st7735s_set_address_window(x0, y0, x1, y1);
+    st7735s_write_color(color, len);
+  } else {
+    bytes = _st7735s_window_bytes(
+        _st7735s_window_diff(shadow, x0, y0, x1, y1));
   }
 
-  // Алгоритм Брезенхэма для произвольных линий
+  return bytes + 2 * len;
+}
+
+// Брезенхэм, группирующий соседние пиксели в серии: для пологих линий —
+// горизонтальные, для крутых — вертикальные. Каждая серия — одно окно.
+static uint16_t _st7735s_line_spans(int16_t x0, int16_t y0, int16_t x1,
+                                    int16_t y1, uint16_t color, bool draw) {
+  if (!_st7735s_clip_line(&x0, &y0, &x1, &y1))
+    return 0;
+
   int16_t dx = (x1 > x0) ? (x1 - x0) : (x0 - x1);
   int16_t dy = (y1 > y0) ? (y1 - y0) : (y0 - y1);
   int16_t sx = (x0 < x1) ? 1 : -1;
   int16_t sy = (y0 < y1) ? 1 : -1;
   int16_t err = dx - dy;
+  bool steep = dy > dx;
 
-  while (1) {
-    // Рисование пикселя (с проверкой границ)
-    if (x0 < DISPLAY_WIDTH && y0 < DISPLAY_HEIGHT) {
-      _st7735s_set_address_window(x0, y0, x0, y0);
-      _st7735s_write_data_16(color);
-    }
-
-    if (x0 == x1 && y0 == y1)
-      break;
+  _St7735sWindow shadow = _window;
+  int16_t run_x = x0, run_y = y0;
+  uint16_t bytes = 0;
 
+  while (x0 != x1 || y0 != y1) {
     int16_t e2 = 2 * err;
+    int16_t nx = x0, ny = y0;
     if (e2 > -dy) {
       err -= dy;
-      x0 += sx;
+      nx += sx;
     }
     if (e2 < dx) {
       err += dx;
-      y0 += sy;
+      ny += sy;
+    }
+
+    // Серия заканчивается, когда меняется второстепенная координата
+    if (steep ? (nx != x0) : (ny != y0)) {
+      bytes += _st7735s_span(&shadow, run_x, run_y, x0, y0, color, draw);
+      run_x = nx;
+      run_y = ny;
     }
+    x0 = nx;
+    y0 = ny;
   }
+
+  bytes += _st7735s_span(&shadow, run_x, run_y, x0, y0, color, draw);
+  return bytes;
+}
+
+void st7735s_draw_line(int16_t x0, int16_t y0, int16_t x1, int16_t y1,
+                       uint16_t color) {
+  _st7735s_line_spans(x0, y0, x1, y1, color, true);
+}
+
+uint16_t st7735s_line_spi_bytes(int16_t x0, int16_t y0, int16_t x1,
+                                int16_t y1) {
+  return _st7735s_line_spans(x0, y0, x1, y1, 0, false);
 }
 
 void st7735s_fill_rect(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t color) {
@@ -252,17 +461,27 @@ void st7735s_fill_rect(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t
     if (w == 0 || h == 0) return;
 
     _st7735s_set_address_window(x, y, x + w - 1, y + h - 1);
+    st7735s_write_color(color, (uint32_t)w * h);
+}
+
+void st7735s_draw_bitmap(uint16_t x, uint16_t y, uint16_t w, uint16_t h,
+                         const uint16_t *pixels) {
+  if (x >= DISPLAY_WIDTH || y >= DISPLAY_HEIGHT || w == 0 || h == 0)
+    return;
 
-    DC_HIGH();
-    CS_LOW();
+  uint16_t cw = (x + w > DISPLAY_WIDTH) ? DISPLAY_WIDTH - x : w;
+  uint16_t ch = (y + h > DISPLAY_HEIGHT) ? DISPLAY_HEIGHT - y : h;
 
-    uint32_t pixels = (uint32_t)w * h;
-    for (uint32_t i = 0; i < pixels; i++) {
-        _spi_write(color >> 8);
-        _spi_write(color & 0xFF);
-    }
+  _st7735s_set_address_window(x, y, x + cw - 1, y + ch - 1);
 
-    CS_HIGH();
+  if (cw == w) {
+    st7735s_write_pixels(pixels, cw * ch);
+    return;
+  }
+
+  // Обрезано справа: строки источника длиннее окна
+  for (uint16_t row = 0; row < ch; row++)
+    st7735s_write_pixels(pixels + row * w, cw);
 }
 
 void st7735s_fill_rect_mirror_x(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
@@ -277,41 +496,106 @@ void st7735s_draw_pixel(uint16_t x, uint16_t y, uint16_t color) {
     st7735s_fill_rect(x, y, 1, 1, color);
 }
 
-void st7735s_draw_digit(int16_t x, int16_t y, char c, uint16_t color, uint8_t size) {
-    uint8_t idx;
+// --- Глифы tiny_font ---
+
+static int8_t _st7735s_glyph_index(char c) {
     switch (c) {
-        case '-': idx = 0; break;
-        case '+': idx = 1; break;
-        case '.': idx = 2; break;
-        case '°':
-        case 176: idx = 3; break;
-        case '0': idx = 4; break;
-        case '1': idx = 5; break;
-        case '2': idx = 6; break;
-        case '3': idx = 7; break;
-        case '4': idx = 8; break;
-        case '5': idx = 9; break;
-        case '6': idx = 10; break;
-        case '7': idx = 11; break;
-        case '8': idx = 12; break;
-        case '9': idx = 13; break;
-        default: return;
+        case '-': return 0;
+        case '+': return 1;
+        case '.': return 2;
+        case ST7735S_DEGREE: return 3;
+        case '0': return 4;
+        case '1': return 5;
+        case '2': return 6;
+        case '3': return 7;
+        case '4': return 8;
+        case '5': return 9;
+        case '6': return 10;
+        case '7': return 11;
+        case '8': return 12;
+        case '9': return 13;
+        default: return -1;
     }
+}
+
+// Строка глифа row (0..4, сверху вниз) как маска: бит k — k-й пиксель слева.
+// Шрифт повёрнут: строка экрана — столбец шрифта 4 - row, бит (6 - r) — пиксель x + r.
+// size 1 рисуется с зеркалом по x (как st7735s_draw_pixel), size 2 — без.
+static uint8_t _st7735s_glyph_row(int8_t idx, uint8_t row, uint8_t size) {
+    uint8_t bits = pgm_read_byte(&tiny_font[idx * 5 + (4 - row)]);
+    if (size == 1)
+        return bits & 0x7F;
+    uint8_t mask = 0;
+    for (uint8_t k = 0; k < 7; k++)
+        if (bits & (1 << (6 - k)))
+            mask |= 1 << k;
+    return mask;
+}
+
+// Длина серии одинаковых пикселей маски, начиная с k
+static uint8_t _st7735s_glyph_run(uint8_t mask, uint8_t k) {
+    bool on = mask & (1 << k);
+    uint8_t n = 1;
+    while (k + n < 7 && (bool)(mask & (1 << (k + n))) == on)
+        n++;
+    return n;
+}
 
-    for (uint8_t col = 0; col < 5; col++) {
-        uint8_t bits = pgm_read_byte(&tiny_font[idx * 5 + col]);
-        for (uint8_t row = 0; row < 7; row++) {
-            if (bits & (1 << (6 - row))) {
-                if (size == 1) {
-                    st7735s_draw_pixel(x + row, y + (4 - col), color);
-                } else if (size == 2) {
-                    st7735s_fill_rect(x + row * 2, y + (4 - col) * 2, 2, 2, color);
+// Глиф 7×5 (×size). opaque: фон тоже рисуется, и целиком видимый глиф
+// уходит одним окном сплошным блоком пикселей. Иначе — серии по строкам
+// с отсечением: по окну на серию горящих пикселей (и фона, если opaque).
+static void _st7735s_glyph(int16_t x, int16_t y, char c, uint16_t color, uint16_t bg,
+                           bool opaque, uint8_t size) {
+    int8_t idx = _st7735s_glyph_index(c);
+    if (idx < 0 || (size != 1 && size != 2)) return;
+
+    const int16_t left = (size == 1) ? DISPLAY_WIDTH - 7 - x : x;
+    const int16_t w = 7 * size, h = 5 * size;
+
+    if (opaque && left >= 0 && y >= 0 && left + w <= DISPLAY_WIDTH && y + h <= DISPLAY_HEIGHT) {
+        _st7735s_set_address_window(left, y, left + w - 1, y + h - 1);
+        for (uint8_t row = 0; row < 5; row++) {
+            uint8_t mask = _st7735s_glyph_row(idx, row, size);
+            for (uint8_t rep = 0; rep < size; rep++) {
+                for (uint8_t k = 0; k < 7;) {
+                    uint8_t n = _st7735s_glyph_run(mask, k);
+                    st7735s_write_color((mask & (1 << k)) ? color : bg, n * size);
+                    k += n;
                 }
             }
         }
+        return;
+    }
+
+    for (uint8_t row = 0; row < 5; row++) {
+        int16_t y0 = y + row * size, y1 = y0 + size - 1;
+        if (y1 < 0 || y0 >= DISPLAY_HEIGHT) continue;
+        y0 = MAX(y0, 0);
+        y1 = MIN(y1, DISPLAY_HEIGHT - 1);
+
+        uint8_t mask = _st7735s_glyph_row(idx, row, size);
+        for (uint8_t k = 0; k < 7;) {
+            uint8_t n = _st7735s_glyph_run(mask, k);
+            bool on = mask & (1 << k);
+            int16_t x0 = left + k * size, x1 = x0 + n * size - 1;
+            k += n;
+            if ((!on && !opaque) || x1 < 0 || x0 >= DISPLAY_WIDTH) continue;
+            x0 = MAX(x0, 0);
+            x1 = MIN(x1, DISPLAY_WIDTH - 1);
+            _st7735s_set_address_window(x0, y0, x1, y1);
+            st7735s_write_color(on ? color : bg, (uint32_t)(x1 - x0 + 1) * (y1 - y0 + 1));
+        }
     }
 }
 
+void st7735s_draw_digit(int16_t x, int16_t y, char c, uint16_t color, uint8_t size) {
+    _st7735s_glyph(x, y, c, color, 0, false, size);
+}
+
+void st7735s_draw_glyph(int16_t x, int16_t y, char c, uint16_t color, uint16_t bg, uint8_t size) {
+    _st7735s_glyph(x, y, c, color, bg, true, size);
+}
+
 void st7735s_draw_number_string(int16_t x, int16_t y, const char *str, uint16_t color, uint8_t size) {
     uint8_t step = (size == 1) ? 7 : 14;  // 7 = 6 (макс row) + 1 отступ
     while (*str) {
@@ -321,6 +605,16 @@ void st7735s_draw_number_string(int16_t x, int16_t y, const char *str, uint16_t
     }
 }
 
+void st7735s_draw_number_string_bg(int16_t x, int16_t y, const char *str, uint16_t color,
+                                   uint16_t bg, uint8_t size) {
+    uint8_t step = (size == 1) ? 7 : 14;
+    while (*str) {
+        st7735s_draw_glyph(x, y, *str, color, bg, size);
+        x += step;
+        str++;
+    }
+}
+
 void st7735s_draw_angle(int16_t x, int16_t y, int16_t deg, uint16_t color, uint8_t size) {
     char buf[8];
     int len = 0;
@@ -338,7 +632,7 @@ void st7735s_draw_angle(int16_t x, int16_t y, int16_t deg, uint16_t color, uint8
         buf[len++] = '0' + (deg / 10);
     }
     buf[len++] = '0' + (deg % 10);
-    buf[len++] = '°';  // символ градуса
+    buf[len++] = ST7735S_DEGREE;
     buf[len] = '\0';
 
     st7735s_draw_number_string(x, y, buf, color, size);
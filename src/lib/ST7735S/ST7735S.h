@@ -56,6 +56,19 @@
 #define CS_HIGH() _CS_HIGH()
 #define CS_LOW()  _CS_LOW()
 
+// === SPI ===
+// Без DISPLAY_ASYNC: Master, режим 0, F_CPU/4 с удвоением — F_CPU/2.
+// С DISPLAY_ASYNC частоту задаёт очередь (lib/SPI/spi_queue.h).
+#ifdef DISPLAY_ASYNC
+#include "../SPI/spi_queue.h"
+#define ST7735S_SCK_DIV SPIQ_SCK_DIV
+#else
+#define ST7735S_SPCR ((1 << SPE) | (1 << MSTR))
+#define ST7735S_SPSR (1 << SPI2X)
+#define ST7735S_SCK_DIV 2
+#endif
+#define ST7735S_SCK_HZ (F_CPU / ST7735S_SCK_DIV)
+
 // === MADCTL ===
 #define MADCTL_MY  0x80
 #define MADCTL_MX  0x40
@@ -65,17 +78,87 @@
 #define MADCTL_BGR 0x08
 #define MADCTL_MH  0x04
 #define MADCTL_LANDSCAPE (MADCTL_MX | MADCTL_MV)
+#define MADCTL_PORTRAIT  (MADCTL_MX)
+
+// Ориентация, которая уходит в MADCTL при инициализации.
+// Для портрета: -DST7735S_MADCTL=MADCTL_PORTRAIT -DDISPLAY_WIDTH=128 -DDISPLAY_HEIGHT=160
+#ifndef ST7735S_MADCTL
+    #define ST7735S_MADCTL MADCTL_LANDSCAPE
+#endif
+
+// === АППАРАТНАЯ ПРОКРУТКА ===
+// Контроллер прокручивает память кадра по строкам панели (162 строки).
+// Вдоль экранной оси Y это работает только без MV (обмен осей) и MY
+// (обратный порядок строк), то есть в портретной ориентации.
+#define ST7735S_GRAM_LINES 162
+#define ST7735S_CAN_SCROLL (!((ST7735S_MADCTL) & (MADCTL_MV | MADCTL_MY)))
+
+// CASET(1+4) + RASET(1+4) + RAMWR(1) — цена адресного окна без попадания в кэш
+#define ST7735S_WINDOW_BYTES 11
+
+// Знак градуса в строках для глифов tiny_font: байт 176 (Latin-1).
+// Литерал '°' в исходнике UTF-8 — два байта, в char он не попадает.
+#define ST7735S_DEGREE ((char)176)
 
 // === ПРОТОТИПЫ ===
+// Блокирующая инициализация: около 0.7 с пауз
 void st7735s_init(void);
+// То же по шагам, без ожидания: каждый шаг выдаёт команды до ближайшей
+// паузы и возвращает её длину в мс — следующий шаг не раньше. Пока идёт
+// пауза, процессор свободен для других устройств.
+#define ST7735S_INIT_DONE 0xFFFF
+uint16_t st7735s_init_step(void);
 void st7735s_fill_screen(uint16_t color);
-void st7735s_draw_line(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_t color);
+
+// Окно с кэшем: CASET/RASET уходят только при смене границ, RAMWR — всегда.
+// После st7735s_set_window пиксели можно досылать любым числом вызовов
+// st7735s_write_color/st7735s_write_pixels — запись продолжается с места
+// остановки, пока в контроллер не ушла другая команда.
+void st7735s_set_window(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1);
+void st7735s_write_color(uint16_t color, uint32_t count);
+void st7735s_write_pixels(const uint16_t *pixels, uint16_t count);
+
+// С DISPLAY_ASYNC вывод идёт через очередь SPI в фоне; st7735s_flush ждёт,
+// пока всё поставленное уйдёт в панель. Без DISPLAY_ASYNC — пустышка.
+void st7735s_flush(void);
+
+void st7735s_draw_line(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color);
+// Сколько байт SPI уйдёт на st7735s_draw_line с такими концами (без отрисовки).
+// Попиксельный Брезенхэм стоил ST7735S_WINDOW_BYTES + 2 байта на каждый пиксель.
+uint16_t st7735s_line_spi_bytes(int16_t x0, int16_t y0, int16_t x1, int16_t y1);
 void st7735s_draw_hline(uint16_t x, uint16_t y, uint16_t length, uint16_t color);
 void st7735s_draw_vline(uint16_t x, uint16_t y, uint16_t length, uint16_t color);
 void st7735s_fill_rect(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t color);
+void st7735s_draw_bitmap(uint16_t x, uint16_t y, uint16_t w, uint16_t h, const uint16_t *pixels);
 void st7735s_fill_rect_mirror_x(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
 void st7735s_draw_angle(int16_t x, int16_t y, int16_t deg, uint16_t color, uint8_t size);
 void st7735s_draw_number_string(int16_t x, int16_t y, const char *str, uint16_t color, uint8_t size);
+// Глифы tiny_font: draw_digit — прозрачно, сериями горящих пикселей по строкам;
+// draw_glyph — с фоном bg, целиком видимый глиф идёт одним окном 7×5 (14×10 для size 2)
 void st7735s_draw_digit(int16_t x, int16_t y, char c, uint16_t color, uint8_t size);
+void st7735s_draw_glyph(int16_t x, int16_t y, char c, uint16_t color, uint16_t bg, uint8_t size);
+void st7735s_draw_number_string_bg(int16_t x, int16_t y, const char *str, uint16_t color, uint16_t bg, uint8_t size);
+
+// VSCRDEF: tfa строк неподвижны сверху, vsa прокручиваются, bfa неподвижны
+// снизу; tfa + vsa + bfa = ST7735S_GRAM_LINES
+void st7735s_scroll_define(uint16_t tfa, uint16_t vsa, uint16_t bfa);
+// VSCRSADD: строка памяти, которая показывается первой в прокручиваемой
+// области. Запись в память по-прежнему адресуется строками памяти.
+void st7735s_scroll_start(uint16_t line);
+
+#ifdef ST7735S_PROFILE
+// Счётчики шины с момента старта: окна, кадры CS, байты команд, аргументов
+// и пикселей. С DISPLAY_ASYNC считается поставленное в очередь, а CS —
+// по вызовам драйвера: очередь может склеить соседние кадры.
+typedef struct {
+    uint32_t windows;
+    uint32_t cs_frames;
+    uint32_t cmd_bytes;
+    uint32_t arg_bytes;
+    uint32_t pixel_bytes;
+} St7735sTraffic;
+
+const St7735sTraffic *st7735s_traffic(void);
+#endif
 
 #endif // ST7735S_H
\ No newline at end of file
@@ -1,7 +1,30 @@
 #include "ST7789.h"
 #include "Font.h"
 
+#ifndef MIN
+#define MIN(a, b) ((a) < (b) ? (a) : (b))
+#endif
+#ifndef MAX
+#define MAX(a, b) ((a) > (b) ? (a) : (b))
+#endif
+
 // --- Внутренние функции ---
+#ifdef DISPLAY_ASYNC
+#include "../SPI/spi_queue.h"
+
+#if defined(ST7789_NO_CS) && defined(SPIQ_CS_PIN)
+    #error "ST7789 без CS: собирай очередь SPI с -DSPIQ_NO_CS"
+#endif
+
+// Асинхронный режим: байты отправляет прерывание SPI из очереди
+static void _spi_init(void) { spiq_init(); }
+
+static void _st7789_write_cmd(uint8_t cmd) { spiq_command(cmd, NULL, 0); }
+static void _st7789_write_data16(uint16_t data) { spiq_pixels(&data, 1); }
+static void _st7789_write_cmd_args(uint8_t cmd, const uint8_t *args, uint8_t n) {
+    spiq_command(cmd, args, n);
+}
+#else
 static void _spi_init(void) {
     DDRB |= (1 << PB3) | (1 << PB5); // MOSI, SCK → выход
     SPCR = (1 << SPE) | (1 << MSTR); // SPI Master, Mode 0
@@ -21,14 +44,6 @@ static void _st7789_write_cmd(uint8_t cmd) {
     _CS_HIGH();
 }
 
-// 🔹 ДАННЫЕ: DC=1, передаём 1 байт
-static void _st7789_write_data8(uint8_t data) {
-    DC_HIGH();
-    _CS_LOW();
-    _spi_write(data);
-    _CS_HIGH();
-}
-
 // 🔹 ДАННЫЕ: 16-бит (2 байта)
 static void _st7789_write_data16(uint16_t data) {
     DC_HIGH();
@@ -38,38 +53,104 @@ static void _st7789_write_data16(uint16_t data) {
     _CS_HIGH();
 }
 
-// 🔹 БЛОК ДАННЫХ (быстро, без переключения CS/DC внутри)
-static void _st7789_write_data_block(const uint8_t *data, uint16_t len) {
-    DC_HIGH();
+// 🔹 КОМАНДА + АРГУМЕНТЫ одним кадром CS (DC переключаем между байтами)
+static void _st7789_write_cmd_args(uint8_t cmd, const uint8_t *args, uint8_t n) {
     _CS_LOW();
-    for (uint16_t i = 0; i < len; i++) {
-        _spi_write(data[i]);
+    DC_LOW();
+    _spi_write(cmd);
+    DC_HIGH();
+    for (uint8_t i = 0; i < n; i++) {
+        _spi_write(args[i]);
     }
     _CS_HIGH();
 }
+#endif
+
+// 🔹 КЭШ ОКНА: CASET/RASET не повторяем, если границы не менялись
+typedef struct {
+    uint16_t x0, x1, y0, y1;
+} _St7789Window;
+
+#define _WINDOW_INVALID {0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF}
+#define _WINDOW_COLS 0x01
+#define _WINDOW_ROWS 0x02
+
+static _St7789Window _window = _WINDOW_INVALID;
+
+static uint8_t _st7789_window_diff(_St7789Window *w, uint16_t x0, uint16_t y0,
+                                   uint16_t x1, uint16_t y1) {
+    uint8_t diff = 0;
+    if (x0 != w->x0 || x1 != w->x1) { w->x0 = x0; w->x1 = x1; diff |= _WINDOW_COLS; }
+    if (y0 != w->y0 || y1 != w->y1) { w->y0 = y0; w->y1 = y1; diff |= _WINDOW_ROWS; }
+    return diff;
+}
+
+static uint8_t _st7789_window_bytes(uint8_t diff) {
+    return 1 + ((diff & _WINDOW_COLS) ? 5 : 0) + ((diff & _WINDOW_ROWS) ? 5 : 0);
+}
+
+// Возвращает число отправленных байт
+static uint8_t _st7789_open_window(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1) {
+    uint8_t diff = _st7789_window_diff(&_window, x0, y0, x1, y1);
 
-// 🔹 УСТАНОВКА АДРЕСНОГО ОКНА (с учётом COLSTART/ROWSTART)
-void _st7789_set_window(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1) {
     // Коррекция на физическое смещение дисплея
-    x0 += COLSTART; x1 += COLSTART;
-    y0 += ROWSTART; y1 += ROWSTART;
-
-    // CASET: столбцы
-    _st7789_write_cmd(0x2A);
-    _st7789_write_data8(x0 >> 8);
-    _st7789_write_data8(x0 & 0xFF);
-    _st7789_write_data8(x1 >> 8);
-    _st7789_write_data8(x1 & 0xFF);
-
-    // RASET: строки
-    _st7789_write_cmd(0x2B);
-    _st7789_write_data8(y0 >> 8);
-    _st7789_write_data8(y0 & 0xFF);
-    _st7789_write_data8(y1 >> 8);
-    _st7789_write_data8(y1 & 0xFF);
-
-    // RAMWR: готовы к записи пикселей
+    if (diff & _WINDOW_COLS) {
+        x0 += COLSTART; x1 += COLSTART;
+        const uint8_t caset[4] = {x0 >> 8, x0 & 0xFF, x1 >> 8, x1 & 0xFF};
+        _st7789_write_cmd_args(0x2A, caset, 4);
+    }
+    if (diff & _WINDOW_ROWS) {
+        y0 += ROWSTART; y1 += ROWSTART;
+        const uint8_t raset[4] = {y0 >> 8, y0 & 0xFF, y1 >> 8, y1 & 0xFF};
+        _st7789_write_cmd_args(0x2B, raset, 4);
+    }
+
+    // RAMWR всегда: возвращает указатель записи в начало окна
     _st7789_write_cmd(0x2C);
+    return _st7789_window_bytes(diff);
+}
+
+// 🔹 УСТАНОВКА АДРЕСНОГО ОКНА (с учётом COLSTART/ROWSTART и кэша)
+void _st7789_set_window(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1) {
+    _st7789_open_window(x0, y0, x1, y1);
+}
+
+// 🔹 ПРОДОЛЖЕНИЕ ЗАПИСИ в текущее окно (без повторного RAMWR)
+void st7789_write_color(uint16_t color, uint32_t count) {
+#ifdef DISPLAY_ASYNC
+    spiq_fill(color, count);
+#else
+    uint8_t hi = color >> 8;
+    uint8_t lo = color & 0xFF;
+    DC_HIGH();
+    _CS_LOW();
+    while (count--) {
+        _spi_write(hi);
+        _spi_write(lo);
+    }
+    _CS_HIGH();
+#endif
+}
+
+void st7789_write_pixels(const uint16_t *pixels, uint16_t count) {
+#ifdef DISPLAY_ASYNC
+    spiq_pixels(pixels, count);
+#else
+    DC_HIGH();
+    _CS_LOW();
+    for (uint16_t i = 0; i < count; i++) {
+        _spi_write(pixels[i] >> 8);
+        _spi_write(pixels[i] & 0xFF);
+    }
+    _CS_HIGH();
+#endif
+}
+
+// 🔹 БАРЬЕР: ждём, пока очередь SPI уйдёт в панель
+void st7789_flush(void) {
+#ifdef DISPLAY_ASYNC
+    spiq_flush();
+#endif
 }
 
 // ✅ ИНИЦИАЛИЗАЦИЯ ST7789 (рабочая)
@@ -91,68 +172,64 @@ void st7789_init(void) {
     RESET_LOW();  _delay_ms(20);
     RESET_HIGH(); _delay_ms(150);
 
-    // ⚙️ Инициализация (последовательность от Adafruit + Bodmer)
-    _st7789_write_cmd(0x11); _delay_ms(10); // SLPOUT
-    _st7789_write_cmd(0x36); _st7789_write_data8(MADCTL_LANDSCAPE); // MADCTL
-
-    _st7789_write_cmd(0x3A); _st7789_write_data8(0x05); // COLMOD: 16-bit (RGB565)
+    // После сброса окно контроллера — весь экран, кэш недействителен
+    const _St7789Window invalid = _WINDOW_INVALID;
+    _window = invalid;
 
-    // Пороги porch (стандартные)
-    _st7789_write_cmd(0xB2);
-    _st7789_write_data8(0x0C); _st7789_write_data8(0x0C);
-    _st7789_write_data8(0x00); _st7789_write_data8(0x33);
-    _st7789_write_data8(0x33);
+    // ⚙️ Инициализация (последовательность от Adafruit + Bodmer)
+    _st7789_write_cmd(0x11); st7789_flush(); _delay_ms(10); // SLPOUT
 
-    // Gate control
-    _st7789_write_cmd(0xB7);
-    _st7789_write_data8(0x35);
+    static const uint8_t madctl[]  = {ST7789_MADCTL};
+    static const uint8_t colmod[]  = {0x05};                         // 16-bit (RGB565)
+    static const uint8_t porctrl[] = {0x0C, 0x0C, 0x00, 0x33, 0x33}; // porch (стандартные)
+    static const uint8_t gctrl[]   = {0x35};
+    static const uint8_t vcoms[]   = {0x19}; // 0x19–0x2B (часто 0x19 для 3.3 В)
+    static const uint8_t vdvvrh[]  = {0x01};
 
-    // VCOM
-    _st7789_write_cmd(0xBB);
-    _st7789_write_data8(0x19); // 0x19–0x2B (часто 0x19 для 3.3 В)
+    _st7789_write_cmd_args(0x36, madctl, 1);  // MADCTL
+    _st7789_write_cmd_args(0x3A, colmod, 1);  // COLMOD
+    _st7789_write_cmd_args(0xB2, porctrl, 5); // PORCTRL
+    _st7789_write_cmd_args(0xB7, gctrl, 1);   // Gate control
+    _st7789_write_cmd_args(0xBB, vcoms, 1);   // VCOM
 
     // LCM Control — ОСТОРОЖНО: у ST7789 это 0xC0, но НЕ у всех!
-    // Некоторые cheap-панели его не принимают → закомментируй, если глючит
+    // Некоторые cheap-панели его не принимают → раскомментируй, если нужно
     /*
-    _st7789_write_cmd(0xC0);
-    _st7789_write_data8(0x2C);
+    static const uint8_t lcmctrl[] = {0x2C};
+    _st7789_write_cmd_args(0xC0, lcmctrl, 1);
     */
 
-    // VDV и VRH
-    _st7789_write_cmd(0xC2);
-    _st7789_write_data8(0x01);
+    _st7789_write_cmd_args(0xC2, vdvvrh, 1);  // VDV и VRH
 
     // Gamma (опционально, но рекомендовано)
-    _st7789_write_cmd(0xE0);
-    const uint8_t gamma_pos[] = {0xD0, 0x04, 0x0D, 0x11, 0x13, 0x2B, 0x3F, 0x54,
-                                  0x4C, 0x18, 0x0D, 0x0B, 0x1F, 0x23};
-    _st7789_write_data_block(gamma_pos, sizeof(gamma_pos));
-
-    _st7789_write_cmd(0xE1);
-    const uint8_t gamma_neg[] = {0xD0, 0x04, 0x0C, 0x11, 0x13, 0x2C, 0x3F, 0x44,
-                                  0x51, 0x2F, 0x1F, 0x1F, 0x20, 0x23};
-    _st7789_write_data_block(gamma_neg, sizeof(gamma_neg));
+    static const uint8_t gamma_pos[] = {0xD0, 0x04, 0x0D, 0x11, 0x13, 0x2B, 0x3F, 0x54,
+                                        0x4C, 0x18, 0x0D, 0x0B, 0x1F, 0x23};
+    static const uint8_t gamma_neg[] = {0xD0, 0x04, 0x0C, 0x11, 0x13, 0x2C, 0x3F, 0x44,
+                                        0x51, 0x2F, 0x1F, 0x1F, 0x20, 0x23};
+    _st7789_write_cmd_args(0xE0, gamma_pos, sizeof(gamma_pos));
+    _st7789_write_cmd_args(0xE1, gamma_neg, sizeof(gamma_neg));
 
     // Включение дисплея
     _st7789_write_cmd(0x29); // DISPON
+    st7789_flush();
     _delay_ms(100);
 }
 
 // ✅ Заливка экрана (оптимизировано: CS внизу на всё окно)
 void st7789_fill_screen(uint16_t color) {
-    _st7789_set_window(0, 0, DISPLAY_WIDTH - 1, DISPLAY_HEIGHT - 1);
-    DC_HIGH();
-    _CS_LOW();
+    _st7789_open_window(0, 0, DISPLAY_WIDTH - 1, DISPLAY_HEIGHT - 1);
+    st7789_write_color(color, (uint32_t)DISPLAY_WIDTH * DISPLAY_HEIGHT);
+}
 
-    uint32_t pixels = (uint32_t)DISPLAY_WIDTH * DISPLAY_HEIGHT;
-    uint8_t hi = color >> 8;
-    uint8_t lo = color & 0xFF;
+// ✅ Аппаратная вертикальная прокрутка
+void st7789_scroll_define(uint16_t tfa, uint16_t vsa, uint16_t bfa) {
+    const uint8_t args[] = {tfa >> 8, tfa & 0xFF, vsa >> 8, vsa & 0xFF, bfa >> 8, bfa & 0xFF};
+    _st7789_write_cmd_args(0x33, args, 6); // VSCRDEF
+}
 
-    for (uint32_t i = 0; i < pixels; i++) {
-        _spi_write(hi);
-        _spi_write(lo);
-    }
-    _CS_HIGH();
+void st7789_scroll_start(uint16_t line) {
+    const uint8_t args[] = {line >> 8, line & 0xFF};
+    _st7789_write_cmd_args(0x37, args, 2); // VSCRSADD
 }
 
 // ✅ Горизонтальная линия
@@ -160,17 +237,8 @@ void st7789_draw_hline(uint16_t x, uint16_t y, uint16_t w, uint16_t color) {
     if (y >= DISPLAY_HEIGHT || x >= DISPLAY_WIDTH || w == 0) return;
     if (x + w > DISPLAY_WIDTH) w = DISPLAY_WIDTH - x;
 
-    _st7789_set_window(x, y, x + w - 1, y);
-    DC_HIGH();
-    _CS_LOW();
-
-    uint8_t hi = color >> 8;
-    uint8_t lo = color & 0xFF;
-    for (uint16_t i = 0; i < w; i++) {
-        _spi_write(hi);
-        _spi_write(lo);
-    }
-    _CS_HIGH();
+    _st7789_open_window(x, y, x + w - 1, y);
+    st7789_write_color(color, w);
 }
 
 // ✅ Вертикальная линия
@@ -178,17 +246,8 @@ void st7789_draw_vline(uint16_t x, uint16_t y, uint16_t h, uint16_t color) {
     if (x >= DISPLAY_WIDTH || y >= DISPLAY_HEIGHT || h == 0) return;
     if (y + h > DISPLAY_HEIGHT) h = DISPLAY_HEIGHT - y;
 
-    _st7789_set_window(x, y, x, y + h - 1);
-    DC_HIGH();
-    _CS_LOW();
-
-    uint8_t hi = color >> 8;
-    uint8_t lo = color & 0xFF;
-    for (uint16_t i = 0; i < h; i++) {
-        _spi_write(hi);
-        _spi_write(lo);
-    }
-    _CS_HIGH();
+    _st7789_open_window(x, y, x, y + h - 1);
+    st7789_write_color(color, h);
 }
 
 // ✅ Прямоугольник
@@ -197,46 +256,131 @@ void st7789_fill_rect(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t c
     if (x + w > DISPLAY_WIDTH) w = DISPLAY_WIDTH - x;
     if (y + h > DISPLAY_HEIGHT) h = DISPLAY_HEIGHT - y;
 
-    _st7789_set_window(x, y, x + w - 1, y + h - 1);
-    DC_HIGH();
-    _CS_LOW();
+    _st7789_open_window(x, y, x + w - 1, y + h - 1);
+    st7789_write_color(color, (uint32_t)w * h);
+}
 
-    uint32_t pixels = (uint32_t)w * h;
-    uint8_t hi = color >> 8;
-    uint8_t lo = color & 0xFF;
-    for (uint32_t i = 0; i < pixels; i++) {
-        _spi_write(hi);
-        _spi_write(lo);
+// ✅ Битмап RGB565 (обрезается по краю экрана)
+void st7789_draw_bitmap(uint16_t x, uint16_t y, uint16_t w, uint16_t h, const uint16_t *pixels) {
+    if (x >= DISPLAY_WIDTH || y >= DISPLAY_HEIGHT || w == 0 || h == 0) return;
+
+    uint16_t cw = (x + w > DISPLAY_WIDTH) ? DISPLAY_WIDTH - x : w;
+    uint16_t ch = (y + h > DISPLAY_HEIGHT) ? DISPLAY_HEIGHT - y : h;
+
+    _st7789_open_window(x, y, x + cw - 1, y + ch - 1);
+
+    if (cw == w) {
+        st7789_write_pixels(pixels, cw * ch);
+        return;
+    }
+
+    // Обрезано справа: строки источника длиннее окна
+    for (uint16_t row = 0; row < ch; row++) {
+        st7789_write_pixels(pixels + row * w, cw);
     }
-    _CS_HIGH();
 }
 
 // ✅ Пиксель (без зеркалирования x!)
 void st7789_draw_pixel(uint16_t x, uint16_t y, uint16_t color) {
     if (x >= DISPLAY_WIDTH || y >= DISPLAY_HEIGHT) return;
-    _st7789_set_window(x, y, x, y);
+    _st7789_open_window(x, y, x, y);
     _st7789_write_data16(color);
 }
 
-// ✅ Линия (Брезенхэм с оптимизацией под hline/vline)
-void st7789_draw_line(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_t color) {
-    if (x0 == x1) { st7789_draw_vline(x0, y0, (y1 > y0) ? y1 - y0 + 1 : y0 - y1 + 1, color); return; }
-    if (y0 == y1) { st7789_draw_hline(x0, y0, (x1 > x0) ? x1 - x0 + 1 : x0 - x1 + 1, color); return; }
+// --- Линии: отсечение + серии пикселей ---
+
+// Коды Коэна–Сазерленда
+static uint8_t _st7789_outcode(int16_t x, int16_t y) {
+    uint8_t code = 0;
+    if (x < 0) code |= 1; else if (x >= DISPLAY_WIDTH)  code |= 2;
+    if (y < 0) code |= 4; else if (y >= DISPLAY_HEIGHT) code |= 8;
+    return code;
+}
+
+// Отсечение отрезка по экрану. false — отрезок целиком снаружи.
+static bool _st7789_clip_line(int16_t *x0, int16_t *y0, int16_t *x1, int16_t *y1) {
+    uint8_t c0 = _st7789_outcode(*x0, *y0);
+    uint8_t c1 = _st7789_outcode(*x1, *y1);
+
+    while (1) {
+        if (!(c0 | c1)) return true;
+        if (c0 & c1) return false;
+
+        uint8_t c = c0 ? c0 : c1;
+        int32_t dx = (int32_t)*x1 - *x0;
+        int32_t dy = (int32_t)*y1 - *y0;
+        int32_t x, y;
+
+        if (c & 8)      { y = DISPLAY_HEIGHT - 1; x = *x0 + dx * (y - *y0) / dy; }
+        else if (c & 4) { y = 0;                  x = *x0 + dx * (y - *y0) / dy; }
+        else if (c & 2) { x = DISPLAY_WIDTH - 1;  y = *y0 + dy * (x - *x0) / dx; }
+        else            { x = 0;                  y = *y0 + dy * (x - *x0) / dx; }
+
+        if (c == c0) { *x0 = x; *y0 = y; c0 = _st7789_outcode(*x0, *y0); }
+        else         { *x1 = x; *y1 = y; c1 = _st7789_outcode(*x1, *y1); }
+    }
+}
+
+// Серия пикселей через одно окно. Возвращает стоимость в байтах SPI;
+// без draw только считает её по теневой копии кэша окна.
+static uint16_t _st7789_span(_St7789Window *shadow, int16_t xa, int16_t ya,
+                             int16_t xb, int16_t yb, uint16_t color, bool draw) {
+    uint16_t x0 = xa < xb ? xa : xb, x1 = xa < xb ? xb : xa;
+    uint16_t y0 = ya < yb ? ya : yb, y1 = ya < yb ? yb : ya;
+    uint16_t len = (x1 - x0 + 1) * (y1 - y0 + 1);
+    uint16_t bytes;
+
+    if (draw) {
+        bytes = _st7789_open_window(x0, y0, x1, y1);
+        st7789_write_color(color, len);
+    } else {
+        bytes = _st7789_window_bytes(_st7789_window_diff(shadow, x0, y0, x1, y1));
+    }
+    return bytes + 2 * len;
+}
+
+// Брезенхэм с группировкой: пологие линии — горизонтальными сериями,
+// крутые — вертикальными; на серию одно адресное окно
+static uint16_t _st7789_line_spans(int16_t x0, int16_t y0, int16_t x1, int16_t y1,
+                                   uint16_t color, bool draw) {
+    if (!_st7789_clip_line(&x0, &y0, &x1, &y1)) return 0;
 
     int16_t dx = x1 > x0 ? x1 - x0 : x0 - x1;
     int16_t dy = y1 > y0 ? y1 - y0 : y0 - y1;
     int16_t sx = x0 < x1 ? 1 : -1;
     int16_t sy = y0 < y1 ? 1 : -1;
     int16_t err = dx - dy;
+    bool steep = dy > dx;
 
-    while (1) {
-        if (x0 < DISPLAY_WIDTH && y0 < DISPLAY_HEIGHT && x0 >= 0 && y0 >= 0)
-            st7789_draw_pixel(x0, y0, color);
-        if (x0 == x1 && y0 == y1) break;
+    _St7789Window shadow = _window;
+    int16_t run_x = x0, run_y = y0;
+    uint16_t bytes = 0;
+
+    while (x0 != x1 || y0 != y1) {
         int16_t e2 = 2 * err;
-        if (e2 > -dy) { err -= dy; x0 += sx; }
-        if (e2 <  dx) { err += dx; y0 += sy; }
+        int16_t nx = x0, ny = y0;
+        if (e2 > -dy) { err -= dy; nx += sx; }
+        if (e2 <  dx) { err += dx; ny += sy; }
+
+        // Смена второстепенной координаты закрывает серию
+        if (steep ? (nx != x0) : (ny != y0)) {
+            bytes += _st7789_span(&shadow, run_x, run_y, x0, y0, color, draw);
+            run_x = nx; run_y = ny;
+        }
+        x0 = nx; y0 = ny;
     }
+
+    bytes += _st7789_span(&shadow, run_x, run_y, x0, y0, color, draw);
+    return bytes;
+}
+
+// ✅ Линия (серии + отсечение)
+void st7789_draw_line(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color) {
+    _st7789_line_spans(x0, y0, x1, y1, color, true);
+}
+
+uint16_t st7789_line_spi_bytes(int16_t x0, int16_t y0, int16_t x1, int16_t y1) {
+    return _st7789_line_spans(x0, y0, x1, y1, 0, false);
 }
 
 // ✅ Зеркальное отражение по X (если нужно)
@@ -246,32 +390,88 @@ void st7789_fill_rect_mirror_x(int16_t x, int16_t y, int16_t w, int16_t h, uint1
     st7789_fill_rect(x_mirr, y, w, h, color);
 }
 
-// ✅ Рисование цифры (исправлено: убрано x = width-1-x)
-void st7789_draw_digit(int16_t x, int16_t y, char c, uint16_t color, uint8_t size) {
-    uint8_t idx;
+// --- Глифы tiny_font ---
+
+static int8_t _st7789_glyph_index(char c) {
     switch (c) {
-        case '-': idx = 0; break; case '+': idx = 1; break;
-        case '.': idx = 2; break; case '°': case 176: idx = 3; break;
-        case '0': idx = 4; break; case '1': idx = 5; break;
-        case '2': idx = 6; break; case '3': idx = 7; break;
-        case '4': idx = 8; break; case '5': idx = 9; break;
-        case '6': idx = 10; break; case '7': idx = 11; break;
-        case '8': idx = 12; break; case '9': idx = 13; break;
-        default: return;
+        case '-': return 0;  case '+': return 1;
+        case '.': return 2;  case ST7789_DEGREE: return 3;
+        case '0': return 4;  case '1': return 5;
+        case '2': return 6;  case '3': return 7;
+        case '4': return 8;  case '5': return 9;
+        case '6': return 10; case '7': return 11;
+        case '8': return 12; case '9': return 13;
+        default: return -1;
     }
+}
 
-    for (uint8_t col = 0; col < 5; col++) {
-        uint8_t bits = pgm_read_byte(&tiny_font[idx * 5 + col]);
-        for (uint8_t row = 0; row < 7; row++) {
-            if (bits & (1 << (6 - row))) {
-                if (size == 1) {
-                    st7789_draw_pixel(x + row, y + (4 - col), color);
-                } else if (size == 2) {
-                    st7789_fill_rect(x + row * 2, y + (4 - col) * 2, 2, 2, color);
+// Строка глифа row (0..4) маской: бит k — k-й пиксель слева.
+// Шрифт повёрнут: строка экрана — столбец шрифта 4 - row, бит (6 - r) — пиксель x + r
+static uint8_t _st7789_glyph_row(int8_t idx, uint8_t row) {
+    uint8_t bits = pgm_read_byte(&tiny_font[idx * 5 + (4 - row)]);
+    uint8_t mask = 0;
+    for (uint8_t k = 0; k < 7; k++)
+        if (bits & (1 << (6 - k))) mask |= 1 << k;
+    return mask;
+}
+
+// Длина серии одинаковых пикселей маски, начиная с k
+static uint8_t _st7789_glyph_run(uint8_t mask, uint8_t k) {
+    bool on = mask & (1 << k);
+    uint8_t n = 1;
+    while (k + n < 7 && (bool)(mask & (1 << (k + n))) == on) n++;
+    return n;
+}
+
+// Глиф 7×5 (×size). opaque: с фоном, целиком видимый глиф — одно окно и
+// сплошной блок пикселей. Иначе — серии по строкам с отсечением.
+static void _st7789_glyph(int16_t x, int16_t y, char c, uint16_t color, uint16_t bg, bool opaque, uint8_t size) {
+    int8_t idx = _st7789_glyph_index(c);
+    if (idx < 0 || (size != 1 && size != 2)) return;
+    const int16_t w = 7 * size, h = 5 * size;
+
+    if (opaque && x >= 0 && y >= 0 && x + w <= DISPLAY_WIDTH && y + h <= DISPLAY_HEIGHT) {
+        _st7789_open_window(x, y, x + w - 1, y + h - 1);
+        for (uint8_t row = 0; row < 5; row++) {
+            uint8_t mask = _st7789_glyph_row(idx, row);
+            for (uint8_t rep = 0; rep < size; rep++) {
+                for (uint8_t k = 0; k < 7;) {
+                    uint8_t n = _st7789_glyph_run(mask, k);
+                    st7789_write_color((mask & (1 << k)) ? color : bg, n * size);
+                    k += n;
                 }
             }
         }
+        return;
     }
+
+    for (uint8_t row = 0; row < 5; row++) {
+        int16_t y0 = y + row * size, y1 = y0 + size - 1;
+        if (y1 < 0 || y0 >= DISPLAY_HEIGHT) continue;
+        y0 = MAX(y0, 0); y1 = MIN(y1, DISPLAY_HEIGHT - 1);
+
+        uint8_t mask = _st7789_glyph_row(idx, row);
+        for (uint8_t k = 0; k < 7;) {
+            uint8_t n = _st7789_glyph_run(mask, k);
+            bool on = mask & (1 << k);
+            int16_t x0 = x + k * size, x1 = x0 + n * size - 1;
+            k += n;
+            if ((!on && !opaque) || x1 < 0 || x0 >= DISPLAY_WIDTH) continue;
+            x0 = MAX(x0, 0); x1 = MIN(x1, DISPLAY_WIDTH - 1);
+            _st7789_open_window(x0, y0, x1, y1);
+            st7789_write_color(on ? color : bg, (uint32_t)(x1 - x0 + 1) * (y1 - y0 + 1));
+        }
+    }
+}
+
+// ✅ Рисование цифры (без зеркалирования x): прозрачно, сериями по строкам
+void st7789_draw_digit(int16_t x, int16_t y, char c, uint16_t color, uint8_t size) {
+    _st7789_glyph(x, y, c, color, 0, false, size);
+}
+
+// ✅ Цифра с фоном: одно окно на глиф
+void st7789_draw_glyph(int16_t x, int16_t y, char c, uint16_t color, uint16_t bg, uint8_t size) {
+    _st7789_glyph(x, y, c, color, bg, true, size);
 }
 
 void st7789_draw_number_string(int16_t x, int16_t y, const char *str, uint16_t color, uint8_t size) {
@@ -283,6 +483,15 @@ void st7789_draw_number_string(int16_t x, int16_t y, const char *str, uint16_t c
     }
 }
 
+void st7789_draw_number_string_bg(int16_t x, int16_t y, const char *str, uint16_t color, uint16_t bg, uint8_t size) {
+    uint8_t step = (size == 1) ? 7 : 14;
+    while (*str) {
+        st7789_draw_glyph(x, y, *str, color, bg, size);
+        x += step;
+        str++;
+    }
+}
+
 void st7789_draw_angle(int16_t x, int16_t y, int16_t deg, uint16_t color, uint8_t size) {
     char buf[8];
     int len = 0;
@@ -300,7 +509,7 @@ void st7789_draw_angle(int16_t x, int16_t y, int16_t deg, uint16_t color, uint8_
         buf[len++] = '0' + (deg / 10);
     }
     buf[len++] = '0' + (deg % 10);
-    buf[len++] = '°';  // символ градуса
+    buf[len++] = ST7789_DEGREE;
     buf[len] = '\0';
 
     st7789_draw_number_string(x, y, buf, color, size);
@@ -85,20 +85,62 @@
 #define MADCTL_LANDSCAPE_REV  (MADCTL_MY | MADCTL_BGR)              // 180°
 #define MADCTL_PORTRAIT_REV   (MADCTL_MX | MADCTL_BGR)              // 270°
 
+// Ориентация при инициализации (переопредели -DST7789_MADCTL=...)
+#ifndef ST7789_MADCTL
+    #define ST7789_MADCTL MADCTL_LANDSCAPE
+#endif
+
+// === АППАРАТНАЯ ПРОКРУТКА ===
+// Память кадра — 320 строк панели; прокрутка идёт вдоль них, поэтому по
+// экранной оси Y она доступна только без MV и MY (MADCTL_PORTRAIT_REV).
+// Видимые строки — ROWSTART..ROWSTART+DISPLAY_HEIGHT-1.
+#define ST7789_GRAM_LINES 320
+#define ST7789_CAN_SCROLL (!((ST7789_MADCTL) & (MADCTL_MV | MADCTL_MY)))
+
+// CASET(1+4) + RASET(1+4) + RAMWR(1) — цена окна без попадания в кэш
+#define ST7789_WINDOW_BYTES 11
+
+// Знак градуса для глифов tiny_font: байт 176 (Latin-1), как у ST7735S
+#define ST7789_DEGREE ((char)176)
+
 // === ПРОТОТИПЫ ФУНКЦИЙ ===
 void st7789_init(void);
 void st7789_fill_screen(uint16_t color);
 void st7789_fill_rect(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t color);
 void st7789_draw_hline(uint16_t x, uint16_t y, uint16_t w, uint16_t color);
 void st7789_draw_vline(uint16_t x, uint16_t y, uint16_t h, uint16_t color);
-void st7789_draw_line(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_t color);
+void st7789_draw_line(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color);
+// Байты SPI, которые уйдут на st7789_draw_line (без отрисовки).
+// Попиксельный вариант стоил ST7789_WINDOW_BYTES + 2 байта на пиксель.
+uint16_t st7789_line_spi_bytes(int16_t x0, int16_t y0, int16_t x1, int16_t y1);
 void st7789_draw_pixel(uint16_t x, uint16_t y, uint16_t color);
+void st7789_draw_bitmap(uint16_t x, uint16_t y, uint16_t w, uint16_t h, const uint16_t *pixels);
 void st7789_fill_rect_mirror_x(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+// Глифы tiny_font: draw_digit — прозрачно (серии по строкам),
+// draw_glyph — с фоном, одним окном 7×5 (14×10 для size 2)
 void st7789_draw_digit(int16_t x, int16_t y, char c, uint16_t color, uint8_t size);
+void st7789_draw_glyph(int16_t x, int16_t y, char c, uint16_t color, uint16_t bg, uint8_t size);
 void st7789_draw_number_string(int16_t x, int16_t y, const char *str, uint16_t color, uint8_t size);
+void st7789_draw_number_string_bg(int16_t x, int16_t y, const char *str, uint16_t color, uint16_t bg, uint8_t size);
 void st7789_draw_angle(int16_t x, int16_t y, int16_t deg, uint16_t color, uint8_t size);
 
+// VSCRDEF: tfa + vsa + bfa = ST7789_GRAM_LINES (в строках памяти)
+void st7789_scroll_define(uint16_t tfa, uint16_t vsa, uint16_t bfa);
+// VSCRSADD: строка памяти, показываемая первой в прокручиваемой области
+void st7789_scroll_start(uint16_t line);
+
 // === ВНУТРЕННЯЯ ФУНКЦИЯ (не обязана быть в .h, но иногда удобно) ===
+// Окно кэшируется: CASET/RASET уходят только при смене границ, RAMWR — всегда
 void _st7789_set_window(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1);
 
+// === ПРОДОЛЖЕНИЕ ЗАПИСИ В ТЕКУЩЕЕ ОКНО ===
+// Пиксели досылаются с места остановки, пока в контроллер не ушла другая команда
+void st7789_write_color(uint16_t color, uint32_t count);
+void st7789_write_pixels(const uint16_t *pixels, uint16_t count);
+
+// === АСИНХРОННЫЙ ВЫВОД (DISPLAY_ASYNC) ===
+// Всё идёт через очередь SPI в фоне; без CS очередь собирается с -DSPIQ_NO_CS.
+// st7789_flush ждёт, пока поставленное уйдёт в панель (без DISPLAY_ASYNC — пустышка)
+void st7789_flush(void);
+
 #endif // ST7789_H
\ No newline at end of file
@@ -0,0 +1,90 @@
+#include "sched.h"
+#include "../Timebase/timebase.h"
+
+#include <stdbool.h>
+
+static SchedTask *tasks;
+static uint8_t task_count;
+// Индекс выполняемой задачи; task_count — вне задач
+static uint8_t current;
+// Время вложенных задач, отработавших внутри текущей (через sched_yield)
+static uint32_t nested_us;
+
+void sched_init(SchedTask *t, uint8_t count) {
+  tasks = t;
+  task_count = count;
+  current = count;
+  nested_us = 0;
+
+  uint32_t now = timebase_micros();
+  for (uint8_t i = 0; i < count; i++)
+    tasks[i].next_us = now;
+  sched_reset_stats();
+}
+
+void sched_reset_stats(void) {
+  for (uint8_t i = 0; i < task_count; i++) {
+    tasks[i].worst_us = 0;
+    tasks[i].runs = 0;
+    tasks[i].overruns = 0;
+  }
+}
+
+static bool is_due(const SchedTask *t, uint32_t now) {
+  return t->period_us && (int32_t)(now - t->next_us) >= 0;
+}
+
+static void run_task(uint8_t i, uint32_t now) {
+  SchedTask *t = &tasks[i];
+
+  // Следующий срок; если опоздали на целый период — пропускаем
+  // накопившиеся и считаем это перегрузкой
+  if (t->period_us) {
+    if (now - t->next_us >= t->period_us) {
+      t->overruns++;
+      t->next_us = now + t->period_us;
+    } else {
+      t->next_us += t->period_us;
+    }
+  }
+
+  uint8_t outer = current;
+  uint32_t outer_nested = nested_us;
+  current = i;
+  nested_us = 0;
+
+  t->run();
+
+  uint32_t took = timebase_micros() - now;
+  uint32_t own = took - nested_us;
+  if (own > t->worst_us)
+    t->worst_us = own;
+  t->runs++;
+
+  current = outer;
+  nested_us = outer_nested + took;
+}
+
+void sched_run(void) {
+  uint32_t now = timebase_micros();
+  for (uint8_t i = 0; i < task_count; i++) {
+    if (is_due(&tasks[i], now)) {
+      run_task(i, now);
+      return;
+    }
+  }
+
+  for (uint8_t i = 0; i < task_count; i++) {
+    if (!tasks[i].period_us)
+      run_task(i, timebase_micros());
+  }
+}
+
+void sched_yield(void) {
+  // Только задачи приоритетнее текущей: сама она и ниже ждут её конца
+  for (uint8_t i = 0; i < current; i++) {
+    uint32_t now = timebase_micros();
+    if (is_due(&tasks[i], now))
+      run_task(i, now);
+  }
+}
@@ -0,0 +1,35 @@
+#ifndef SCHED_H
+#define SCHED_H
+
+#include <stdint.h>
+
+// Кооперативный планировщик со сроками на часах Timebase.
+//
+// Задачи лежат в массиве по убыванию приоритета. sched_run() за проход
+// запускает самую приоритетную задачу, срок которой наступил; если таких
+// нет — фоновые задачи (period_us = 0). Следующий срок отсчитывается от
+// предыдущего, а не от момента запуска, поэтому период не плывёт.
+//
+// Вытеснения нет, но долгая задача (рендер) может звать sched_yield()
+// между примитивами: там отрабатывают наступившие задачи выше неё по
+// приоритету. Задачи, вызванные из sched_yield, не должны трогать то,
+// что прерванная задача держит открытым (окно дисплея и т.п.).
+
+typedef struct {
+  void (*run)(void);
+  uint32_t period_us; // 0 — фоновая задача, без срока
+
+  // Статистика, обновляет планировщик
+  uint32_t next_us;  // следующий срок
+  uint32_t worst_us; // наибольшее время выполнения без вложенных задач
+  uint16_t runs;
+  uint16_t overruns; // сроков пропущено целиком: задача опоздала на период
+} SchedTask;
+
+// tasks живут всё время работы; первый запуск — сразу
+void sched_init(SchedTask *tasks, uint8_t count);
+void sched_run(void);
+void sched_yield(void);
+void sched_reset_stats(void);
+
+#endif // SCHED_H
@@ -0,0 +1,470 @@
+// ./lib/screen/compositor.c
+#include "compositor.h"
+
+#include <string.h>
+
+#ifndef DISPLAY_WIDTH
+#define DISPLAY_WIDTH 160
+#endif
+#ifndef DISPLAY_HEIGHT
+#define DISPLAY_HEIGHT 128
+#endif
+
+#define TILE_W COMPOSITOR_TILE_W
+#define TILE_H COMPOSITOR_TILE_H
+#define TILES_X ((DISPLAY_WIDTH + TILE_W - 1) / TILE_W)
+#define TILES_Y ((DISPLAY_HEIGHT + TILE_H - 1) / TILE_H)
+#define TILE_COUNT (TILES_X * TILES_Y)
+#define TILE_PIXELS (TILE_W * TILE_H)
+
+#if TILE_COUNT > 255
+#error "Слишком много плиток: увеличь COMPOSITOR_TILE_W/H"
+#endif
+// Координаты примитивов — в байте
+#if DISPLAY_WIDTH > 256 || DISPLAY_HEIGHT > 256
+#error "Компоновщик рассчитан на экраны до 256×256"
+#endif
+
+// CASET + RASET + RAMWR без попадания в кэш окна драйвера
+#define WINDOW_BYTES 11
+
+extern const Screen COMPOSITOR_BACKEND;
+#define backend (&COMPOSITOR_BACKEND)
+
+enum { OP_FILL, OP_LINE };
+
+typedef struct {
+    uint8_t type;
+    uint16_t color;
+    uint8_t x0, y0, x1, y1; // FILL — включительный прямоугольник, LINE — отсечённые концы
+} Op;
+
+static Op ops[COMPOSITOR_MAX_OPS];
+static uint8_t op_count = 0;
+// До present примитивы идут прямо в бэкенд: после clear или переполнения
+static bool direct = false;
+
+// Что уже в панели: последние отправленные примитивы по порядку. Пиксель,
+// накрытый ими, показывает цвет последнего из накрывших. Старые
+// вытесняются с начала — это только сужает знание, не портит его.
+static Op hist[COMPOSITOR_HISTORY];
+static uint8_t hist_count = 0;
+
+static uint8_t dirty[(TILE_COUNT + 7) / 8];
+
+static uint16_t tile_px[TILE_PIXELS];
+static uint8_t tile_mask[TILE_PIXELS / 8]; // пиксель нарисован в кадре
+static uint8_t tile_same[TILE_PIXELS / 8]; // и панель уже показывает его цвет
+
+static CompositorStats frame_stats;
+static CompositorStats last_stats;
+
+static inline uint16_t rgb565(const Color* c) {
+    return ((c->red & 0xF8) << 8) | ((c->green & 0xFC) << 3) | (c->blue >> 3);
+}
+
+// Обратно без потерь: rgb565 от результата — тот же цвет
+static inline Color color_of(uint16_t c) {
+    return make_color((c >> 8) & 0xF8, (c >> 3) & 0xFC, (c << 3) & 0xF8);
+}
+
+static inline bool bit_get(const uint8_t* bits, uint16_t i) {
+    return bits[i >> 3] & (1 << (i & 7));
+}
+
+static inline void bit_put(uint8_t* bits, uint16_t i, bool on) {
+    if (on)
+        bits[i >> 3] |= 1 << (i & 7);
+    else
+        bits[i >> 3] &= ~(1 << (i & 7));
+}
+
+static inline void mark_tile(int16_t x, int16_t y) {
+    uint8_t idx = (y / TILE_H) * TILES_X + x / TILE_W;
+    dirty[idx >> 3] |= 1 << (idx & 7);
+}
+
+static void mark_rect(int16_t x0, int16_t y0, int16_t x1, int16_t y1) {
+    for (int16_t y = y0 - y0 % TILE_H; y <= y1; y += TILE_H)
+        for (int16_t x = x0 - x0 % TILE_W; x <= x1; x += TILE_W)
+            mark_tile(x, y);
+}
+
+// --- Линии: то же отсечение и тот же Брезенхэм, что в драйверах ---
+
+static uint8_t outcode(int16_t x, int16_t y) {
+    uint8_t code = 0;
+    if (x < 0) code |= 1; else if (x >= DISPLAY_WIDTH)  code |= 2;
+    if (y < 0) code |= 4; else if (y >= DISPLAY_HEIGHT) code |= 8;
+    return code;
+}
+
+static bool clip_line(int16_t *x0, int16_t *y0, int16_t *x1, int16_t *y1) {
+    uint8_t c0 = outcode(*x0, *y0);
+    uint8_t c1 = outcode(*x1, *y1);
+
+    while (1) {
+        if (!(c0 | c1)) return true;
+        if (c0 & c1) return false;
+
+        uint8_t c = c0 ? c0 : c1;
+        int32_t dx = (int32_t)*x1 - *x0;
+        int32_t dy = (int32_t)*y1 - *y0;
+        int32_t x, y;
+
+        if (c & 8)      { y = DISPLAY_HEIGHT - 1; x = *x0 + dx * (y - *y0) / dy; }
+        else if (c & 4) { y = 0;                  x = *x0 + dx * (y - *y0) / dy; }
+        else if (c & 2) { x = DISPLAY_WIDTH - 1;  y = *y0 + dy * (x - *x0) / dx; }
+        else            { x = 0;                  y = *y0 + dy * (x - *x0) / dx; }
+
+        if (c == c0) { *x0 = x; *y0 = y; c0 = outcode(*x0, *y0); }
+        else         { *x1 = x; *y1 = y; c1 = outcode(*x1, *y1); }
+    }
+}
+
+// Пиксель примитива в плитке: PAINT рисует в буфер, SAME сверяет примитив
+// истории с нарисованным — поздний примитив истории решает за ранний
+enum { PLOT_PAINT, PLOT_SAME };
+
+static inline void plot(uint8_t mode, uint16_t i, uint16_t color) {
+    if (mode == PLOT_PAINT) {
+        tile_px[i] = color;
+        bit_put(tile_mask, i, true);
+    } else {
+        bit_put(tile_same, i, bit_get(tile_mask, i) && tile_px[i] == color);
+    }
+}
+
+// Обходит пиксели линии. Без плитки (tw == 0) только помечает плитки грязными,
+// иначе передаёт в plot пиксели плитки с началом (ox, oy).
+static void walk_line(const Op* op, int16_t ox, int16_t oy,
+                      uint8_t tw, uint8_t th, uint8_t mode) {
+    int16_t x0 = op->x0, y0 = op->y0, x1 = op->x1, y1 = op->y1;
+    int16_t dx = x1 > x0 ? x1 - x0 : x0 - x1;
+    int16_t dy = y1 > y0 ? y1 - y0 : y0 - y1;
+    int16_t sx = x0 < x1 ? 1 : -1;
+    int16_t sy = y0 < y1 ? 1 : -1;
+    int16_t err = dx - dy;
+
+    while (1) {
+        if (!tw) {
+            mark_tile(x0, y0);
+        } else {
+            int16_t lx = x0 - ox, ly = y0 - oy;
+            if (lx >= 0 && lx < tw && ly >= 0 && ly < th)
+                plot(mode, ly * TILE_W + lx, op->color);
+        }
+        if (x0 == x1 && y0 == y1) break;
+        int16_t e2 = 2 * err;
+        if (e2 > -dy) { err -= dy; x0 += sx; }
+        if (e2 <  dx) { err += dx; y0 += sy; }
+    }
+}
+
+// Рамка примитива, включительно
+static void op_box(const Op* op,
+                   uint8_t* x0, uint8_t* y0, uint8_t* x1, uint8_t* y1) {
+    *x0 = op->x0 < op->x1 ? op->x0 : op->x1;
+    *x1 = op->x0 < op->x1 ? op->x1 : op->x0;
+    *y0 = op->y0 < op->y1 ? op->y0 : op->y1;
+    *y1 = op->y0 < op->y1 ? op->y1 : op->y0;
+}
+
+static bool ops_overlap(const Op* a, const Op* b) {
+    uint8_t ax0, ay0, ax1, ay1, bx0, by0, bx1, by1;
+    op_box(a, &ax0, &ay0, &ax1, &ay1);
+    op_box(b, &bx0, &by0, &bx1, &by1);
+    return ax0 <= bx1 && bx0 <= ax1 && ay0 <= by1 && by0 <= ay1;
+}
+
+// --- История панели ---
+
+static void remember(const Op* op) {
+    if (hist_count == COMPOSITOR_HISTORY) {
+        memmove(hist, hist + 1, sizeof(hist) - sizeof(hist[0]));
+        hist_count--;
+    }
+    hist[hist_count++] = *op;
+}
+
+// Прямо в бэкенд, как нарисовал бы он сам; панель после этого известна
+static void draw_direct(const Op* op) {
+    Color color = color_of(op->color);
+    if (op->type == OP_FILL) {
+        backend->fill_rect(op->x0, op->y0,
+                           op->x1 - op->x0 + 1, op->y1 - op->y0 + 1, &color);
+    } else {
+        Point2D p1 = make_point(op->x0, op->y0);
+        Point2D p2 = make_point(op->x1, op->y1);
+        backend->draw_line(&p1, &p2, &color);
+    }
+    remember(op);
+}
+
+// --- Сборка и отправка плиток ---
+
+// Пиксели примитива в плитке (ox, oy) размером tw×th — в plot
+static void compose_op(const Op* op, int16_t ox, int16_t oy,
+                       uint8_t tw, uint8_t th, uint8_t mode) {
+    uint8_t bx0, by0, bx1, by1;
+    op_box(op, &bx0, &by0, &bx1, &by1);
+    int16_t x0 = bx0 - ox, x1 = bx1 - ox;
+    int16_t y0 = by0 - oy, y1 = by1 - oy;
+    if (x1 < 0 || y1 < 0 || x0 >= tw || y0 >= th) return;
+
+    if (op->type == OP_LINE) {
+        walk_line(op, ox, oy, tw, th, mode);
+        return;
+    }
+
+    if (x0 < 0) x0 = 0;
+    if (y0 < 0) y0 = 0;
+    if (x1 >= tw) x1 = tw - 1;
+    if (y1 >= th) y1 = th - 1;
+    for (int16_t y = y0; y <= y1; y++)
+        for (int16_t x = x0; x <= x1; x++)
+            plot(mode, y * TILE_W + x, op->color);
+}
+
+// Пиксель нужно отправить: нарисован в кадре, а панель показывает не его
+static inline bool changed(uint16_t i) {
+    return bit_get(tile_mask, i) && !bit_get(tile_same, i);
+}
+
+// Серии изменённых пикселей строки y в bx0..bx1. Разрыв из нарисованных
+// пикселей короче нового окна перекрывается: их цвет известен. send —
+// отправить, иначе только посчитать байты.
+static uint16_t push_row(int16_t ox, int16_t oy, uint8_t y,
+                         uint8_t bx0, uint8_t bx1, bool send) {
+    uint16_t bytes = 0;
+    uint8_t x = bx0;
+    while (x <= bx1) {
+        if (!changed(y * TILE_W + x)) { x++; continue; }
+        uint8_t start = x, end = x; // end — за последним изменённым
+        while (x <= bx1 && bit_get(tile_mask, y * TILE_W + x)) {
+            if (changed(y * TILE_W + x)) end = x + 1;
+            else if (2 * (x + 1 - end) >= WINDOW_BYTES) break;
+            x++;
+        }
+        x = end;
+        if (send) {
+            backend->blit(ox + start, oy + y, end - start, 1,
+                          &tile_px[y * TILE_W + start]);
+            frame_stats.windows++;
+        }
+        bytes += WINDOW_BYTES + 2u * (end - start);
+    }
+    return bytes;
+}
+
+static void push_tile(int16_t ox, int16_t oy, uint8_t bx0, uint8_t by0,
+                      uint8_t bx1, uint8_t by1, bool solid) {
+    uint8_t bw = bx1 - bx0 + 1;
+    uint8_t bh = by1 - by0 + 1;
+
+    uint16_t rows = 0;
+    for (uint8_t y = by0; y <= by1; y++)
+        rows += push_row(ox, oy, y, bx0, bx1, false);
+
+    if (solid && WINDOW_BYTES + 2u * bw * bh <= rows) {
+        // Рамка изменений нарисована целиком: ужимаем строки к началу
+        // буфера и одним окном
+        for (uint8_t r = 0; r < bh; r++)
+            memmove(&tile_px[r * bw],
+                    &tile_px[(by0 + r) * TILE_W + bx0], bw * 2);
+        backend->blit(ox + bx0, oy + by0, bw, bh, tile_px);
+        frame_stats.windows++;
+        frame_stats.bytes += WINDOW_BYTES + 2u * bw * bh;
+        return;
+    }
+
+    // Иначе — серии по строкам; ненарисованное не трогаем
+    for (uint8_t y = by0; y <= by1; y++)
+        push_row(ox, oy, y, bx0, bx1, true);
+    frame_stats.bytes += rows;
+}
+
+static void compose_tile(uint8_t idx) {
+    int16_t ox = (idx % TILES_X) * TILE_W;
+    int16_t oy = (idx / TILES_X) * TILE_H;
+    uint8_t tw = (DISPLAY_WIDTH - ox < TILE_W) ? DISPLAY_WIDTH - ox : TILE_W;
+    uint8_t th = (DISPLAY_HEIGHT - oy < TILE_H) ? DISPLAY_HEIGHT - oy : TILE_H;
+
+    memset(tile_mask, 0, sizeof(tile_mask));
+    memset(tile_same, 0, sizeof(tile_same));
+
+    // Примитивы в порядке вызова: поздний перекрывает ранний
+    for (uint8_t k = 0; k < op_count; k++)
+        compose_op(&ops[k], ox, oy, tw, th, PLOT_PAINT);
+    // Что из нарисованного панель уже показывает
+    for (uint8_t k = 0; k < hist_count; k++)
+        compose_op(&hist[k], ox, oy, tw, th, PLOT_SAME);
+
+    // Рамка изменений; целиком ли она нарисована
+    uint8_t bx0 = TILE_W, by0 = TILE_H, bx1 = 0, by1 = 0;
+    for (uint8_t y = 0; y < th; y++) {
+        for (uint8_t x = 0; x < tw; x++) {
+            uint16_t i = y * TILE_W + x;
+            if (bit_get(tile_same, i))
+                frame_stats.pixels_same++;
+            if (changed(i)) {
+                if (x < bx0) bx0 = x;
+                if (x > bx1) bx1 = x;
+                if (y < by0) by0 = y;
+                by1 = y;
+            }
+        }
+    }
+    if (bx0 > bx1) return;
+    frame_stats.tiles_sent++;
+
+    bool solid = true;
+    for (uint8_t y = by0; y <= by1 && solid; y++)
+        for (uint8_t x = bx0; x <= bx1 && solid; x++)
+            solid = bit_get(tile_mask, y * TILE_W + x);
+    push_tile(ox, oy, bx0, by0, bx1, by1, solid);
+}
+
+static void compose_dirty(void) {
+    if (op_count > frame_stats.ops_max)
+        frame_stats.ops_max = op_count;
+
+    // Примитив, который не задевает ни другие примитивы кадра, ни
+    // известное в панели, собирать не из чего: он уходит напрямую, одним
+    // окном, а не кусками по плиткам
+    uint8_t n = 0;
+    for (uint8_t k = 0; k < op_count; k++) {
+        bool alone = true;
+        for (uint8_t j = 0; j < op_count && alone; j++)
+            alone = j == k || !ops_overlap(&ops[k], &ops[j]);
+        for (uint8_t j = 0; j < hist_count && alone; j++)
+            alone = !ops_overlap(&ops[k], &hist[j]);
+        if (alone) {
+            draw_direct(&ops[k]);
+            frame_stats.ops_direct++;
+        } else {
+            ops[n++] = ops[k];
+        }
+    }
+    op_count = n;
+
+    for (uint8_t k = 0; k < op_count; k++) {
+        const Op* op = &ops[k];
+        if (op->type == OP_LINE)
+            walk_line(op, 0, 0, 0, 0, PLOT_PAINT);
+        else
+            mark_rect(op->x0, op->y0, op->x1, op->y1);
+    }
+    for (uint8_t idx = 0; idx < TILE_COUNT; idx++) {
+        if (dirty[idx >> 3] & (1 << (idx & 7))) {
+            frame_stats.tiles_dirty++;
+            compose_tile(idx);
+        }
+    }
+    // Теперь панель показывает собранное
+    for (uint8_t k = 0; k < op_count; k++)
+        remember(&ops[k]);
+    memset(dirty, 0, sizeof(dirty));
+    op_count = 0;
+}
+
+// В список кадра; после clear или переполнения — сразу в бэкенд
+static void submit(uint8_t type, uint16_t color, int16_t x0, int16_t y0, int16_t x1, int16_t y1) {
+    if (!direct && op_count == COMPOSITOR_MAX_OPS) {
+        // Накопленное уходит один раз, остаток кадра — напрямую
+        compose_dirty();
+        direct = true;
+        frame_stats.overflows++;
+    }
+
+    Op op = {type, color, x0, y0, x1, y1};
+    if (direct)
+        draw_direct(&op);
+    else
+        ops[op_count++] = op;
+}
+
+// --- Реализация Screen ---
+
+static void fill_rect_impl(uint16_t x, uint16_t y, uint16_t w, uint16_t h, const Color* color) {
+    if (x >= DISPLAY_WIDTH || y >= DISPLAY_HEIGHT || w == 0 || h == 0) return;
+    int16_t x1 = (x + w > DISPLAY_WIDTH) ? DISPLAY_WIDTH - 1 : x + w - 1;
+    int16_t y1 = (y + h > DISPLAY_HEIGHT) ? DISPLAY_HEIGHT - 1 : y + h - 1;
+    submit(OP_FILL, rgb565(color), x, y, x1, y1);
+}
+
+static void draw_hline_impl(uint16_t x, uint16_t y, uint16_t w, const Color* color) {
+    fill_rect_impl(x, y, w, 1, color);
+}
+
+static void draw_vline_impl(uint16_t x, uint16_t y, uint16_t h, const Color* color) {
+    fill_rect_impl(x, y, 1, h, color);
+}
+
+static void draw_line_impl(const Point2D* p1, const Point2D* p2, const Color* color) {
+    int16_t x0 = p1->x, y0 = p1->y, x1 = p2->x, y1 = p2->y;
+    if (!clip_line(&x0, &y0, &x1, &y1)) return;
+    submit(OP_LINE, rgb565(color), x0, y0, x1, y1);
+}
+
+static void draw_string_impl(uint16_t x, uint16_t y, const char* str, const Color* color, uint8_t scale) {
+    compose_dirty();
+    backend->draw_string(x, y, str, color, scale);
+    // Куда лягут глифы, знает только бэкенд (size 1 зеркалится)
+    hist_count = 0;
+}
+
+static void clear_impl(const Color* color) {
+    // Всё накопленное всё равно будет закрашено; на чистом экране
+    // кадр рисуется напрямую
+    op_count = 0;
+    memset(dirty, 0, sizeof(dirty));
+    direct = true;
+    backend->clear(color);
+    hist_count = 0;
+    Op all = {OP_FILL, rgb565(color),
+              0, 0, DISPLAY_WIDTH - 1, DISPLAY_HEIGHT - 1};
+    remember(&all);
+}
+
+#if COMPOSITOR_BACKEND_SCROLL
+static void scroll_impl(uint16_t line) {
+    // Прокрутка не трогает память кадра: накопленное — до неё. Строки
+    // экрана и памяти после неё не совпадают — историю забываем
+    compose_dirty();
+    backend->scroll(line);
+    hist_count = 0;
+}
+#endif
+
+static void present_impl(void) {
+    compose_dirty();
+    direct = false;
+    last_stats = frame_stats;
+    memset(&frame_stats, 0, sizeof(frame_stats));
+}
+
+// Шину ведёт бэкенд: плитки уходят в него в present()
+static const ScreenTraffic* traffic_impl(void) {
+    return backend->traffic ? backend->traffic() : NULL;
+}
+
+const CompositorStats* compositor_stats(void) {
+    return &last_stats;
+}
+
+const Screen COMPOSITOR_SCREEN = {
+    .width = DISPLAY_WIDTH,
+    .height = DISPLAY_HEIGHT,
+    .fill_rect = fill_rect_impl,
+    .draw_line = draw_line_impl,
+    .draw_hline = draw_hline_impl,
+    .draw_vline = draw_vline_impl,
+    .draw_string = draw_string_impl,
+    .clear = clear_impl,
+    .present = present_impl,
+#if COMPOSITOR_BACKEND_SCROLL
+    .scroll = scroll_impl,
+#endif
+    .traffic = traffic_impl,
+};
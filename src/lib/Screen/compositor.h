@@ -0,0 +1,76 @@
+// ./lib/screen/compositor.h
+#ifndef COMPOSITOR_H
+#define COMPOSITOR_H
+
+#include "screen.h"
+
+// Компоновщик поверх Screen: примитивы кадра копятся в списке, экран
+// делится на плитки, и в present() каждая затронутая плитка собирается
+// в RAM. Уходят только изменённые пиксели: компоновщик помнит последние
+// отправленные примитивы (историю) и не шлёт пиксель, который панель уже
+// показывает тем же цветом, — стирание старой полосы и новая полоса на
+// её месте дают в панель одну разницу. Изменённое уходит одним окном на
+// плитку или сериями по строкам — что дешевле по байтам SPI.
+//
+// Примитив, который не задевает ни другие примитивы кадра, ни историю,
+// собирать не из чего: он уходит в бэкенд напрямую, как без компоновщика.
+//
+// Пиксели, которые в кадре никто не рисовал, не трогаются — поэтому
+// результат совпадает с прямым рисованием.
+//
+// draw_string и clear рисуются напрямую: перед ними накопленное
+// выталкивается. После clear до конца кадра примитивы тоже идут прямо
+// в панель: на чистом экране нечему мерцать, а первый кадр режима
+// (шкала целиком) в список не влез бы. Где лягут глифы, знает только
+// бэкенд, поэтому draw_string и scroll обнуляют историю.
+
+// Размер плитки: 16×16×2 = 512 байт RAM
+#ifndef COMPOSITOR_TILE_W
+#define COMPOSITOR_TILE_W 16
+#endif
+#ifndef COMPOSITOR_TILE_H
+#define COMPOSITOR_TILE_H 16
+#endif
+
+// Примитивов между сборками (present, draw_string) — 7 байт на каждый.
+// Переполнение кадр не делит на куски: накопленное уходит один раз, и
+// до present кадр рисуется напрямую, как без компоновщика. Такие кадры
+// считает overflows, make native на них падает — рендер дерева в
+// список укладывается.
+#ifndef COMPOSITOR_MAX_OPS
+#define COMPOSITOR_MAX_OPS 12
+#endif
+
+// Примитивов в истории — 7 байт на каждый. Старые вытесняются: меньше
+// история — меньше пикселей узнаётся, результат от этого не меняется.
+#ifndef COMPOSITOR_HISTORY
+#define COMPOSITOR_HISTORY COMPOSITOR_MAX_OPS
+#endif
+
+// Экран, который получает собранные плитки
+#ifndef COMPOSITOR_BACKEND
+#define COMPOSITOR_BACKEND ST7735S_SCREEN
+#endif
+
+// 1 — у бэкенда есть Screen.scroll, и компоновщик его пробрасывает
+#ifndef COMPOSITOR_BACKEND_SCROLL
+#define COMPOSITOR_BACKEND_SCROLL 0
+#endif
+
+typedef struct {
+    uint8_t tiles_dirty;   // плиток затронуто примитивами
+    uint8_t tiles_sent;    // из них с изменёнными пикселями
+    uint8_t ops_direct;    // примитивов ушло напрямую, без сборки
+    uint16_t pixels_same;  // пикселей не отправлено: панель их уже показывает
+    uint8_t ops_max;       // наибольший список примитивов за кадр
+    uint8_t overflows;     // примитивов не влезло в список
+    uint16_t windows;      // адресных окон
+    uint32_t bytes;        // байт SPI (окно считается по полной цене)
+} CompositorStats;
+
+extern const Screen COMPOSITOR_SCREEN;
+
+// Статистика последнего завершённого кадра
+const CompositorStats* compositor_stats(void);
+
+#endif // COMPOSITOR_H
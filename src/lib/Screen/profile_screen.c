@@ -0,0 +1,229 @@
+// ./lib/screen/profile_screen.c
+#include "profile_screen.h"
+#include "../Print/print.h"
+
+#include <string.h>
+
+#ifndef DISPLAY_WIDTH
+#define DISPLAY_WIDTH 160
+#endif
+#ifndef DISPLAY_HEIGHT
+#define DISPLAY_HEIGHT 128
+#endif
+
+#ifndef PROFILE_BACKEND_SCROLL
+#define PROFILE_BACKEND_SCROLL 0
+#endif
+
+extern const Screen PROFILE_BACKEND;
+#define backend (&PROFILE_BACKEND)
+
+static uint8_t section = PROFILE_OTHER;
+// С прошлого отчёта, по секциям
+static ProfileCounters sums[PROFILE_SECTIONS];
+static uint16_t frames = 0;
+// Текущий и последний кадр целиком
+static ProfileCounters frame;
+static ProfileCounters last_frame;
+
+static const char name_other[] PROGMEM = "other";
+static const char name_roll_ui[] PROGMEM = "roll_ui";
+static const char name_roll_line[] PROGMEM = "roll_line";
+static const char name_pitch_ui[] PROGMEM = "pitch_ui";
+static const char name_sky_ground[] PROGMEM = "sky_ground";
+static const char name_pitch_scroll[] PROGMEM = "pitch_scroll";
+static const char name_pitch_symbol[] PROGMEM = "pitch_symbol";
+static const char name_present[] PROGMEM = "present";
+
+static const char* const names[PROFILE_SECTIONS] PROGMEM = {
+    name_other, name_roll_ui, name_roll_line, name_pitch_ui,
+    name_sky_ground, name_pitch_scroll, name_pitch_symbol, name_present,
+};
+
+uint8_t profile_enter(uint8_t s) {
+    uint8_t prev = section;
+    section = s;
+    return prev;
+}
+
+void profile_leave(uint8_t* prev) {
+    section = *prev;
+}
+
+// --- Учёт вызова: приращение счётчиков бэкенда за вызов ---
+
+static ScreenTraffic before;
+
+static void begin(void) {
+    if (backend->traffic)
+        before = *backend->traffic();
+}
+
+static void add_bus(ScreenTraffic* acc, const ScreenTraffic* now) {
+    acc->windows += now->windows - before.windows;
+    acc->cs_frames += now->cs_frames - before.cs_frames;
+    acc->cmd_bytes += now->cmd_bytes - before.cmd_bytes;
+    acc->arg_bytes += now->arg_bytes - before.arg_bytes;
+    acc->pixel_bytes += now->pixel_bytes - before.pixel_bytes;
+}
+
+static void end(void) {
+    sums[section].prims++;
+    frame.prims++;
+    if (!backend->traffic)
+        return;
+    const ScreenTraffic* now = backend->traffic();
+    add_bus(&sums[section].bus, now);
+    add_bus(&frame.bus, now);
+}
+
+// --- Screen ---
+
+static void fill_rect_impl(uint16_t x, uint16_t y, uint16_t w, uint16_t h, const Color* color) {
+    begin();
+    backend->fill_rect(x, y, w, h, color);
+    end();
+}
+
+static void draw_line_impl(const Point2D* p1, const Point2D* p2, const Color* color) {
+    begin();
+    backend->draw_line(p1, p2, color);
+    end();
+}
+
+static void draw_hline_impl(uint16_t x, uint16_t y, uint16_t w, const Color* color) {
+    begin();
+    backend->draw_hline(x, y, w, color);
+    end();
+}
+
+static void draw_vline_impl(uint16_t x, uint16_t y, uint16_t h, const Color* color) {
+    begin();
+    backend->draw_vline(x, y, h, color);
+    end();
+}
+
+static void draw_string_impl(uint16_t x, uint16_t y, const char* str, const Color* color, uint8_t scale) {
+    begin();
+    backend->draw_string(x, y, str, color, scale);
+    end();
+}
+
+static void clear_impl(const Color* color) {
+    begin();
+    backend->clear(color);
+    end();
+}
+
+#if PROFILE_BACKEND_SCROLL
+static void scroll_impl(uint16_t line) {
+    begin();
+    backend->scroll(line);
+    end();
+}
+#endif
+
+// Граница кадра: досылка бэкенда и итог кадра
+static void present_impl(void) {
+    if (backend->present) {
+        PROFILE_SECTION(PROFILE_PRESENT);
+        begin();
+        backend->present();
+        end();
+    }
+    last_frame = frame;
+    memset(&frame, 0, sizeof(frame));
+    frames++;
+}
+
+static const ScreenTraffic* traffic_impl(void) {
+    return backend->traffic ? backend->traffic() : NULL;
+}
+
+const Screen PROFILE_SCREEN = {
+    .width = DISPLAY_WIDTH,
+    .height = DISPLAY_HEIGHT,
+    .fill_rect = fill_rect_impl,
+    .draw_line = draw_line_impl,
+    .draw_hline = draw_hline_impl,
+    .draw_vline = draw_vline_impl,
+    .draw_string = draw_string_impl,
+    .clear = clear_impl,
+    .present = present_impl,
+#if PROFILE_BACKEND_SCROLL
+    .scroll = scroll_impl,
+#endif
+    .traffic = traffic_impl,
+};
+
+const ProfileCounters* profile_last_frame(void) {
+    return &last_frame;
+}
+
+uint16_t profile_frames(void) {
+    return frames;
+}
+
+// --- Отчёт ---
+
+static void print_field(void (*put)(uint8_t), const char* key, uint32_t v) {
+    put(' ');
+    print_str_P(put, key);
+    put('=');
+    print_u32(put, v);
+}
+
+// Среднее за кадр с округлением
+static uint32_t per_frame(uint32_t v) {
+    return (v + frames / 2) / frames;
+}
+
+// Строка «prof <имя> prim=… win=… cs=… cmd=… arg=… px=… bytes=… us=…»,
+// средние за кадр
+static void print_line(void (*put)(uint8_t), const char* name, const ProfileCounters* c) {
+    const ScreenTraffic* b = &c->bus;
+    uint32_t bytes = per_frame(b->cmd_bytes + b->arg_bytes + b->pixel_bytes);
+
+    print_str_P(put, PSTR("prof "));
+    print_str_P(put, name);
+    print_field(put, PSTR("prim"), per_frame(c->prims));
+    print_field(put, PSTR("win"), per_frame(b->windows));
+    print_field(put, PSTR("cs"), per_frame(b->cs_frames));
+    print_field(put, PSTR("cmd"), per_frame(b->cmd_bytes));
+    print_field(put, PSTR("arg"), per_frame(b->arg_bytes));
+    print_field(put, PSTR("px"), per_frame(b->pixel_bytes));
+    print_field(put, PSTR("bytes"), bytes);
+    // 8 бит на байт; в 32 битах до ~500 КБ за кадр
+    print_field(put, PSTR("us"), bytes * 8000UL / (PROFILE_SPI_HZ / 1000UL));
+    put('\r');
+    put('\n');
+}
+
+void profile_report(void (*put)(uint8_t)) {
+    if (!frames)
+        return;
+
+    print_str_P(put, PSTR("prof frames"));
+    print_field(put, PSTR("n"), frames);
+    print_field(put, PSTR("sck_khz"), PROFILE_SPI_HZ / 1000UL);
+    put('\r');
+    put('\n');
+
+    ProfileCounters total;
+    memset(&total, 0, sizeof(total));
+    for (uint8_t i = 0; i < PROFILE_SECTIONS; i++) {
+        const ProfileCounters* c = &sums[i];
+        total.prims += c->prims;
+        total.bus.windows += c->bus.windows;
+        total.bus.cs_frames += c->bus.cs_frames;
+        total.bus.cmd_bytes += c->bus.cmd_bytes;
+        total.bus.arg_bytes += c->bus.arg_bytes;
+        total.bus.pixel_bytes += c->bus.pixel_bytes;
+        if (c->prims)
+            print_line(put, (const char*)pgm_read_ptr(&names[i]), c);
+    }
+    print_line(put, PSTR("frame"), &total);
+
+    memset(sums, 0, sizeof(sums));
+    frames = 0;
+}
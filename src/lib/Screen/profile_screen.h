@@ -0,0 +1,67 @@
+// ./lib/screen/profile_screen.h
+#ifndef PROFILE_SCREEN_H
+#define PROFILE_SCREEN_H
+
+#include "screen.h"
+
+// Профилировщик поверх Screen: сколько стоит кадр на шине дисплея и кто
+// из рендера эти байты нарисовал. Каждый вызов пропускается в
+// PROFILE_BACKEND, а приращение его Screen.traffic относится к текущей
+// секции — функции рендера, отмеченной PROFILE_SECTION. Без traffic у
+// бэкенда считаются только вызовы.
+//
+// Поверх компоновщика байты уходят в present() — они в секции present.
+//
+// profile_report печатает средние за кадр с прошлого отчёта и время на
+// шине при PROFILE_SPI_HZ: это нижняя граница, без накладных расходов
+// процессора между байтами.
+
+#ifndef PROFILE_BACKEND
+#if defined(SCREEN_COMPOSITOR)
+#define PROFILE_BACKEND COMPOSITOR_SCREEN
+#else
+#define PROFILE_BACKEND ST7735S_SCREEN
+#endif
+#endif
+
+// Частота SCK — та, что ставит драйвер панели: F_CPU/2, с DISPLAY_ASYNC —
+// делитель очереди SPI (по умолчанию F_CPU/8)
+#ifndef PROFILE_SPI_HZ
+#include "../ST7735S/ST7735S.h"
+#define PROFILE_SPI_HZ ST7735S_SCK_HZ
+#endif
+
+typedef enum {
+    PROFILE_OTHER = 0,    // вне отмеченных функций: clear при смене режима
+    PROFILE_ROLL_UI,      // draw_roll_ui: дуга, штрихи, подписи
+    PROFILE_ROLL_LINE,    // draw_roll_mode: стирание и линия крена
+    PROFILE_PITCH_UI,     // draw_pitch_ui_full: шкала тангажа
+    PROFILE_SKY_GROUND,   // update_sky_ground: небо и земля
+    PROFILE_PITCH_SCROLL, // pitch_paint_world: открывшиеся строки
+    PROFILE_PITCH_SYMBOL, // draw_pitch_mode: символ самолёта, прокрутка
+    PROFILE_PRESENT,      // present() бэкенда
+    PROFILE_SECTIONS
+} ProfileSection;
+
+typedef struct {
+    uint32_t prims; // вызовов Screen
+    ScreenTraffic bus;
+} ProfileCounters;
+
+extern const Screen PROFILE_SCREEN;
+
+// Секция до конца охватывающего блока; вложенная возвращает внешнюю
+#define PROFILE_SECTION(s) \
+    uint8_t _profile_prev __attribute__((cleanup(profile_leave))) = profile_enter(s)
+
+uint8_t profile_enter(uint8_t section);
+void profile_leave(uint8_t* prev);
+
+// Итог последнего кадра (по present) по всем секциям
+const ProfileCounters* profile_last_frame(void);
+// Кадров с прошлого отчёта
+uint16_t profile_frames(void);
+// Отчёт текстом через put: строка на секцию и итог, потом счёт заново
+void profile_report(void (*put)(uint8_t c));
+
+#endif // PROFILE_SCREEN_H
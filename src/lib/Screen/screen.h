@@ -14,6 +14,15 @@ typedef struct {
     int16_t x, y;
 } Point2D;
 
+// Счётчики шины дисплея с момента старта (только растут)
+typedef struct {
+    uint32_t windows;     // установок адресного окна (RAMWR)
+    uint32_t cs_frames;   // опусканий CS
+    uint32_t cmd_bytes;   // байт команд (DC = 0)
+    uint32_t arg_bytes;   // байт аргументов команд
+    uint32_t pixel_bytes; // байт пикселей после RAMWR
+} ScreenTraffic;
+
 typedef struct {
     uint16_t width;
     uint16_t height;
@@ -24,6 +33,18 @@ typedef struct {
     void (*draw_vline)(uint16_t x, uint16_t y, uint16_t h, const Color* color);
     void (*draw_string)(uint16_t x, uint16_t y, const char* str, const Color* color, uint8_t scale);
     void (*clear)(const Color* color);
+
+    // Необязательные (могут быть NULL)
+    // Блок пикселей RGB565 построчно, w*h штук
+    void (*blit)(uint16_t x, uint16_t y, uint16_t w, uint16_t h, const uint16_t* pixels);
+    // Конец кадра: буферизующие экраны выталкивают накопленное
+    void (*present)(void);
+    // Аппаратная прокрутка по Y: строка экрана 0 показывает строку line,
+    // ниже — следующие по кольцу из height строк. Рисование по-прежнему
+    // адресует строки памяти. NULL, если ориентация панели не позволяет.
+    void (*scroll)(uint16_t line);
+    // Счётчики шины для профилировщика. NULL, если экран их не ведёт.
+    const ScreenTraffic* (*traffic)(void);
 } Screen;
 
 static inline Point2D make_point(int16_t x, int16_t y) {
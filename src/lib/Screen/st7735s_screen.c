@@ -32,6 +32,35 @@ static void clear_impl(const Color* color) {
     st7735s_fill_screen(rgb565(color));
 }
 
+static void blit_impl(uint16_t x, uint16_t y, uint16_t w, uint16_t h, const uint16_t* pixels) {
+    st7735s_draw_bitmap(x, y, w, h, pixels);
+}
+
+#if ST7735S_CAN_SCROLL
+static void scroll_impl(uint16_t line) {
+    static bool defined = false;
+    if (!defined) {
+        // Прокручиваются только видимые строки, остаток памяти — снизу
+        st7735s_scroll_define(0, DISPLAY_HEIGHT, ST7735S_GRAM_LINES - 0 - DISPLAY_HEIGHT);
+        defined = true;
+    }
+    st7735s_scroll_start(0 + line % DISPLAY_HEIGHT);
+}
+#endif
+
+#ifdef ST7735S_PROFILE
+static const ScreenTraffic* traffic_impl(void) {
+    static ScreenTraffic t;
+    const St7735sTraffic* d = st7735s_traffic();
+    t.windows = d->windows;
+    t.cs_frames = d->cs_frames;
+    t.cmd_bytes = d->cmd_bytes;
+    t.arg_bytes = d->arg_bytes;
+    t.pixel_bytes = d->pixel_bytes;
+    return &t;
+}
+#endif
+
 // Глобальный объект экрана (готов к использованию)
 const Screen ST7735S_SCREEN = {
     .width = DISPLAY_WIDTH,
@@ -41,5 +70,12 @@ const Screen ST7735S_SCREEN = {
     .draw_hline = draw_hline_impl,
     .draw_vline = draw_vline_impl,
     .draw_string = draw_string_impl,
-    .clear = clear_impl
+    .clear = clear_impl,
+    .blit = blit_impl,
+#if ST7735S_CAN_SCROLL
+    .scroll = scroll_impl,
+#endif
+#ifdef ST7735S_PROFILE
+    .traffic = traffic_impl,
+#endif
 };
\ No newline at end of file
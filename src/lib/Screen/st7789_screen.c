@@ -32,6 +32,22 @@ static void clear_impl(const Color* color) {
     st7789_fill_screen(rgb565(color));
 }
 
+static void blit_impl(uint16_t x, uint16_t y, uint16_t w, uint16_t h, const uint16_t* pixels) {
+    st7789_draw_bitmap(x, y, w, h, pixels);
+}
+
+#if ST7789_CAN_SCROLL
+static void scroll_impl(uint16_t line) {
+    static bool defined = false;
+    if (!defined) {
+        // Прокручиваются только видимые строки, остаток памяти — снизу
+        st7789_scroll_define(ROWSTART, DISPLAY_HEIGHT, ST7789_GRAM_LINES - ROWSTART - DISPLAY_HEIGHT);
+        defined = true;
+    }
+    st7789_scroll_start(ROWSTART + line % DISPLAY_HEIGHT);
+}
+#endif
+
 // Глобальный объект интерфейса экрана
 const Screen ST7789_SCREEN = {
     .width  = DISPLAY_WIDTH,
@@ -41,5 +57,9 @@ const Screen ST7789_SCREEN = {
     .draw_hline = draw_hline_impl,
     .draw_vline = draw_vline_impl,
     .draw_string = draw_string_impl,
-    .clear = clear_impl
+    .clear = clear_impl,
+    .blit = blit_impl,
+#if ST7789_CAN_SCROLL
+    .scroll = scroll_impl,
+#endif
 };
\ No newline at end of file
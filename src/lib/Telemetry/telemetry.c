@@ -0,0 +1,114 @@
+#include "telemetry.h"
+#include "../Bytes/bytes.h"
+#include "../Link/link.h"
+
+bool telemetry_add(TelemetryBatch *b, const MPU6050Sample *sample,
+                   int16_t roll, int16_t pitch) {
+  uint32_t step = 0;
+  if (b->count) {
+    step = sample->timestamp - b->last_ts;
+    if (b->count == TELEMETRY_BATCH || step > 0xFFFF)
+      return false;
+  } else {
+    put_le32(b->p + 3, sample->timestamp);
+  }
+  b->last_ts = sample->timestamp;
+  put_le16(b->p + 7, sample->temp);
+
+  uint8_t *d = b->p + TELEMETRY_HEADER_LEN + b->count * TELEMETRY_SAMPLE_LEN;
+  put_le16(d, step);
+  for (uint8_t i = 0; i < 3; i++) {
+    put_le16(d + 2 + 2 * i, sample->accel[i]);
+    put_le16(d + 8 + 2 * i, sample->gyro[i]);
+  }
+  put_le16(d + 14, roll);
+  put_le16(d + 16, pitch);
+  b->count++;
+  return true;
+}
+
+uint8_t telemetry_encode_batch(TelemetryBatch *b, uint8_t seq, uint8_t flags,
+                               uint8_t out[TELEMETRY_FRAME_MAX]) {
+  if (!b->count)
+    return 0;
+  uint8_t n = TELEMETRY_HEADER_LEN + b->count * TELEMETRY_SAMPLE_LEN;
+  b->p[0] = (TELEMETRY_TAG << 4) | (flags & ~TELEMETRY_KIND_MASK & 0x0F) |
+            TELEMETRY_SAMPLES;
+  b->p[1] = seq;
+  b->p[2] = b->count;
+  b->p[n] = link_crc8(b->p, n);
+  b->count = 0;
+  return link_cobs_encode(b->p, n + 1, out);
+}
+
+uint8_t telemetry_encode_status(const TelemetryStatus *status, uint8_t seq,
+                                uint8_t flags,
+                                uint8_t out[TELEMETRY_STATUS_FRAME_MAX]) {
+  uint8_t p[TELEMETRY_STATUS_LEN];
+  p[0] = (TELEMETRY_TAG << 4) | (flags & ~TELEMETRY_KIND_MASK & 0x0F) |
+         TELEMETRY_STATUS;
+  p[1] = seq;
+  put_le16(p + 2, status->read_errors);
+  put_le16(p + 4, status->fifo_overflows);
+  put_le16(p + 6, status->tx_replaced);
+  put_le16(p + 8, status->dropped);
+  put_le16(p + 10, status->gap_max_us);
+  for (uint8_t i = 0; i < TELEMETRY_TASKS; i++) {
+    put_le16(p + 12 + 4 * i, status->task_worst_us[i]);
+    put_le16(p + 14 + 4 * i, status->task_overruns[i]);
+  }
+  p[TELEMETRY_STATUS_LEN - 1] = link_crc8(p, TELEMETRY_STATUS_LEN - 1);
+  return link_cobs_encode(p, TELEMETRY_STATUS_LEN, out);
+}
+
+int8_t telemetry_parse(const uint8_t *payload, uint8_t n, uint8_t *seq,
+                       uint8_t *flags,
+                       TelemetrySample samples[TELEMETRY_BATCH_LIMIT],
+                       uint8_t *count, TelemetryStatus *status) {
+  if (n < 3 || (payload[0] >> 4) != TELEMETRY_TAG ||
+      payload[n - 1] != link_crc8(payload, n - 1))
+    return -1;
+  *seq = payload[1];
+  *flags = payload[0] & 0x0F & ~TELEMETRY_KIND_MASK;
+
+  if ((payload[0] & TELEMETRY_KIND_MASK) == TELEMETRY_STATUS) {
+    if (n != TELEMETRY_STATUS_LEN)
+      return -1;
+    const uint8_t *p = payload;
+    status->read_errors = get_le16(p + 2);
+    status->fifo_overflows = get_le16(p + 4);
+    status->tx_replaced = get_le16(p + 6);
+    status->dropped = get_le16(p + 8);
+    status->gap_max_us = get_le16(p + 10);
+    for (uint8_t i = 0; i < TELEMETRY_TASKS; i++) {
+      status->task_worst_us[i] = get_le16(p + 12 + 4 * i);
+      status->task_overruns[i] = get_le16(p + 14 + 4 * i);
+    }
+    return TELEMETRY_STATUS;
+  }
+
+  if ((payload[0] & TELEMETRY_KIND_MASK) != TELEMETRY_SAMPLES)
+    return -1;
+  uint8_t k = payload[2];
+  if (k == 0 || k > TELEMETRY_BATCH_LIMIT ||
+      n != TELEMETRY_HEADER_LEN + k * TELEMETRY_SAMPLE_LEN + 1)
+    return -1;
+  uint32_t t = get_le32(payload + 3);
+  int16_t temp = get_le16(payload + 7);
+  for (uint8_t j = 0; j < k; j++) {
+    const uint8_t *d =
+        payload + TELEMETRY_HEADER_LEN + j * TELEMETRY_SAMPLE_LEN;
+    TelemetrySample *s = &samples[j];
+    t += get_le16(d);
+    s->sample.timestamp = t;
+    for (uint8_t i = 0; i < 3; i++) {
+      s->sample.accel[i] = get_le16(d + 2 + 2 * i);
+      s->sample.gyro[i] = get_le16(d + 8 + 2 * i);
+    }
+    s->sample.temp = temp;
+    s->roll = get_le16(d + 14);
+    s->pitch = get_le16(d + 16);
+  }
+  *count = k;
+  return TELEMETRY_SAMPLES;
+}
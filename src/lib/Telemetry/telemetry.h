@@ -0,0 +1,105 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include "../MPU6050/MPU6050.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Телеметрия MCU1 для диагностики в поле (tools/telemetry_dump.c):
+// сырые отсчёты с углами фильтра пачками на частоте датчика и раз в
+// секунду — счётчики ошибок и времена задач. Обрамление как у канала
+// (lib/Link): COBS, разделитель 0x00, CRC-8 в конце нагрузки; MCU2 такие
+// кадры отбрасывает. Номер общий для пачек и состояния и растёт на каждый
+// кадр, в том числе не влезший в линию.
+//
+// Пачка, младший байт первым:
+//   [TELEMETRY_TAG << 4 | флаги] [номер] [отсчётов, n]
+//   [метка времени первого отсчёта, мкс, uint32] [temp последнего]
+//   n × [шаг от предыдущего, мкс, uint16] [accel X, Y, Z] [gyro X, Y, Z]
+//       [крен] [тангаж]  — 18 байт
+//   [CRC-8]
+// Отсчёт — как его видит фильтр (гироскоп без смещений), углы — двоичные,
+// после обновления этим отсчётом. Температура меняется медленно и идёт
+// одна на пачку. На линии ~21 байт на отсчёт при пачке из 4.
+//
+// Пачка собирается на месте, по отсчёту за вызов; на отправку остаются
+// CRC и COBS по готовому буферу.
+
+#define TELEMETRY_TAG 0xB // старший полубайт; у записи — RECORD_TAG
+
+// Младший полубайт: вид кадра и флаги
+#define TELEMETRY_KIND_MASK 0x03
+#define TELEMETRY_SAMPLES 0
+#define TELEMETRY_STATUS 1
+#define TELEMETRY_FIFO 0x08 // отсчёты из FIFO датчика, метки — его часы
+
+// Отсчётов в пачке: больше — меньше накладных байтов на отсчёт, но
+// длиннее кадр и задержка
+#ifndef TELEMETRY_BATCH
+#define TELEMETRY_BATCH 4
+#endif
+#define TELEMETRY_SAMPLE_LEN 18
+#define TELEMETRY_HEADER_LEN 9
+#define TELEMETRY_PAYLOAD_MAX                                                  \
+  (TELEMETRY_HEADER_LEN + TELEMETRY_BATCH * TELEMETRY_SAMPLE_LEN + 1)
+#define TELEMETRY_FRAME_MAX (TELEMETRY_PAYLOAD_MAX + 3)
+
+// Наибольшая пачка в один блок COBS (254 байта) — под неё разбор на хосте
+#define TELEMETRY_BATCH_LIMIT                                                  \
+  ((254 - TELEMETRY_HEADER_LEN - 1) / TELEMETRY_SAMPLE_LEN)
+#if TELEMETRY_BATCH > TELEMETRY_BATCH_LIMIT
+#error "TELEMETRY_BATCH too large for one COBS block"
+#endif
+
+// Задач планировщика MCU1 в кадре состояния
+#define TELEMETRY_TASKS 4
+
+// Состояние. Счётчики ошибок — с включения (16 бит по кругу), времена
+// и опоздания задач — за окно с прошлого кадра состояния.
+typedef struct {
+  uint16_t read_errors;    // сбойные чтения датчика
+  uint16_t fifo_overflows; // переполнения FIFO датчика
+  uint16_t tx_replaced;    // пакеты MCU2, заменённые до отправки
+  uint16_t dropped;        // кадры телеметрии, не влезшие в кольцо UART
+  uint16_t gap_max_us;     // наибольший шаг фильтра
+  uint16_t task_worst_us[TELEMETRY_TASKS]; // как SchedTask, до 65535
+  uint16_t task_overruns[TELEMETRY_TASKS];
+} TelemetryStatus;
+
+#define TELEMETRY_STATUS_LEN (2 + 5 * 2 + TELEMETRY_TASKS * 4 + 1)
+#define TELEMETRY_STATUS_FRAME_MAX (TELEMETRY_STATUS_LEN + 3)
+
+// Пачка в сборке
+typedef struct {
+  uint8_t p[TELEMETRY_PAYLOAD_MAX];
+  uint8_t count;
+  uint32_t last_ts;
+} TelemetryBatch;
+
+// Отсчёт в пачку; false — пачка полна или шаг не влез в 16 бит: её
+// нужно отправить и добавить отсчёт заново
+bool telemetry_add(TelemetryBatch *b, const MPU6050Sample *sample,
+                   int16_t roll, int16_t pitch);
+// Кадр из пачки с разделителем, пачка опустошается; 0 — пачка пуста
+uint8_t telemetry_encode_batch(TelemetryBatch *b, uint8_t seq, uint8_t flags,
+                               uint8_t out[TELEMETRY_FRAME_MAX]);
+uint8_t telemetry_encode_status(const TelemetryStatus *status, uint8_t seq,
+                                uint8_t flags,
+                                uint8_t out[TELEMETRY_STATUS_FRAME_MAX]);
+
+// Разбор на хосте, нагрузка после link_cobs_decode; пачка любого
+// размера до TELEMETRY_BATCH_LIMIT
+typedef struct {
+  MPU6050Sample sample;
+  int16_t roll, pitch; // двоичные углы фильтра
+} TelemetrySample;
+
+// Вид кадра или -1 для чужого и испорченного. Для пачки — отсчёты в
+// samples и их число в count, для состояния — status.
+int8_t telemetry_parse(const uint8_t *payload, uint8_t n, uint8_t *seq,
+                       uint8_t *flags,
+                       TelemetrySample samples[TELEMETRY_BATCH_LIMIT],
+                       uint8_t *count, TelemetryStatus *status);
+
+#endif // TELEMETRY_H
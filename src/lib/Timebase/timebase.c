@@ -0,0 +1,29 @@
+#include "timebase.h"
+
+#include <avr/interrupt.h>
+#include <util/atomic.h>
+
+static volatile uint32_t overflows = 0;
+
+ISR(TIMER1_OVF_vect) { overflows++; }
+
+void timebase_init(void) {
+  TCCR1A = 0;
+  TCCR1B = (1 << CS11); // обычный режим, делитель 8
+  TCNT1 = 0;
+  TIFR1 = (1 << TOV1);
+  TIMSK1 = (1 << TOIE1);
+}
+
+uint32_t timebase_micros(void) {
+  uint32_t ovf;
+  uint16_t ticks;
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    ovf = overflows;
+    ticks = TCNT1;
+    // Переполнение случилось, но прерывание ещё не обработано
+    if ((TIFR1 & (1 << TOV1)) && ticks < 0x8000)
+      ovf++;
+  }
+  return (ovf << 15) | (ticks >> 1);
+}
@@ -0,0 +1,26 @@
+#ifndef TIMEBASE_H
+#define TIMEBASE_H
+
+#include <avr/io.h>
+#include <stdint.h>
+
+// Общие часы MCU1 на Timer1: счётчик идёт свободно с делителем 8
+// (0.5 мкс на тик), переполнения досчитываются в прерывании, так что
+// timebase_micros() монотонна и переполняется раз в ~71 минуту.
+//
+// По этим часам планировщик (lib/Sched) считает сроки задач; отсюда же
+// берут время фильтр (шаг между отсчётами), антидребезг кнопки
+// и профилирование.
+
+#define TIMEBASE_TICKS_PER_US 2 // F_CPU / 8 при 16 МГц
+// Тактов CPU на тик счётчика
+#define TIMEBASE_CYCLES_PER_TICK 8
+
+void timebase_init(void);
+uint32_t timebase_micros(void);
+
+// Сырой счётчик для коротких интервалов (< 32 мс): разность
+// uint16_t-значений верна и через переполнение
+static inline uint16_t timebase_ticks(void) { return TCNT1; }
+
+#endif // TIMEBASE_H
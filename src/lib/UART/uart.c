@@ -1,25 +1,134 @@
 #include "uart.h"
+#include "../Link/link.h"
 
-void uart_init_send(void) {
-  UBRR0H = 0;
-  UBRR0L = 16;
-  UCSR0A = 0;
-  UCSR0B = (1 << TXEN0);
+#include <avr/interrupt.h>
+#include <math.h>
+#include <string.h>
+#include <util/atomic.h>
+
+#define TX_MASK (UART_TX_SIZE - 1)
+
+volatile uint16_t uart_tx_replaced = 0;
+
+static uint8_t tx_ring[UART_TX_SIZE];
+static volatile uint8_t tx_head, tx_tail;
+
+// Слот: next — ждущий пакет, cur — уходящий сейчас
+static uint8_t slot_next[UART_SLOT_SIZE], slot_cur[UART_SLOT_SIZE];
+static volatile uint8_t slot_next_len; // 0 — слот пуст
+static uint8_t slot_cur_len, slot_cur_pos;
+// С последнего uart_flush ушёл хотя бы байт: есть чего ждать по TXC
+static volatile bool tx_sent = false;
+
+void uart_set_baud(void) {
+  UBRR0H = UART_UBRR >> 8;
+  UBRR0L = UART_UBRR & 0xFF;
+  UCSR0A = UART_U2X ? (1 << U2X0) : 0;
   UCSR0C = (1 << UCSZ01) | (1 << UCSZ00);
 }
 
-void uart_init_read(void) {
-  UBRR0H = 0;
-  UBRR0L = 16;
-  UCSR0A = 0;
-  UCSR0B = (1 << RXEN0) | (1 << RXCIE0);
-  UCSR0C = (1 << UCSZ01) | (1 << UCSZ00);
+void uart_init_send(void) {
+  uart_set_baud();
+  tx_head = tx_tail = 0;
+  slot_next_len = 0;
+  slot_cur_len = slot_cur_pos = 0;
+  UCSR0B = (1 << TXEN0); // UDRIE — когда есть что слать
+}
+
+// Кольцо на границе кадров: пусто или следующий байт — разделитель 0x00.
+// Кадры записи и телеметрии (lib/Link) начинаются с нуля, внутри нулей
+// нет, так что ноль впереди значит: предыдущий кадр или текст уже ушёл.
+static bool tx_at_boundary(void) {
+  return tx_tail == tx_head || tx_ring[tx_tail] == 0x00;
+}
+
+// Следующий байт в UDR0 (UDRE уже выставлен). Пакет в передаче — до
+// конца, затем ждущий пакет, но только на границе кадров кольца, иначе
+// он разорвал бы начатый кадр кольца; затем кольцо.
+static void uart_tx_step(void) {
+  if (slot_cur_pos >= slot_cur_len && slot_next_len && tx_at_boundary()) {
+    slot_cur_len = slot_next_len;
+    memcpy(slot_cur, slot_next, slot_cur_len);
+    slot_cur_pos = 0;
+    slot_next_len = 0;
+  }
+
+  if (slot_cur_pos < slot_cur_len) {
+    UDR0 = slot_cur[slot_cur_pos++];
+  } else if (tx_tail != tx_head) {
+    UDR0 = tx_ring[tx_tail];
+    tx_tail = (tx_tail + 1) & TX_MASK;
+  } else {
+    UCSR0B &= ~(1 << UDRIE0); // нечего слать
+    return;
+  }
+  UCSR0A |= (1 << TXC0); // сброс: uart_flush ждёт конца последнего байта
+  tx_sent = true;
+}
+
+ISR(USART_UDRE_vect) { uart_tx_step(); }
+
+static void uart_kick(void) {
+  UCSR0B |= (1 << UDRIE0);
+  // Без прерываний UDRE никто не обслужит — отправляем всё сами
+  if (!(SREG & (1 << SREG_I))) {
+    while (UCSR0B & (1 << UDRIE0)) {
+      if (UCSR0A & (1 << UDRE0))
+        uart_tx_step();
+    }
+  }
+}
+
+static uint8_t tx_free(void) {
+  return (uint8_t)(tx_tail - tx_head - 1) & TX_MASK;
+}
+
+bool uart_write(const uint8_t *data, uint8_t n) {
+  if (tx_free() < n)
+    return false;
+  uint8_t head = tx_head;
+  for (uint8_t i = 0; i < n; i++) {
+    tx_ring[head] = data[i];
+    head = (head + 1) & TX_MASK;
+  }
+  tx_head = head; // прерывание видит байты только после записи
+  uart_kick();
+  return true;
 }
 
 void uart_putc(uint8_t c) {
-  while (!(UCSR0A & (1 << UDRE0)))
+  while (!uart_write(&c, 1))
+    ; // место освобождает прерывание
+}
+
+void uart_send_latest(const uint8_t *data, uint8_t n) {
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    if (slot_next_len)
+      uart_tx_replaced++;
+    memcpy(slot_next, data, n);
+    slot_next_len = n;
+  }
+  uart_kick();
+}
+
+bool uart_tx_idle(void) {
+  bool idle;
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    idle = tx_tail == tx_head && !slot_next_len &&
+           slot_cur_pos >= slot_cur_len;
+  }
+  return idle;
+}
+
+void uart_flush(void) {
+  while (UCSR0B & (1 << UDRIE0))
     ;
-  UDR0 = c;
+  // Последний байт ещё в сдвиговом регистре
+  if (tx_sent) {
+    while (!(UCSR0A & (1 << TXC0)))
+      ;
+    tx_sent = false;
+  }
 }
 
 void uart_send_float(float f) {
@@ -31,10 +140,15 @@ void uart_send_float(float f) {
     uart_putc(u.b[i]);
 }
 
+// Кадр протокола версии 2 (см. link.h); номер растёт с каждым кадром
 void send_attitude_packet(float roll, float pitch, uint8_t mode) {
-  uart_putc(0xFE); // STX
-  uart_send_float(roll);
-  uart_send_float(pitch);
-  uart_putc(mode);
-  uart_putc(0xFF); // ETX
-}
\ No newline at end of file
+  static uint8_t seq = 0;
+  LinkFrame frame = {
+      .seq = seq++,
+      .mode = mode,
+      .roll_cd = (int16_t)lroundf(roll * LINK_RAD_TO_CD),
+      .pitch_cd = (int16_t)lroundf(pitch * LINK_RAD_TO_CD),
+  };
+  uint8_t buf[LINK_FRAME_MAX];
+  uart_send_latest(buf, link_encode(&frame, buf));
+}
@@ -2,11 +2,79 @@
 #define UART_H
 
 #include <avr/io.h>
+#include <stdbool.h>
+#include <stdint.h>
 
+// Скорость канала MCU1 → MCU2. Оба МК собираются с одинаковыми
+// UART_BAUD/UART_U2X. U2X (делитель 8 вместо 16) даёт точные делители
+// на высоких скоростях: 16 МГц → 250k, 500k, 1M без ошибки.
+#ifndef UART_BAUD
+#define UART_BAUD 57600UL
+#endif
+#ifndef UART_U2X
+#define UART_U2X 0
+#endif
+
+#define UART_UBRR_DIV (UART_U2X ? 8UL : 16UL)
+#define UART_UBRR                                                              \
+  ((F_CPU + UART_UBRR_DIV * UART_BAUD / 2) / (UART_UBRR_DIV * UART_BAUD) - 1)
+#define UART_BAUD_REAL (F_CPU / (UART_UBRR_DIV * (UART_UBRR + 1)))
+
+// 57600 без U2X — 58824, +2.1%: так канал работал всегда, и обе стороны
+// ошибаются одинаково. Больше 3% — уже потери байтов.
+#if UART_BAUD_REAL * 100 > UART_BAUD * 103 ||                                  \
+    UART_BAUD_REAL * 100 < UART_BAUD * 97
+#error "UART_BAUD is not reachable from F_CPU, try UART_U2X=1"
+#endif
+
+// Передача идёт из прерывания UDRE: байты — через кольцо, пакет
+// ориентации — через отдельный слот «последнего значения». Новый пакет
+// заменяет ещё не начатый старый, так что устаревшие углы не стоят в
+// очереди за свежими; начатый пакет уходит целиком, без вставок из кольца.
+// Сам пакет тоже ждёт границы кадров кольца — нуля, с которого
+// начинается следующий кадр, или пустого кольца: ожидание не дольше
+// одного кадра кольца.
+
+// Размер кольца передачи, степень двойки
+#ifndef UART_TX_SIZE
+#define UART_TX_SIZE 32
+#endif
+// Наибольший пакет в слоте
+#define UART_SLOT_SIZE 16
+
+// Размер кольца приёма, степень двойки. 64 байта — 11 мс на 57600:
+// основной цикл должен забирать чаще.
+#ifndef UART_RX_SIZE
+#define UART_RX_SIZE 64
+#endif
+
+// Пакетов, заменённых до начала передачи
+extern volatile uint16_t uart_tx_replaced;
+// Принятых байтов, потерянных из-за полного кольца или опоздавшего
+// прерывания (DOR)
+extern volatile uint16_t uart_rx_overflows;
+
+void uart_set_baud(void);
 void uart_init_send(void);
+// Приём — в uart_rx.c: кольцо и USART_RX_vect, без ожиданий
 void uart_init_read(void);
+// Забирает до max принятых байтов, возвращает их число
+uint8_t uart_read(uint8_t *buf, uint8_t max);
+
+// Ставит байт в кольцо; если места нет — ждёт. С запрещёнными
+// прерываниями передача идёт опросом, так что работает и до sei().
 void uart_putc(uint8_t c);
+// Всё или ничего, без ожидания: false, если в кольце нет места на n байт
+bool uart_write(const uint8_t *data, uint8_t n);
+// Кладёт пакет в слот, заменяя ещё не начатый; n <= UART_SLOT_SIZE
+void uart_send_latest(const uint8_t *data, uint8_t n);
+// Линия свободна: кольцо пусто, пакет в слоте не ждёт и не уходит
+bool uart_tx_idle(void);
+// Ждёт, пока всё поставленное уйдёт на линию
+void uart_flush(void);
+
 void uart_send_float(float f);
+// Углы в радианах; кадр — в слот, см. lib/Link/link.h
 void send_attitude_packet(float roll, float pitch, uint8_t mode);
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,45 @@
+#include "uart.h"
+
+#include <avr/interrupt.h>
+
+// Приём: прерывание только кладёт байт в кольцо, разбор кадров — в
+// основном цикле через uart_read. Отдельный файл — приёмное кольцо и
+// обработчик нужны только MCU2.
+
+#define RX_MASK (UART_RX_SIZE - 1)
+
+volatile uint16_t uart_rx_overflows = 0;
+
+static uint8_t rx_ring[UART_RX_SIZE];
+static volatile uint8_t rx_head, rx_tail;
+
+ISR(USART_RX_vect) {
+  // DOR — байт потерян ещё в USART: прерывание опоздало
+  if (UCSR0A & (1 << DOR0))
+    uart_rx_overflows++;
+  uint8_t c = UDR0;
+  uint8_t next = (rx_head + 1) & RX_MASK;
+  if (next == rx_tail) {
+    uart_rx_overflows++; // основной цикл не забирает
+    return;
+  }
+  rx_ring[rx_head] = c;
+  rx_head = next;
+}
+
+void uart_init_read(void) {
+  uart_set_baud();
+  rx_head = rx_tail = 0;
+  UCSR0B = (1 << RXEN0) | (1 << RXCIE0);
+}
+
+uint8_t uart_read(uint8_t *buf, uint8_t max) {
+  uint8_t n = 0;
+  uint8_t tail = rx_tail;
+  while (n < max && tail != rx_head) {
+    buf[n++] = rx_ring[tail];
+    tail = (tail + 1) & RX_MASK;
+  }
+  rx_tail = tail; // место освобождается после копирования
+  return n;
+}
@@ -1,10 +1,11 @@
+#include "./lib/FastMath/fastmath.h"
 #include "./lib/ST7735S/ST7735S.h"
 #include "./lib/Screen/screen.h"
 
 #include <math.h>
 #include <stdbool.h>
+#include <stdlib.h>
 #include <string.h>
-#include <util/delay.h>
 
 #ifndef MIN
 #define MIN(a, b) ((a) < (b) ? (a) : (b))
@@ -17,176 +18,130 @@
 #define M_PI 3.14159265358979323846f
 #endif
 
+// Точка между примитивами, где рендер уступает срочным задачам
+// (sched_yield из lib/Sched). Без планировщика — пусто.
+#ifndef RENDER_YIELD
+#define RENDER_YIELD() ((void)0)
+#endif
+
+// Секция профилировщика шины дисплея до конца функции
+// (lib/Screen/profile_screen). Без SCREEN_PROFILE — пусто.
+#ifdef SCREEN_PROFILE
+#include "./lib/Screen/profile_screen.h"
+#define RENDER_SECTION(s) PROFILE_SECTION(s)
+#else
+#define RENDER_SECTION(s) ((void)0)
+#endif
+
 static const Color WHITE = {255, 255, 255};
 static const Color BLACK = {0, 0, 0};
 static const Color SKY_BLUE = {0, 0, 255};
 static const Color EARTH_BROWN = {101, 67, 33};
 static const Color YELLOW = {255, 255, 0};
 
+#ifdef SCREEN_PROFILE
+// Профилировщик впереди; под ним компоновщик или панель
+static const Screen *screen = &PROFILE_SCREEN;
+#elif defined(SCREEN_COMPOSITOR)
+#include "./lib/Screen/compositor.h"
+static const Screen *screen = &COMPOSITOR_SCREEN;
+#else
 extern const Screen ST7735S_SCREEN;
 static const Screen *screen = &ST7735S_SCREEN;
+#endif
 
 static bool roll_first_draw = true;
 static bool pitch_first_draw = true;
 static int pitch_last_horizon_y = -1;
 
-void fill_screen(const Color *color) {
-  st7735s_fill_screen(RGB565(color->red, color->green, color->blue));
-}
-
-void draw_roll_ui(const Screen *scr) {
-  const int R = (int)(0.35f * scr->width);
-  const int cy = R + (int)(0.05f * scr->height);
-  const int cx = scr->width / 2;
-
-  const int tick_len = (int)(0.022f * scr->width);
-  const int label_dist = tick_len + (int)(0.03f * scr->width);
-  const uint8_t font_size = 1;
-
-  const int MIN_COORD = -75;
-  const int MAX_COORD = 75;
-  const int steps = 61;
+void fill_screen(const Color *color) { screen->clear(color); }
 
-  int prev_x = -1, prev_y = -1;
-  for (int i = 0; i <= steps; ++i) {
-    float coord_deg = MIN_COORD + (MAX_COORD - MIN_COORD) * i / (float)steps;
-    float rad = coord_deg * (M_PI / 180.0f);
+// Геометрия шкалы крена посчитана при сборке: tools/gen_roll_scale.c
+// кладёт её в PROGMEM, таблицу под размер экрана задаёт Makefile
+#ifndef ROLL_SCALE_TABLE
+#error "ROLL_SCALE_TABLE не задан: таблицу шкалы крена строит Makefile"
+#endif
+#define _ROLL_SCALE_STR(x) #x
+#define ROLL_SCALE_STR(x) _ROLL_SCALE_STR(x)
+#include ROLL_SCALE_STR(ROLL_SCALE_TABLE)
 
-    int x = cx - (int)(R * sinf(rad));
-    int y = cy - (int)(R * cosf(rad));
+#if ROLL_SCALE_WIDTH != DISPLAY_WIDTH || ROLL_SCALE_HEIGHT != DISPLAY_HEIGHT
+#error "Таблица шкалы крена собрана для другого экрана"
+#endif
 
-    if (x < 0 || x >= scr->width || y < 0 || y >= scr->height) {
-      prev_x = -1;
+void draw_roll_ui(const Screen *scr) {
+  RENDER_SECTION(PROFILE_ROLL_UI);
+  Point2D prev = make_point(-1, -1);
+  for (uint8_t i = 0; i < ROLL_SCALE_ARC_POINTS; ++i) {
+    uint8_t x = pgm_read_byte(&roll_scale_arc[i][0]);
+    uint8_t y = pgm_read_byte(&roll_scale_arc[i][1]);
+    if (x == ROLL_SCALE_BREAK) {
+      prev.x = -1;
       continue;
     }
 
-    if (prev_x != -1) {
-      Point2D p1 = make_point(prev_x, prev_y);
-      Point2D p2 = make_point(x, y);
-      scr->draw_line(&p1, &p2, &WHITE);
-    }
-    prev_x = x;
-    prev_y = y;
+    Point2D p = make_point(x, y);
+    if (prev.x != -1)
+      scr->draw_line(&prev, &p, &WHITE);
+    prev = p;
   }
+  RENDER_YIELD();
 
-  static const int coord_angles[] = {-60, -30, 0, 30, 60};
-  const int n = sizeof(coord_angles) / sizeof(coord_angles[0]);
-
-  for (int i = 0; i < n; ++i) {
-    int coord_deg = coord_angles[i];
-    float rad = coord_deg * (M_PI / 180.0f);
-
-    int x_c = cx - (int)(R * sinf(rad));
-    int y_c = cy - (int)(R * cosf(rad));
-
-    float nx = -sinf(rad);
-    float ny = -cosf(rad);
-
-    // Штрих
-    int x_end = x_c + (int)(nx * tick_len);
-    int y_end = y_c + (int)(ny * tick_len);
-    Point2D p1 = make_point(x_c, y_c);
-    Point2D p2 = make_point(x_end, y_end);
+  for (uint8_t i = 0; i < ROLL_SCALE_TICKS; ++i) {
+    Point2D p1 = make_point((int16_t)pgm_read_word(&roll_scale_ticks[i][0]),
+                            (int16_t)pgm_read_word(&roll_scale_ticks[i][1]));
+    Point2D p2 = make_point((int16_t)pgm_read_word(&roll_scale_ticks[i][2]),
+                            (int16_t)pgm_read_word(&roll_scale_ticks[i][3]));
     scr->draw_line(&p1, &p2, &WHITE);
+  }
+  RENDER_YIELD();
 
-    // Подписи
-    char buf[6];
-    int label_x, label_y;
-
-    if (coord_deg == -60) {
-      strcpy(buf, "-30");
-      label_x = x_c + (int)(nx * label_dist);
-      label_y = y_c + (int)(ny * label_dist);
-    } else if (coord_deg == 60) {
-      strcpy(buf, "+30");
-      label_x = x_c + (int)(nx * label_dist);
-      label_y = y_c + (int)(ny * label_dist);
-    } else if (coord_deg == 0) {
-      strcpy(buf, "0");
-      label_x = x_c + (int)(nx * label_dist);
-      label_y = y_c + (int)(ny * label_dist);
-    } else if (coord_deg == -30) {
-      strcpy(buf, "-60");
-      float ext_factor = 1.8f;
-      int ext_x = x_c + (int)(nx * label_dist * ext_factor);
-      int ext_y = y_c + (int)(ny * label_dist * ext_factor);
-      label_x = ext_x;
-      label_y = ext_y + (int)(0.08f * scr->height);
-    } else if (coord_deg == 30) {
-      strcpy(buf, "+60");
-      float ext_factor = 1.8f;
-      int ext_x = x_c + (int)(nx * label_dist * ext_factor);
-      int ext_y = y_c + (int)(ny * label_dist * ext_factor);
-      label_x = ext_x;
-      label_y = ext_y + (int)(0.08f * scr->height);
-    } else {
-      continue;
-    }
-
-    if (label_x < 2 || label_x > scr->width - 20 || label_y < 2 ||
-        label_y > scr->height - 12)
-      continue;
-
-    int text_w;
-    if (strcmp(buf, "0") == 0) {
-      text_w = 6;
-    } else if (buf[1] == '3' || buf[1] == '6') {
-      text_w = 10;
-    } else {
-      text_w = 8;
-    }
+  if (!scr->draw_string)
+    return;
 
-    float asym_factor = 1.0f;
-    if (coord_deg == 60)
-      asym_factor = 3.8f;
-    else if (coord_deg == -60)
-      asym_factor = 1.1f;
-    else if (coord_deg == 0)
-      asym_factor = 1.5f;
-    else if (coord_deg == 30)
-      asym_factor = 4.2f;
-    else if (coord_deg == -30)
-      asym_factor = 0.7f;
-
-    label_x -= (int)(text_w * asym_factor / 2.0f);
-
-    if (coord_deg == -60 || coord_deg == 0 || coord_deg == 60)
-      label_y -= 2;
-    if (coord_deg == -30 || coord_deg == 0 || coord_deg == 30)
-      label_y -= 6;
-
-    if (scr->draw_string) {
-      scr->draw_string(label_x, label_y, buf, &WHITE, font_size);
-    }
+  for (uint8_t i = 0; i < ROLL_SCALE_LABELS; ++i) {
+    char buf[sizeof(roll_scale_labels[0].text)];
+    memcpy_P(buf, roll_scale_labels[i].text, sizeof(buf));
+    scr->draw_string((int16_t)pgm_read_word(&roll_scale_labels[i].x),
+                     (int16_t)pgm_read_word(&roll_scale_labels[i].y), buf,
+                     &WHITE, 1);
   }
 }
 
 void draw_roll_mode(const Screen *scr, float roll_rad) {
+  RENDER_SECTION(PROFILE_ROLL_LINE);
   static int prev_x1 = 0, prev_y1 = 0, prev_x2 = 0, prev_y2 = 0;
+  bool first = roll_first_draw;
 
   if (roll_first_draw) {
     scr->clear(&BLACK);
     draw_roll_ui(scr);
     roll_first_draw = false;
+    RENDER_YIELD();
 
     const int cx = scr->width / 2;
     const int cy = scr->height / 2;
     const float len = 40.0f;
 
-    prev_x1 = cx + (int)(len * cosf(roll_rad));
-    prev_y1 = cy - (int)(len * sinf(roll_rad));
-    prev_x2 = cx - (int)(len * cosf(roll_rad));
-    prev_y2 = cy + (int)(len * sinf(roll_rad));
+    prev_x1 = cx + (int)(len * FM_COS(roll_rad));
+    prev_y1 = cy - (int)(len * FM_SIN(roll_rad));
+    prev_x2 = cx - (int)(len * FM_COS(roll_rad));
+    prev_y2 = cy + (int)(len * FM_SIN(roll_rad));
   }
 
   const int cx = scr->width / 2;
   const int cy = scr->height / 2;
   const float len = 40.0f;
 
-  int x1 = cx + (int)(len * cosf(roll_rad));
-  int y1 = cy - (int)(len * sinf(roll_rad));
-  int x2 = cx - (int)(len * cosf(roll_rad));
-  int y2 = cy + (int)(len * sinf(roll_rad));
+  int x1 = cx + (int)(len * FM_COS(roll_rad));
+  int y1 = cy - (int)(len * FM_SIN(roll_rad));
+  int x2 = cx - (int)(len * FM_COS(roll_rad));
+  int y2 = cy + (int)(len * FM_SIN(roll_rad));
+
+  // Полоса на месте — панель уже показывает то же самое
+  if (!first && x1 == prev_x1 && y1 == prev_y1 && x2 == prev_x2 &&
+      y2 == prev_y2)
+    return;
 
   if (!roll_first_draw) {
     int min_x = MIN(prev_x1, prev_x2);
@@ -204,6 +159,7 @@ void draw_roll_mode(const Screen *scr, float roll_rad) {
     int h = max_y - min_y + 1;
 
     scr->fill_rect(min_x, min_y, w, h, &BLACK);
+    RENDER_YIELD();
   }
 
   Point2D p1 = make_point(x1, y1);
@@ -216,13 +172,37 @@ void draw_roll_mode(const Screen *scr, float roll_rad) {
   prev_y2 = y2;
 }
 
+// Подписи «NN°» слева и справа от штриха длиной len
+void draw_pitch_labels(const Screen *scr, int deg, int len, int y) {
+  const int text_offset = 5;
+
+  char buf[5];
+  int idx = 0;
+  int a = (deg < 0) ? -deg : deg;
+
+  if (a >= 10)
+    buf[idx++] = '0' + (a / 10);
+  buf[idx++] = '0' + (a % 10);
+  buf[idx++] = ST7735S_DEGREE;
+  buf[idx] = '\0';
+
+  int text_w = idx * 7;
+  int tx_left = scr->width / 2 - len - text_offset - text_w;
+  int tx_right = scr->width / 2 + len + text_offset;
+
+  if (scr->draw_string) {
+    scr->draw_string(tx_left, y, buf, &YELLOW, 1);
+    scr->draw_string(tx_right, y, buf, &YELLOW, 1);
+  }
+}
+
 void draw_pitch_ui_full(const Screen *scr, float pitch_rad) {
+  RENDER_SECTION(PROFILE_PITCH_UI);
   const float scale = 60.0f;
   const int centerY = scr->height / 2;
 
   const int long_len = 22;
   const int short_len = 10;
-  const int text_offset = 5;
   const int text_y_shift = -3;
 
   for (int deg = -60; deg <= 60; deg += 5) {
@@ -235,28 +215,13 @@ void draw_pitch_ui_full(const Screen *scr, float pitch_rad) {
     int len = (deg % 15 == 0) ? long_len : short_len;
 
     scr->draw_hline(scr->width / 2 - len, y, len * 2, &WHITE);
+    RENDER_YIELD();
 
     if (deg % 15 != 0)
       continue;
 
-    char buf[5];
-    int idx = 0;
-    int a = (deg < 0) ? -deg : deg;
-
-    if (a >= 10)
-      buf[idx++] = '0' + (a / 10);
-    buf[idx++] = '0' + (a % 10);
-    buf[idx++] = 176; // '°'
-    buf[idx] = '\0';
-
-    int text_w = idx * 7;
-    int tx_left = scr->width / 2 - len - text_offset - text_w;
-    int tx_right = scr->width / 2 + len + text_offset;
-
-    if (scr->draw_string) {
-      scr->draw_string(tx_left, y + text_y_shift, buf, &YELLOW, 1);
-      scr->draw_string(tx_right, y + text_y_shift, buf, &YELLOW, 1);
-    }
+    draw_pitch_labels(scr, deg, len, y + text_y_shift);
+    RENDER_YIELD();
   }
 
   // Выделение 0°
@@ -271,7 +236,7 @@ void draw_pitch_ui_full(const Screen *scr, float pitch_rad) {
 void draw_pitch_ui(const Screen *scr, float pitch_rad) {
   static int last_pitch_deg = 1000;
 
-  int pitch_deg = (int)roundf(pitch_rad * 180.0f / M_PI);
+  int pitch_deg = (int)FM_ROUND(pitch_rad * 180.0f / M_PI);
   pitch_deg = ((pitch_deg + 2) / 5) * 5;
 
   if (pitch_first_draw) {
@@ -289,13 +254,14 @@ void draw_pitch_ui(const Screen *scr, float pitch_rad) {
 }
 
 void update_sky_ground(const Screen *scr, float pitch_rad) {
+  RENDER_SECTION(PROFILE_SKY_GROUND);
   float max_rad = 45.0f * (M_PI / 180.0f);
   if (pitch_rad > max_rad)
     pitch_rad = max_rad;
   if (pitch_rad < -max_rad)
     pitch_rad = -max_rad;
   pitch_rad =
-      roundf(pitch_rad / (5.0f * M_PI / 180.0f)) * (5.0f * M_PI / 180.0f);
+      FM_ROUND(pitch_rad / (5.0f * M_PI / 180.0f)) * (5.0f * M_PI / 180.0f);
 
   int horizon_y = (int)((float)(scr->height / 2) - pitch_rad * 60.0f);
   if (horizon_y < 0)
@@ -305,6 +271,7 @@ void update_sky_ground(const Screen *scr, float pitch_rad) {
 
   if (pitch_last_horizon_y == -1) {
     scr->fill_rect(0, 0, scr->width, horizon_y, &EARTH_BROWN);
+    RENDER_YIELD();
     scr->fill_rect(0, horizon_y, scr->width, scr->height - horizon_y,
                    &SKY_BLUE);
     pitch_last_horizon_y = horizon_y;
@@ -322,9 +289,136 @@ void update_sky_ground(const Screen *scr, float pitch_rad) {
   pitch_last_horizon_y = horizon_y;
 }
 
+// --- Тангаж на аппаратной прокрутке (scr->scroll) ---
+// Небо, земля и шкала — одна «мировая» картинка, которая едет вместе с
+// горизонтом. Мировая строка w (0 — горизонт, земля при w < 0) всегда
+// лежит в строке памяти (w + H/2) mod H, поэтому смена тангажа — это
+// команда прокрутки, дорисовка открывшихся строк и перенос символа самолёта.
+
+static int pitch_world_row(const Screen *scr, int w) {
+  int m = (w + scr->height / 2) % scr->height;
+  return (m < 0) ? m + scr->height : m;
+}
+
+// Заливка мировых строк w0..w1 в столбцах x0..x1 с переносом по кольцу
+static void pitch_fill_world(const Screen *scr, int x0, int x1, int w0, int w1,
+                             const Color *color) {
+  if (w0 > w1 || x0 > x1)
+    return;
+  int m0 = pitch_world_row(scr, w0);
+  int h = w1 - w0 + 1;
+  int first = MIN(h, scr->height - m0);
+  scr->fill_rect(x0, m0, x1 - x0 + 1, first, color);
+  if (h > first)
+    scr->fill_rect(x0, 0, x1 - x0 + 1, h - first, color);
+}
+
+// Перерисовка мировых строк w0..w1 в столбцах x0..x1: фон, штрихи, подписи.
+// top — мировая строка у верхнего края экрана.
+static void pitch_paint_world(const Screen *scr, int x0, int x1, int w0,
+                              int w1, int top) {
+  RENDER_SECTION(PROFILE_PITCH_SCROLL);
+  const int cx = scr->width / 2;
+  const int long_len = 22;
+  const int short_len = 10;
+  const int text_y_shift = -3;
+
+  pitch_fill_world(scr, x0, x1, w0, MIN(w1, -1), &EARTH_BROWN);
+  pitch_fill_world(scr, x0, x1, MAX(w0, 0), w1, &SKY_BLUE);
+  RENDER_YIELD();
+
+  for (int deg = -60; deg <= 60; deg += 5) {
+    float rad = deg * (M_PI / 180.0f);
+    int w = -(int)(rad * 60.0f);
+    int len = (deg % 15 == 0) ? long_len : short_len;
+
+    if (w >= w0 && w <= w1)
+      pitch_fill_world(scr, MAX(x0, cx - len), MIN(x1, cx + len - 1), w, w,
+                       &WHITE);
+
+    if (deg % 15 != 0)
+      continue;
+
+    // Подпись (5 строк) рисуется целиком и только когда видна вся: строки
+    // за краем экрана легли бы поверх противоположного края. Шов кольца
+    // при H/2 > 65 до подписей не доходит, но проверим и его.
+    int ty = w + text_y_shift;
+    if (ty + 4 < w0 || ty > w1)
+      continue;
+    if (ty < top || ty + 4 >= top + scr->height)
+      continue;
+    if (pitch_world_row(scr, ty) + 4 >= scr->height)
+      continue;
+    draw_pitch_labels(scr, deg, len, pitch_world_row(scr, ty));
+    RENDER_YIELD();
+  }
+
+  // Выделение 0°
+  int v0 = MAX(w0, -2), v1 = MIN(w1, 2);
+  if (cx - long_len >= x0 && cx - long_len <= x1)
+    pitch_fill_world(scr, cx - long_len, cx - long_len, v0, v1, &WHITE);
+  if (cx + long_len - 1 >= x0 && cx + long_len - 1 <= x1)
+    pitch_fill_world(scr, cx + long_len - 1, cx + long_len - 1, v0, v1, &WHITE);
+}
+
+void draw_pitch_mode_scroll(const Screen *scr, float pitch_rad) {
+  RENDER_SECTION(PROFILE_PITCH_SYMBOL);
+  static int last_shift = 0; // на сколько мир сдвинут вниз, px
+
+  const int H = scr->height;
+  const int cx = scr->width / 2;
+  const int cy = H / 2;
+  const int len = 40;
+
+  float max_rad = 45.0f * (M_PI / 180.0f);
+  if (pitch_rad > max_rad)
+    pitch_rad = max_rad;
+  if (pitch_rad < -max_rad)
+    pitch_rad = -max_rad;
+
+  // Как и в update_sky_ground: горизонт на H/2 - pitch * 60
+  int shift = -(int)FM_ROUND(pitch_rad * 60.0f);
+  if (!pitch_first_draw && shift == last_shift)
+    return;
+
+  int top = -cy - shift;
+  int old_top = -cy - last_shift;
+
+  // Строка экрана 0 показывает мировую строку top
+  scr->scroll((uint16_t)pitch_world_row(scr, top));
+
+  if (pitch_first_draw || abs(shift - last_shift) >= H) {
+    pitch_paint_world(scr, 0, scr->width - 1, top, top + H - 1, top);
+    pitch_first_draw = false;
+  } else {
+    if (top < old_top)
+      pitch_paint_world(scr, 0, scr->width - 1, top, old_top - 1, top);
+    else
+      pitch_paint_world(scr, 0, scr->width - 1, old_top + H, top + H - 1,
+                        top);
+
+    // Символ самолёта уехал вместе с миром — стираем его старую строку
+    int w_sym = old_top + cy;
+    if (w_sym >= top && w_sym < top + H)
+      pitch_paint_world(scr, cx - len, cx + len, w_sym, w_sym, top);
+  }
+  last_shift = shift;
+
+  int m = pitch_world_row(scr, top + cy);
+  Point2D p1 = make_point(cx - len, m);
+  Point2D p2 = make_point(cx + len, m);
+  scr->draw_line(&p1, &p2, &WHITE);
+}
+
 void draw_pitch_mode(const Screen *scr, float pitch_rad) {
+  RENDER_SECTION(PROFILE_PITCH_SYMBOL);
   static float last_pitch_for_draw = 1000.0f;
 
+  if (scr->scroll) {
+    draw_pitch_mode_scroll(scr, pitch_rad);
+    return;
+  }
+
   if (pitch_first_draw) {
     // Принудительно перерисуем всё
     draw_pitch_ui_full(scr, pitch_rad);
@@ -338,6 +432,7 @@ void draw_pitch_mode(const Screen *scr, float pitch_rad) {
   if (pitch_changed) {
     update_sky_ground(scr, pitch_rad);
     last_pitch_for_draw = pitch_rad;
+    RENDER_YIELD();
   }
 
   draw_pitch_ui(scr, pitch_rad);
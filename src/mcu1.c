@@ -1,9 +1,18 @@
+#include "./lib/Attitude/attitude.h"
+#include "./lib/Boot/boot.h"
 #include "./lib/Button/Button.h"
 #include "./lib/MPU6050/MPU6050.h"
+#include "./lib/MPU6050/gyro_bias.h"
+#include "./lib/Record/record.h"
+#include "./lib/Sched/sched.h"
+#include "./lib/Telemetry/telemetry.h"
+#include "./lib/Timebase/timebase.h"
 #include "./lib/UART/uart.h"
 
 #include <stdio.h>
 
+// Рендер уступает датчику и каналу между примитивами
+#define RENDER_YIELD() sched_yield()
 #include "mcu.h"
 
 typedef enum {
@@ -11,85 +20,426 @@ typedef enum {
   MODE_ROLL_ONLY   // Только крен
 } DisplayMode;
 
+// Оценщик ориентации: комплементарный фильтр или Mahony (ATTITUDE_MAHONY)
+#ifdef ATTITUDE_MAHONY
+static const Estimator *estimator = &MAHONY_ESTIMATOR;
+#else
+static const Estimator *estimator = &COMPLEMENTARY_ESTIMATOR;
+#endif
+
 static float roll_angle = 0.0f;
 static float pitch_angle = 0.0f;
 static DisplayMode current_mode = MODE_ROLL_ONLY;
 
-volatile bool update_ready = false;
+// Периоды задач, мкс. Рендер и канал — ~33 Гц, как прежний Timer1.
+#ifdef MPU6050_FIFO
+// Отсчёты копит FIFO датчика: забираем пачками по MPU6050_FIFO_BURST
+#define SENSOR_PERIOD_US (MPU6050_SAMPLE_PERIOD_US * MPU6050_FIFO_BURST)
+#else
+#define SENSOR_PERIOD_US 10000
+#endif
+#define LINK_PERIOD_US 30000
+#ifndef RENDER_PERIOD_US
+#define RENDER_PERIOD_US 30000 // задаёт Makefile
+#endif
+
+#ifdef ATTITUDE_PROFILE
+// Такты CPU на обновление оценщика. Тик Timebase — 8 тактов, копим 64 замера:
+// сумма тиков / 8 и есть среднее в тактах. Выводится в углу экрана —
+// UART занят пакетами для MCU2.
+static uint32_t profile_ticks = 0;
+static uint8_t profile_count = 0;
 
-ISR(TIMER1_COMPA_vect) { update_ready = true; }
+static void profile_attitude(uint16_t t0) {
+  profile_ticks += (uint16_t)(timebase_ticks() - t0);
+  if (++profile_count < 64)
+    return;
 
-float calculate_roll_from_accel(float ax, float ay, float az) {
-  return atan2f(ay, az);
+  profile_ticks = profile_ticks * TIMEBASE_CYCLES_PER_TICK / 64;
+  char buf[11];
+  uint8_t i = sizeof(buf) - 1;
+  buf[i] = '\0';
+  do {
+    buf[--i] = '0' + profile_ticks % 10;
+    profile_ticks /= 10;
+  } while (profile_ticks);
+  st7735s_draw_number_string_bg(2, DISPLAY_HEIGHT - 6, &buf[i], COLOR_WHITE,
+                                COLOR_BLACK, 1);
+
+  profile_ticks = 0;
+  profile_count = 0;
 }
+#endif
 
-int main(void) {
-  st7735s_init();
-  mpu6050_init();
-  button_init();
-  uart_init_send();
+#ifdef IMU_STREAM
+// Запись для tools/imu_replay: каждый отсчёт, поданный в фильтр, — кадром
+// lib/Record в UART вперемешку с пакетами MCU2. Линия должна
+// успевать за датчиком.
+#ifdef MPU6050_FIFO
+#define IMU_STREAM_PERIOD_US MPU6050_SAMPLE_PERIOD_US
+#define IMU_STREAM_FLAGS RECORD_FIFO
+#else
+#define IMU_STREAM_PERIOD_US SENSOR_PERIOD_US
+#define IMU_STREAM_FLAGS 0
+#endif
+#if UART_BAUD_REAL / 10 * IMU_STREAM_PERIOD_US <                               \
+    1000000UL * RECORD_FRAME_MAX + 1000000UL * LINK_FRAME_MAX *                \
+                                       IMU_STREAM_PERIOD_US / LINK_PERIOD_US
+#error "IMU_STREAM does not fit the link at this rate, raise LINK_BAUD"
+#endif
+
+// Без ожидания: нет места в кольце — кадр пропадает, хост видит разрыв
+// номеров
+static void imu_stream(const MPU6050Sample *sample) {
+  static uint8_t seq = 0;
+  uint8_t buf[RECORD_FRAME_MAX];
+#ifdef MPU6050_FIFO
+  MPU6050Sample s = *sample;
+  s.timestamp *= MPU6050_SAMPLE_PERIOD_US; // номер отсчёта → мкс датчика
+  sample = &s;
+#endif
+  uart_write(buf, record_encode(sample, seq++, IMU_STREAM_FLAGS, buf));
+}
+#endif
+
+// Сбойные чтения датчика: отсчёт пропущен, углы остались прежними
+static uint16_t sensor_read_errors = 0;
+
+// Готовность устройств: старт идёт шагами вперемешку с задачами, и
+// каждая задача ждёт только своё устройство
+static bool sensor_ready = false;
+static bool display_ready = false;
+static bool attitude_ready = false;
+#ifdef BOOT_REPORT
+static uint32_t first_attitude_us;
+#endif
+
+#ifdef TELEMETRY
+// Телеметрия для диагностики (tools/telemetry_dump): отсчёты с углами
+// пачками на частоте датчика, раз в TELEMETRY_STATUS_US — счётчики и
+// времена задач. Кадры идут в UART вперемешку с пакетами MCU2.
+#ifdef IMU_STREAM
+#error "TELEMETRY and IMU_STREAM share the link, pick one"
+#endif
+#ifdef MPU6050_FIFO
+#define TELEMETRY_PERIOD_US MPU6050_SAMPLE_PERIOD_US
+#define TELEMETRY_FLAGS TELEMETRY_FIFO
+#else
+#define TELEMETRY_PERIOD_US SENSOR_PERIOD_US
+#define TELEMETRY_FLAGS 0
+#endif
+#define TELEMETRY_STATUS_US 1000000UL
+// Байт в секунду на линии: пачки, пакеты MCU2 и кадр состояния
+#define TELEMETRY_LINE_BYTES                                                   \
+  (1000000UL * TELEMETRY_FRAME_MAX / (TELEMETRY_PERIOD_US * TELEMETRY_BATCH) + \
+   1000000UL * LINK_FRAME_MAX / LINK_PERIOD_US + TELEMETRY_STATUS_FRAME_MAX)
+#if UART_BAUD_REAL / 10 < TELEMETRY_LINE_BYTES
+#error "TELEMETRY does not fit the link at this rate, raise LINK_BAUD"
+#endif
+// uart_write кладёт кадр целиком или никак, а кольцо вмещает
+// UART_TX_SIZE - 1 байт: кадр длиннее не уйдёт ни разу, все пачки
+// пропадут как dropped
+#if TELEMETRY_FRAME_MAX > UART_TX_SIZE - 1
+#error "TELEMETRY_BATCH frame does not fit the UART ring, lower the batch"
+#endif
+
+static TelemetryBatch telemetry_batch;
+static TelemetryStatus telemetry;
+static uint8_t telemetry_seq = 0;
+
+// Без ожидания: нет места в кольце — кадр пропадает (dropped, разрыв
+// номеров), фильтр не ждёт линию
+static void telemetry_send(const uint8_t *frame, uint8_t n) {
+  if (!uart_write(frame, n))
+    telemetry.dropped++;
+  telemetry_seq++;
+}
+
+static void telemetry_send_batch(void) {
+  uint8_t buf[TELEMETRY_FRAME_MAX];
+  uint8_t n = telemetry_encode_batch(&telemetry_batch, telemetry_seq,
+                                     TELEMETRY_FLAGS, buf);
+  if (n)
+    telemetry_send(buf, n);
+}
+
+// Отсчёт с углами после обновления — в пачку, полная уходит сразу
+static void telemetry_sample(const MPU6050Sample *sample, uint16_t dt_us) {
+  if (dt_us > telemetry.gap_max_us)
+    telemetry.gap_max_us = dt_us;
+#ifdef MPU6050_FIFO
+  MPU6050Sample s = *sample;
+  s.timestamp *= MPU6050_SAMPLE_PERIOD_US; // номер отсчёта → мкс датчика
+  sample = &s;
+#endif
+  int16_t roll = estimator->roll();
+  int16_t pitch = estimator->pitch();
+  if (!telemetry_add(&telemetry_batch, sample, roll, pitch)) {
+    telemetry_send_batch(); // шаг не влез в 16 бит — новая пачка
+    telemetry_add(&telemetry_batch, sample, roll, pitch);
+  }
+  if (telemetry_batch.count == TELEMETRY_BATCH)
+    telemetry_send_batch();
+}
+#endif
+
+// Отсчёт — в оценщик, углы — двоичные. Шаг — по меткам времени
+// отсчётов; в режиме FIFO — период датчика.
+static void attitude_filter(const MPU6050Sample *sample) {
+#ifdef MPU6050_FIFO
+  uint16_t dt_us = MPU6050_SAMPLE_PERIOD_US;
+#else
+  static uint32_t last_timestamp;
+  static bool have_last = false;
+  uint32_t elapsed = sample->timestamp - last_timestamp;
+  uint16_t dt_us = !have_last         ? SENSOR_PERIOD_US
+                   : elapsed > 0xFFFF ? 0xFFFF // долгий сбой шины
+                                      : elapsed;
+  last_timestamp = sample->timestamp;
+  have_last = true;
+#endif
+
+  gyro_bias_update(sample); // смещения — к следующим отсчётам
+#ifdef IMU_STREAM
+  imu_stream(sample);
+#endif
+
+#ifdef ATTITUDE_PROFILE
+  uint16_t t0 = timebase_ticks();
+  estimator->update(sample->accel, sample->gyro, dt_us);
+  profile_attitude(t0);
+#else
+  estimator->update(sample->accel, sample->gyro, dt_us);
+#endif
+#ifdef TELEMETRY
+  telemetry_sample(sample, dt_us);
+#endif
+#ifdef BOOT_REPORT
+  if (!attitude_ready)
+    first_attitude_us = boot_elapsed_us();
+#endif
+  attitude_ready = true;
+}
+
+#ifdef MPU6050_FIFO
+// Все накопленные в FIFO отсчёты — через фильтр, каждый со своим шагом
+// по часам датчика
+static void attitude_drain(void) {
+  MPU6050Sample sample;
+  MPU6050Status status;
+  while ((status = mpu6050_fifo_drain()) == MPU6050_OK &&
+         mpu6050_fifo_available()) {
+    while (mpu6050_fifo_pop(&sample))
+      attitude_filter(&sample);
+  }
+  if (status != MPU6050_OK && status != MPU6050_ERR_FIFO)
+    sensor_read_errors++; // переполнения считает сам драйвер
+}
+#endif
+
+#ifdef SCREEN_PROFILE
+// Отчёт профилировщика шины дисплея раз в столько кадров. Строки идут
+// в канал кадрами «0x00, строка, 0x00», целиком и только в свободную
+// линию: ни пакет MCU2, ни кадр записи строкой не разрывается. MCU2
+// отбрасывает их как сбойные кадры, на ПК строки видны между нулями.
+#ifndef PROFILE_REPORT_FRAMES
+#define PROFILE_REPORT_FRAMES 64
+#endif
+
+// Строка с разделителями; длиннее кольца — уходит кусками
+static uint8_t profile_line[UART_TX_SIZE - 1];
+static uint8_t profile_line_len = 1; // [0] — разделитель
+
+// Копит строку; пока линия занята, уступаем датчику и каналу
+static void profile_put(uint8_t c) {
+  profile_line[profile_line_len++] = c;
+  if (c != '\n' && profile_line_len < sizeof(profile_line) - 1)
+    return;
+  profile_line[profile_line_len++] = 0x00;
+  while (!uart_tx_idle() || !uart_write(profile_line, profile_line_len))
+    sched_yield();
+  profile_line_len = 1;
+}
+#endif
+
+// --- Задачи планировщика, по убыванию приоритета ---
 
+// Датчик и фильтр
+static void task_sensor(void) {
+  if (!sensor_ready)
+    return;
+#if defined(MPU6050_FIFO)
+  if (!mpu6050_data_ready)
+    return;
+  attitude_drain();
+#elif defined(I2C_ASYNC)
+  // Забираем отсчёт, запущенный прошлым вызовом, и сразу запускаем
+  // следующий: шина работает между вызовами, CPU занят другим
+  static bool pending = false;
+  MPU6050Sample sample;
+  if (pending) {
+    MPU6050Status status = mpu6050_read_all_poll(&sample);
+    if (status == MPU6050_BUSY)
+      return; // ещё на шине — до следующего срока
+    if (status == MPU6050_OK)
+      attitude_filter(&sample);
+    else
+      sensor_read_errors++;
+  }
+  pending = (mpu6050_read_all_start() == MPU6050_OK);
+  if (!pending)
+    sensor_read_errors++;
+#else
+  // Сбойный отсчёт пропускаем: углы остаются прежними, нули в фильтр
+  // не попадают.
+  MPU6050Sample sample;
+  if (mpu6050_read_all(&sample) == MPU6050_OK)
+    attitude_filter(&sample);
+  else
+    sensor_read_errors++;
+#endif
+  roll_angle = ATTITUDE_TO_RAD(estimator->roll());
+  pitch_angle = ATTITUDE_TO_RAD(estimator->pitch());
+}
+
+// Углы на MCU2: пакет уходит из прерывания, задача не ждёт линию
+static void task_link(void) {
+  if (!attitude_ready)
+    return; // MCU2 ждёт первых настоящих углов
+  uint8_t mode_bit = (current_mode == MODE_PITCH_ONLY) ? 1 : 0;
+  send_attitude_packet(roll_angle, pitch_angle, mode_bit);
+}
+
+// Кнопка и кадр; уступает задачам выше через RENDER_YIELD
+static void task_render(void) {
+  if (!display_ready)
+    return;
+  // Кнопка: антидребезг по Timebase, без задержки цикла
+  if (button_poll()) {
+    current_mode = (current_mode == MODE_PITCH_ONLY) ? MODE_ROLL_ONLY
+                                                     : MODE_PITCH_ONLY;
+    st7735s_flush(); // дорисовать хвост старого режима до сброса
+    if (screen->scroll)
+      screen->scroll(0); // тангаж мог оставить экран прокрученным
+    screen->clear(&BLACK);
+    roll_first_draw = true;
+    pitch_first_draw = true;
+    pitch_last_horizon_y = -1;
+  }
+
+  if (current_mode == MODE_PITCH_ONLY) {
+    draw_pitch_mode(screen, pitch_angle);
+  } else {
+    draw_roll_mode(screen, roll_angle);
+  }
+  if (screen->present)
+    screen->present();
+#ifdef SCREEN_PROFILE
+  if (profile_frames() >= PROFILE_REPORT_FRAMES)
+    profile_report(profile_put);
+#endif
+}
+
+#ifdef TELEMETRY
+static void task_telemetry(void);
+#endif
+
+static SchedTask tasks[] = {
+    {.run = task_sensor, .period_us = SENSOR_PERIOD_US},
+    {.run = task_link, .period_us = LINK_PERIOD_US},
+#ifdef TELEMETRY
+    {.run = task_telemetry, .period_us = TELEMETRY_STATUS_US},
+#endif
+    {.run = task_render, .period_us = RENDER_PERIOD_US},
+};
+
+#ifdef TELEMETRY
+// Кадр состояния: счётчики с включения, времена и опоздания задач — за
+// окно с прошлого кадра, в порядке tasks[]
+_Static_assert(sizeof(tasks) / sizeof(tasks[0]) == TELEMETRY_TASKS,
+               "TELEMETRY_TASKS must match tasks[]");
+
+static void task_telemetry(void) {
+  telemetry.read_errors = sensor_read_errors;
+#ifdef MPU6050_FIFO
+  telemetry.fifo_overflows = mpu6050_fifo_overflows;
+#endif
+  telemetry.tx_replaced = uart_tx_replaced;
+  for (uint8_t i = 0; i < TELEMETRY_TASKS; i++) {
+    uint32_t worst = tasks[i].worst_us;
+    telemetry.task_worst_us[i] = worst > 0xFFFF ? 0xFFFF : worst;
+    telemetry.task_overruns[i] = tasks[i].overruns;
+  }
+  sched_reset_stats();
+
+  uint8_t buf[TELEMETRY_STATUS_FRAME_MAX];
+  telemetry_send(buf, telemetry_encode_status(&telemetry, telemetry_seq,
+                                              TELEMETRY_FLAGS, buf));
+  telemetry.gap_max_us = 0;
+}
+#endif
+
+// --- Старт: дисплей, датчик и канал поднимаются параллельно ---
+// Шаги идут из основного цикла между задачами: датчик готов через
+// ~50 мс, и фильтр с каналом работают, пока дисплей ещё просыпается.
+
+static uint16_t boot_display(void) {
+  uint16_t ms = st7735s_init_step();
+  if (ms != ST7735S_INIT_DONE)
+    return ms;
   screen->clear(&BLACK);
+  display_ready = true;
+  return BOOT_DONE;
+}
 
-  const float dt = 0.01f;
+// Пробуждение, проверка смещений гироскопа, затем FIFO
+static uint16_t boot_sensor(void) {
+  static bool awake = false;
+  if (!awake) {
+    mpu6050_init();
+    awake = true;
+  }
+  uint16_t ms = gyro_bias_boot_step();
+  if (ms != GYRO_BIAS_BOOT_DONE)
+    return ms;
+#ifdef MPU6050_FIFO
+  mpu6050_fifo_start();
+#endif
+  sensor_ready = true;
+  return BOOT_DONE;
+}
 
-  TCCR1A = 0;
-  TCCR1B = (1 << WGM12) | (1 << CS11) | (1 << CS10);
-  OCR1A = 7499;
-  TIMSK1 = (1 << OCIE1A);
-  TCNT1 = 0;
-  sei();
+static uint16_t boot_link(void) {
+  uart_init_send();
+  return BOOT_DONE;
+}
 
-  update_ready = true;
+static BootTask boot_tasks[] = {
+    {.name = "display", .step = boot_display},
+    {.name = "sensor", .step = boot_sensor},
+    {.name = "link", .step = boot_link},
+};
+#define BOOT_TASKS (sizeof(boot_tasks) / sizeof(boot_tasks[0]))
 
-  while (1) {
-    while (!update_ready)
-      ;
-    update_ready = false;
-
-    float gx, gy, gz, ax, ay, az;
-    mpu6050_read_gyro(&gx, &gy, &gz);
-    mpu6050_read_accel(&ax, &ay, &az);
-
-    // Обновление roll
-    float roll_gyro = roll_angle + (gx * (M_PI / 180.0f)) * dt;
-    float roll_accel = atan2f(ay, az);
-    float acc_mag = sqrtf(ax * ax + ay * ay + az * az);
-    float acc_error = fabsf(acc_mag - 1.0f);
-    float alpha = (acc_error < 0.05f)   ? 0.90f
-                  : (acc_error < 0.15f) ? 0.95f
-                                        : 0.985f;
-    roll_angle = alpha * roll_gyro + (1.0f - alpha) * roll_accel;
-    if (roll_angle > M_PI)
-      roll_angle -= 2.0f * M_PI;
-    if (roll_angle < -M_PI)
-      roll_angle += 2.0f * M_PI;
-
-    // Обновление pitch
-    pitch_angle = atan2f(-ax, sqrtf(ay * ay + az * az));
-
-    // Кнопка
-    if (button_pressed) {
-      button_pressed = false;
-      _delay_ms(30);
-      if ((PIND & (1 << PD2)) == 0) {
-        current_mode = (current_mode == MODE_PITCH_ONLY) ? MODE_ROLL_ONLY
-                                                         : MODE_PITCH_ONLY;
-        screen->clear(&BLACK);
-        roll_first_draw = true;
-        pitch_first_draw = true;
-        pitch_last_horizon_y = -1;
-      }
-    }
+int main(void) {
+  // Паузы старта меряет Timebase — часы нужны первыми
+  timebase_init(); // такты задаёт планировщик
+  sei();
 
-    uint8_t mode_bit = (current_mode == MODE_PITCH_ONLY) ? 1 : 0;
-    send_attitude_packet(roll_angle, pitch_angle, mode_bit);
+  button_init();
+  boot_start(boot_tasks, BOOT_TASKS);
+  sched_init(tasks, sizeof(tasks) / sizeof(tasks[0]));
 
-    // Рендер
-    if (current_mode == MODE_PITCH_ONLY) {
-      draw_pitch_mode(screen, pitch_angle);
-    } else {
-      draw_roll_mode(screen, roll_angle);
+  bool booted = false;
+  while (1) {
+    if (!booted && boot_poll(boot_tasks, BOOT_TASKS)) {
+      booted = true;
+#ifdef BOOT_REPORT
+      // Текст MCU2 отбрасывает как сбойный кадр: не сойдётся CRC
+      boot_report(boot_tasks, BOOT_TASKS);
+      boot_report_line("attitude", first_attitude_us);
+#endif
     }
+    sched_run();
   }
-}
\ No newline at end of file
+}
@@ -1,10 +1,20 @@
+#include "./lib/Boot/boot.h"
+#include "./lib/Link/link.h"
+#include "./lib/Mailbox/mailbox.h"
+#include "./lib/Sched/sched.h"
+#include "./lib/Timebase/timebase.h"
 #include "./lib/UART/uart.h"
 
 #include <avr/interrupt.h>
 #include <avr/io.h>
 
+// Рендер уступает приёму между примитивами
+#define RENDER_YIELD() sched_yield()
 #include "mcu.h"
 
+// Разбор принятых байтов, мкс: кольцо приёма держит 11 мс на 57600
+#define LINK_POLL_US 5000
+
 // Пакет данных
 typedef struct {
   float roll;
@@ -12,87 +22,120 @@ typedef struct {
   uint8_t mode; // 0 = мы рисуем pitch, 1 = мы рисуем roll
 } AttitudePacket;
 
-// Глобальные для приёма
-volatile bool packet_ready = false;
-volatile AttitudePacket received = {0};
-
-static uint8_t buf[11]; // WARN
-static uint8_t idx = 0;
-
-// Флаги для первого рисования
-ISR(USART_RX_vect) {
-  uint8_t c = UDR0;
+// Байты копит прерывание (uart_rx.c), кадры разбирает task_link, рендер
+// берёт последний пакет из ящика. Счётчики отставания:
+// uart_rx_overflows — байты, link_rx.errors/lost — кадры,
+// attitude_box.overwritten — пакеты, которые рендер не успел нарисовать.
+static LinkDecoder link_rx;
+static AttitudePacket attitude_value;
+static Mailbox attitude_box = MAILBOX(attitude_value);
+
+#ifdef SCREEN_PROFILE
+// Отчёт профилировщика шины дисплея раз в столько кадров
+#ifndef PROFILE_REPORT_FRAMES
+#define PROFILE_REPORT_FRAMES 64
+#endif
+
+// Отчёт идёт через кольцо передачи; пока места нет, уступаем приёму
+static void profile_put(uint8_t c) {
+  while (!uart_write(&c, 1))
+    sched_yield();
+}
+#endif
+
+// --- Задачи планировщика ---
+
+// Приём: кадры из накопленных байтов — в ящик
+static void task_link(void) {
+  uint8_t buf[16];
+  uint8_t n;
+  while ((n = uart_read(buf, sizeof(buf)))) {
+    for (uint8_t i = 0; i < n; i++) {
+      LinkFrame frame;
+      if (!link_decode_byte(&link_rx, buf[i], &frame))
+        continue;
+      AttitudePacket pkt = {
+          .roll = frame.roll_cd * LINK_CD_TO_RAD,
+          .pitch = frame.pitch_cd * LINK_CD_TO_RAD,
+          .mode = frame.mode,
+      };
+      mailbox_write(&attitude_box, &pkt);
+    }
+  }
+}
 
-  if (idx == 0 && c != 0xFE) {
-    // sync lost — сброс
-    idx = 0;
+// Фоновая: кадр по свежему пакету, уступает приёму через RENDER_YIELD
+static void task_render(void) {
+  AttitudePacket pkt;
+  if (!mailbox_read(&attitude_box, &pkt))
     return;
+
+  static uint8_t last_mode = 0xFF;
+  if (pkt.mode != last_mode) {
+    st7735s_flush(); // дорисовать хвост старого режима до сброса
+    if (screen->scroll)
+      screen->scroll(0); // тангаж мог оставить экран прокрученным
+    screen->clear(&BLACK);
+    roll_first_draw = true;
+    pitch_first_draw = true;
+    pitch_last_horizon_y = -1;
+    last_mode = pkt.mode;
   }
 
-  buf[idx] = c;
-  idx++;
-
-  if (idx == 11) {
-    if (buf[10] == 0xFF) {
-      // Распаковка
-      union {
-        uint8_t b[4];
-        float f;
-      } roll_u, pitch_u;
-      for (int i = 0; i < 4; i++) {
-        roll_u.b[i] = buf[1 + i];
-        pitch_u.b[i] = buf[5 + i];
-      }
-
-      // Копируем в volatile-структуру атомарно (или через cli/sei)
-      AttitudePacket temp;
-      temp.roll = roll_u.f;
-      temp.pitch = pitch_u.f;
-      temp.mode = buf[9];
-
-      cli();
-      received = temp;
-      packet_ready = true;
-      sei();
-    }
-    idx = 0;
-  } else if (idx > 11) {
-    idx = 0; // защита от переполнения
+  if (pkt.mode == 0) {
+    // Мы — pitch-экран
+    draw_pitch_mode(screen, pkt.pitch);
+  } else {
+    // Мы — roll-экран
+    draw_roll_mode(screen, pkt.roll);
   }
+  if (screen->present)
+    screen->present();
+#ifdef SCREEN_PROFILE
+  if (profile_frames() >= PROFILE_REPORT_FRAMES)
+    profile_report(profile_put);
+#endif
 }
 
-int main(void) {
-  // Инициализация
-  st7735s_init();
+static SchedTask tasks[] = {
+    {.run = task_link, .period_us = LINK_POLL_US},
+    {.run = task_render, .period_us = 0},
+};
+
+// --- Старт: дисплей и приём канала ---
+
+static uint16_t boot_display(void) {
+  uint16_t ms = st7735s_init_step();
+  return (ms == ST7735S_INIT_DONE) ? BOOT_DONE : ms;
+}
+
+static uint16_t boot_link(void) {
+  link_decoder_init(&link_rx);
   uart_init_read();
+#if defined(BOOT_REPORT) || defined(SCREEN_PROFILE)
+  UCSR0B |= (1 << TXEN0); // отчёты о старте и шине — в свободный TX
+#endif
+  return BOOT_DONE;
+}
+
+static BootTask boot_tasks[] = {
+    {.name = "display", .step = boot_display},
+    {.name = "link", .step = boot_link},
+};
 
+int main(void) {
+  // Паузы старта меряет Timebase — часы нужны первыми
+  timebase_init();
   sei(); // разрешить прерывания
 
+  boot_run(boot_tasks, sizeof(boot_tasks) / sizeof(boot_tasks[0]));
+#ifdef BOOT_REPORT
+  boot_report(boot_tasks, sizeof(boot_tasks) / sizeof(boot_tasks[0]));
+#endif
+
   screen->clear(&BLACK);
 
-  while (1) {
-    if (packet_ready) {
-      cli();
-      AttitudePacket pkt = received;
-      packet_ready = false;
-      sei();
-
-      static uint8_t last_mode = 0xFF;
-      if (pkt.mode != last_mode) {
-        screen->clear(&BLACK);
-        roll_first_draw = true;
-        pitch_first_draw = true;
-        pitch_last_horizon_y = -1;
-        last_mode = pkt.mode;
-      }
-
-      if (pkt.mode == 0) {
-        // Мы — pitch-экран
-        draw_pitch_mode(screen, pkt.pitch);
-      } else {
-        // Мы — roll-экран
-        draw_roll_mode(screen, pkt.roll);
-      }
-    }
-  }
-}
\ No newline at end of file
+  sched_init(tasks, sizeof(tasks) / sizeof(tasks[0]));
+  while (1)
+    sched_run();
+}
@@ -0,0 +1,143 @@
+// Рендер на хосте: те же draw_roll_mode / draw_pitch_mode и тот же
+// драйвер lib/ST7735S, что на MCU2, только SPI уходит в панель в RAM
+// (native/st7735s_panel.c). Сценарий — качание по крену, затем по
+// тангажу, со сменой режима как в task_render. Для каждого кадра
+// печатается время рендера и что ушло в панель (счёт профилировщика
+// шины), в конце — отчёт профилировщика по функциям рендера. С каталогом
+// в аргументе кадры пишутся туда в PPM.
+//
+//   make native && ./native_160x128 frames
+//   make native DISPLAY_WIDTH=240 DISPLAY_HEIGHT=240
+#include "mcu.h"
+#include "./lib/Screen/profile_screen.h"
+#include "./native/st7735s_panel.h"
+#ifdef SCREEN_COMPOSITOR
+#include "./lib/Screen/compositor.h"
+#endif
+
+#include <stdio.h>
+#include <time.h>
+
+// Шаг сценария: режим как в пакете канала (0 — тангаж, 1 — крен), угол в °
+typedef struct {
+  uint8_t mode;
+  int8_t deg;
+} Frame;
+
+#define SWEEP_STEP 5
+#define SWEEP_MAX 45
+
+static uint16_t make_script(Frame *out) {
+  uint16_t n = 0;
+  for (uint8_t mode = 1; mode != 0xFF; mode--) {
+    // 0 → +max → -max → 0
+    for (int d = 0; d <= SWEEP_MAX; d += SWEEP_STEP)
+      out[n++] = (Frame){mode, d};
+    for (int d = SWEEP_MAX - SWEEP_STEP; d >= -SWEEP_MAX; d -= SWEEP_STEP)
+      out[n++] = (Frame){mode, d};
+    for (int d = -SWEEP_MAX + SWEEP_STEP; d <= 0; d += SWEEP_STEP)
+      out[n++] = (Frame){mode, d};
+  }
+  return n;
+}
+
+static uint64_t now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000u + ts.tv_nsec;
+}
+
+// Кадр как в task_render на MCU2
+static void render(const Frame *f) {
+  static uint8_t last_mode = 0xFF;
+  if (f->mode != last_mode) {
+    if (screen->scroll)
+      screen->scroll(0);
+    screen->clear(&BLACK);
+    roll_first_draw = true;
+    pitch_first_draw = true;
+    pitch_last_horizon_y = -1;
+    last_mode = f->mode;
+  }
+
+  float rad = f->deg * (M_PI / 180.0f);
+  if (f->mode == 0)
+    draw_pitch_mode(screen, rad);
+  else
+    draw_roll_mode(screen, rad);
+  if (screen->present)
+    screen->present();
+}
+
+static void put_stdout(uint8_t c) {
+  if (c != '\r')
+    putchar(c);
+}
+
+int main(int argc, char **argv) {
+  const char *dir = (argc > 1) ? argv[1] : NULL;
+
+  static Frame script[2 * (4 * SWEEP_MAX / SWEEP_STEP + 1)];
+  uint16_t n = make_script(script);
+
+  panel_attach();
+  st7735s_init();
+
+  uint64_t total_ns = 0;
+#ifdef SCREEN_COMPOSITOR
+  uint8_t ops_max = 0;
+#endif
+  printf("# %dx%d, %u frames\n", DISPLAY_WIDTH, DISPLAY_HEIGHT, n);
+  printf("# frame mode deg ns prims windows bytes\n");
+  for (uint16_t i = 0; i < n; i++) {
+    uint64_t t0 = now_ns();
+    render(&script[i]);
+    uint64_t ns = now_ns() - t0;
+
+    const ProfileCounters *c = profile_last_frame();
+    total_ns += ns;
+    printf("%u %s %d %llu %lu %lu %lu\n", i, script[i].mode ? "roll" : "pitch",
+           script[i].deg, (unsigned long long)ns, (unsigned long)c->prims,
+           (unsigned long)c->bus.windows,
+           (unsigned long)(c->bus.cmd_bytes + c->bus.arg_bytes +
+                           c->bus.pixel_bytes));
+
+#ifdef SCREEN_COMPOSITOR
+    // Кадр, не влезший в список компоновщика, рисовался бы с мерцанием
+    if (compositor_stats()->overflows) {
+      fprintf(stderr, "frame %u: compositor list overflow, raise "
+                      "COMPOSITOR_MAX_OPS\n", i);
+      return 1;
+    }
+    if (compositor_stats()->ops_max > ops_max)
+      ops_max = compositor_stats()->ops_max;
+#endif
+
+    if (dir) {
+      char path[256];
+      snprintf(path, sizeof(path), "%s/%03u_%s%+03d.ppm", dir, i,
+               script[i].mode ? "roll" : "pitch", script[i].deg);
+      if (!panel_write_ppm(path)) {
+        perror(path);
+        return 1;
+      }
+    }
+  }
+  printf("# render %llu ns/frame\n", (unsigned long long)(total_ns / n));
+  // Счёт драйвера против того, что панель приняла по шине
+  const PanelStats *ps = panel_stats();
+  const St7735sTraffic *t = st7735s_traffic();
+  printf("# panel %lu bytes, %lu pixels clipped\n", (unsigned long)ps->bytes,
+         (unsigned long)ps->clipped);
+  if (ps->bytes != t->cmd_bytes + t->arg_bytes + t->pixel_bytes) {
+    fprintf(stderr, "driver counted %lu bytes, panel got %lu\n",
+            (unsigned long)(t->cmd_bytes + t->arg_bytes + t->pixel_bytes),
+            (unsigned long)ps->bytes);
+    return 1;
+  }
+#ifdef SCREEN_COMPOSITOR
+  printf("# compositor ops max %u of %u\n", ops_max, COMPOSITOR_MAX_OPS);
+#endif
+  profile_report(put_stdout);
+  return 0;
+}
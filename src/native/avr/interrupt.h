@@ -0,0 +1,17 @@
+// ./native/avr/interrupt.h
+#ifndef NATIVE_INTERRUPT_H
+#define NATIVE_INTERRUPT_H
+
+// Обработчик — обычная функция: тест вызывает её сам, когда «пришло»
+// прерывание. sei/cli ведут флаг I в SREG, как на МК.
+
+#include <avr/io.h>
+
+#define ISR(vector, ...)                                                       \
+  void vector(void);                                                           \
+  void vector(void)
+
+#define sei() (SREG |= (1 << SREG_I))
+#define cli() (SREG &= (uint8_t) ~(1 << SREG_I))
+
+#endif // NATIVE_INTERRUPT_H
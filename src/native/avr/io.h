@@ -0,0 +1,64 @@
+// ./native/avr/io.h
+#ifndef NATIVE_IO_H
+#define NATIVE_IO_H
+
+// Сборка на хосте (make native, make test): регистры ATmega328P —
+// обычные переменные из native/avr_io.c. Тест пишет в них то, что
+// выставило бы железо, и читает то, что записал драйвер. Номера битов —
+// как у настоящего МК.
+
+#include <stdint.h>
+
+#define NATIVE_REG(name) extern volatile uint8_t name
+#define NATIVE_REG16(name) extern volatile uint16_t name
+
+NATIVE_REG(SREG);
+#define SREG_I 7
+
+// Порты
+NATIVE_REG(PORTB);
+NATIVE_REG(DDRB);
+NATIVE_REG(PINB);
+NATIVE_REG(PORTD);
+NATIVE_REG(DDRD);
+NATIVE_REG(PIND);
+enum { PB0, PB1, PB2, PB3, PB4, PB5, PB6, PB7 };
+enum { PD0, PD1, PD2, PD3, PD4, PD5, PD6, PD7 };
+
+// Timer1
+NATIVE_REG(TCCR1A);
+NATIVE_REG(TCCR1B);
+NATIVE_REG16(TCNT1);
+NATIVE_REG16(OCR1A);
+NATIVE_REG(TIMSK1);
+NATIVE_REG(TIFR1);
+enum { CS10, CS11, CS12, WGM12, WGM13 };
+enum { TOIE1, OCIE1A, OCIE1B };
+enum { TOV1, OCF1A, OCF1B };
+
+// USART0
+NATIVE_REG(UDR0);
+NATIVE_REG(UCSR0A);
+NATIVE_REG(UCSR0B);
+NATIVE_REG(UCSR0C);
+NATIVE_REG(UBRR0H);
+NATIVE_REG(UBRR0L);
+enum { MPCM0, U2X0, UPE0, DOR0, FE0, UDRE0, TXC0, RXC0 };
+enum { TXB80, RXB80, UCSZ02, TXEN0, RXEN0, UDRIE0, TXCIE0, RXCIE0 };
+enum { UCPOL0, UCSZ00, UCSZ01, USBS0, UPM00, UPM01 };
+
+// SPI. Запись в SPDR — байт на шину; следующее чтение SPSR отдаёт его
+// приёмнику native_spi_sink (панель в RAM, native/st7735s_panel.c) и
+// сразу показывает SPIF: передача мгновенная. SPDR шире байта, чтобы
+// отличать «байт ждёт» (0..255) от «пусто» (NATIVE_SPDR_EMPTY).
+NATIVE_REG(SPCR);
+extern volatile uint16_t native_spdr;
+#define NATIVE_SPDR_EMPTY 0xFFFF
+#define SPDR native_spdr
+volatile uint8_t *native_spsr(void);
+#define SPSR (*native_spsr())
+extern void (*native_spi_sink)(uint8_t c);
+enum { SPR0, SPR1, CPHA, CPOL, MSTR, DORD, SPE, SPIE };
+enum { SPI2X, WCOL = 6, SPIF };
+
+#endif // NATIVE_IO_H
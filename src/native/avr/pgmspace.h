@@ -0,0 +1,23 @@
+// ./native/avr/pgmspace.h
+#ifndef NATIVE_PGMSPACE_H
+#define NATIVE_PGMSPACE_H
+
+// Сборка рендера на хосте (make native): у хоста одно адресное
+// пространство, PROGMEM — обычная константа, чтение — разыменование.
+
+#include <stdint.h>
+#include <string.h>
+
+#define PROGMEM
+#define PSTR(s) (s)
+
+#define pgm_read_byte(addr) (*(const uint8_t *)(addr))
+#define pgm_read_word(addr) (*(const uint16_t *)(addr))
+#define pgm_read_dword(addr) (*(const uint32_t *)(addr))
+#define pgm_read_ptr(addr) (*(void *const *)(addr))
+
+#define memcpy_P memcpy
+#define strcpy_P strcpy
+#define strlen_P strlen
+
+#endif // NATIVE_PGMSPACE_H
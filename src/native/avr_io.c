@@ -0,0 +1,29 @@
+// ./native/avr_io.c
+// Регистры ATmega328P для хостовых сборок (см. native/avr/io.h)
+#include <avr/io.h>
+
+volatile uint8_t SREG;
+
+volatile uint8_t PORTB, DDRB, PINB;
+volatile uint8_t PORTD, DDRD, PIND;
+
+volatile uint8_t TCCR1A, TCCR1B, TIMSK1, TIFR1;
+volatile uint16_t TCNT1, OCR1A;
+
+volatile uint8_t UDR0, UCSR0A, UCSR0B, UCSR0C, UBRR0H, UBRR0L;
+
+volatile uint8_t SPCR;
+volatile uint16_t native_spdr = NATIVE_SPDR_EMPTY;
+void (*native_spi_sink)(uint8_t c);
+static volatile uint8_t spsr;
+
+volatile uint8_t *native_spsr(void) {
+  if (native_spdr != NATIVE_SPDR_EMPTY) {
+    uint8_t c = native_spdr;
+    native_spdr = NATIVE_SPDR_EMPTY;
+    if (native_spi_sink)
+      native_spi_sink(c);
+  }
+  spsr |= 1 << SPIF;
+  return &spsr;
+}
@@ -0,0 +1,124 @@
+// Панель ST7735S в RAM (см. native/st7735s_panel.h)
+#include "st7735s_panel.h"
+
+#include <stdio.h>
+#include <string.h>
+
+uint16_t panel_gram[PANEL_LINES][DISPLAY_WIDTH];
+
+static PanelStats stats;
+
+// Разбор потока: текущая команда, её аргументы и указатель записи
+static uint8_t cmd;
+static uint8_t args[6];
+static uint8_t argc;
+static int16_t pixel_hi = -1; // старший байт пикселя, ждущий младшего
+
+static uint16_t col0, col1, row0, row1; // окно CASET/RASET
+static uint16_t wx, wy;                 // куда ляжет следующий пиксель
+
+// VSCRDEF и VSCRSADD; без VSCRDEF прокрутки нет
+static bool scroll_defined;
+static uint16_t tfa, vsa, ssa;
+
+static uint16_t be16(const uint8_t *p) { return (p[0] << 8) | p[1]; }
+
+static void command(uint8_t c) {
+  cmd = c;
+  argc = 0;
+  pixel_hi = -1;
+  if (cmd == 0x2C) { // RAMWR: запись с начала окна
+    wx = col0;
+    wy = row0;
+  }
+}
+
+static void pixel(uint16_t color) {
+  if (wy < PANEL_LINES && wx < DISPLAY_WIDTH)
+    panel_gram[wy][wx] = color;
+  else
+    stats.clipped++;
+  if (++wx > col1) {
+    wx = col0;
+    if (++wy > row1)
+      wy = row0; // за концом окна запись идёт с его начала
+  }
+}
+
+static void data(uint8_t c) {
+  if (cmd == 0x2C) {
+    if (pixel_hi < 0) {
+      pixel_hi = c;
+    } else {
+      pixel((pixel_hi << 8) | c);
+      pixel_hi = -1;
+    }
+    return;
+  }
+  if (argc < sizeof(args))
+    args[argc++] = c;
+  if (cmd == 0x2A && argc == 4) { // CASET
+    col0 = be16(args);
+    col1 = be16(args + 2);
+  } else if (cmd == 0x2B && argc == 4) { // RASET
+    row0 = be16(args);
+    row1 = be16(args + 2);
+  } else if (cmd == 0x33 && argc == 6) { // VSCRDEF
+    tfa = be16(args);
+    vsa = be16(args + 2);
+    scroll_defined = true;
+  } else if (cmd == 0x37 && argc == 2) { // VSCRSADD
+    ssa = be16(args);
+  }
+}
+
+static void spi_byte(uint8_t c) {
+  if (PORTB & (1 << CS_PIN))
+    return; // панель не выбрана
+  stats.bytes++;
+  if (PORTB & (1 << DC_PIN))
+    data(c);
+  else
+    command(c);
+}
+
+void panel_attach(void) {
+  memset(panel_gram, 0, sizeof(panel_gram));
+  memset(&stats, 0, sizeof(stats));
+  command(0x00);
+  col0 = row0 = 0;
+  col1 = DISPLAY_WIDTH - 1;
+  row1 = PANEL_LINES - 1;
+  scroll_defined = false;
+  native_spi_sink = spi_byte;
+}
+
+const PanelStats *panel_stats(void) { return &stats; }
+
+// Строка памяти, которую показывает строка экрана row
+static uint16_t visible_line(uint16_t row) {
+  if (!scroll_defined || row < tfa || row >= tfa + vsa || !vsa)
+    return row;
+  return tfa + (row - tfa + ssa - tfa + vsa) % vsa;
+}
+
+bool panel_write_ppm(const char *path) {
+  FILE *f = fopen(path, "wb");
+  if (!f)
+    return false;
+
+  fprintf(f, "P6\n%d %d\n255\n", DISPLAY_WIDTH, DISPLAY_HEIGHT);
+  for (uint16_t row = 0; row < DISPLAY_HEIGHT; row++) {
+    const uint16_t *line = panel_gram[visible_line(row)];
+    for (uint16_t x = 0; x < DISPLAY_WIDTH; x++) {
+      // 5/6 бит → 8 с повтором старших бит, чтобы белый был 255
+      uint8_t r = (line[x] >> 11) & 0x1F, g = (line[x] >> 5) & 0x3F,
+              b = line[x] & 0x1F;
+      uint8_t rgb[3] = {(r << 3) | (r >> 2), (g << 2) | (g >> 4),
+                        (b << 3) | (b >> 2)};
+      fwrite(rgb, 1, sizeof(rgb), f);
+    }
+  }
+  bool ok = !ferror(f);
+  return fclose(f) == 0 && ok;
+}
@@ -0,0 +1,39 @@
+// ./native/st7735s_panel.h
+#ifndef NATIVE_ST7735S_PANEL_H
+#define NATIVE_ST7735S_PANEL_H
+
+// Панель ST7735S в RAM для сборки на хосте (make native): настоящий
+// драйвер lib/ST7735S пишет в SPDR, байты приходят сюда через
+// native_spi_sink и разбираются, как их разобрал бы контроллер: DC
+// (PB0) и CS (PB2) — из PORTB, окно CASET/RASET, запись RAMWR,
+// прокрутка VSCRDEF/VSCRSADD. Снимок — то, что покажет панель.
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "../lib/ST7735S/ST7735S.h"
+
+// Строк памяти: у ST7735S 162, на больших экранах — по высоте
+#if DISPLAY_HEIGHT > ST7735S_GRAM_LINES
+#define PANEL_LINES DISPLAY_HEIGHT
+#else
+#define PANEL_LINES ST7735S_GRAM_LINES
+#endif
+
+typedef struct {
+  uint32_t bytes;   // принято при опущенном CS
+  uint32_t clipped; // пикселей за пределами памяти
+} PanelStats;
+
+// Подключает панель к шине и очищает память; до st7735s_init
+void panel_attach(void);
+
+const PanelStats *panel_stats(void);
+
+// Память кадра: строки памяти, без учёта прокрутки
+extern uint16_t panel_gram[PANEL_LINES][DISPLAY_WIDTH];
+
+// Видимое на экране (с учётом прокрутки) в PPM P6; false — ошибка записи
+bool panel_write_ppm(const char *path);
+
+#endif // NATIVE_ST7735S_PANEL_H
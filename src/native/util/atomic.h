@@ -0,0 +1,17 @@
+// ./native/util/atomic.h
+#ifndef NATIVE_ATOMIC_H
+#define NATIVE_ATOMIC_H
+
+// На хосте прерываний нет: блок только снимает и восстанавливает флаг I,
+// чтобы код, смотрящий на SREG, вёл себя как на МК.
+
+#include <avr/interrupt.h>
+
+#define ATOMIC_RESTORESTATE
+#define ATOMIC_FORCEON
+
+#define ATOMIC_BLOCK(type)                                                     \
+  for (uint8_t native_sreg_ = SREG, native_once_ = (cli(), 1); native_once_;  \
+       SREG = native_sreg_, native_once_ = 0)
+
+#endif // NATIVE_ATOMIC_H
@@ -0,0 +1,10 @@
+// ./native/util/delay.h
+#ifndef NATIVE_DELAY_H
+#define NATIVE_DELAY_H
+
+// На хосте ждать некого: паузы драйверов (сброс панели и т.п.) пустые
+
+#define _delay_ms(ms) ((void)(ms))
+#define _delay_us(us) ((void)(us))
+
+#endif // NATIVE_DELAY_H
@@ -0,0 +1,30 @@
+// ./tests/check.h
+#ifndef TESTS_CHECK_H
+#define TESTS_CHECK_H
+
+// Проверки для тестов на хосте (make test): неудача печатается с местом
+// и не останавливает тест, итог — код возврата check_done().
+
+#include <stdio.h>
+
+static unsigned check_failed = 0;
+static unsigned check_total = 0;
+
+#define CHECK(cond, ...)                                                       \
+  do {                                                                         \
+    check_total++;                                                             \
+    if (!(cond)) {                                                             \
+      check_failed++;                                                          \
+      printf("%s:%d: ", __FILE__, __LINE__);                                   \
+      printf(__VA_ARGS__);                                                     \
+      putchar('\n');                                                           \
+    }                                                                          \
+  } while (0)
+
+// Строка итога и код возврата main
+static inline int check_done(const char *name) {
+  printf("%s: %u checks, %u failed\n", name, check_total, check_failed);
+  return check_failed ? 1 : 0;
+}
+
+#endif // TESTS_CHECK_H
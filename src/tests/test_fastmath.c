@@ -0,0 +1,154 @@
+// FastMath против libm (double) перебором по диапазонам: наибольшие
+// ошибки не выходят за границы из таблицы в lib/FastMath/fastmath.h.
+#include "../lib/FastMath/fastmath.h"
+#include "check.h"
+
+#include <math.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// Границы из fastmath.h
+#define ATAN2F_MAX_RAD 0.00151
+#define SQRTF_MAX_REL 0.0018
+#define SINF_MAX 1.3e-4
+#define ATAN2_BAM_MAX 2
+#define SIN_BAM_MAX 4
+
+// Разность углов по кругу, в тех же единицах, что период
+static double wrap(double d, double period) {
+  return fabs(remainder(d, period));
+}
+
+static void test_atan2f(void) {
+  double worst = 0;
+  for (float y = -3.0f; y <= 3.0f; y += 0.0031f) {
+    for (float x = -3.0f; x <= 3.0f; x += 0.0029f) {
+      double e = wrap(fm_atan2f(y, x) - atan2(y, x), 2 * M_PI);
+      if (e > worst)
+        worst = e;
+    }
+  }
+  // Оси и начало координат — отдельные ветки
+  CHECK(fm_atan2f(0.0f, 1.0f) == 0.0f, "atan2f(0, 1) = %g",
+        fm_atan2f(0.0f, 1.0f));
+  CHECK(fabs(fm_atan2f(1.0f, 0.0f) - M_PI / 2) <= ATAN2F_MAX_RAD,
+        "atan2f(1, 0) = %g", fm_atan2f(1.0f, 0.0f));
+  CHECK(fm_atan2f(0.0f, 0.0f) == 0.0f, "atan2f(0, 0) = %g",
+        fm_atan2f(0.0f, 0.0f));
+  CHECK(worst <= ATAN2F_MAX_RAD, "atan2f max error %.6f rad", worst);
+}
+
+static void test_sqrtf(void) {
+  double worst_sqrt = 0, worst_rsqrt = 0;
+  for (float x = 1e-6f; x < 1e6f; x *= 1.0001f) {
+    double e = fabs(fm_sqrtf(x) / sqrt(x) - 1);
+    if (e > worst_sqrt)
+      worst_sqrt = e;
+    e = fabs(fm_rsqrtf(x) * sqrt(x) - 1);
+    if (e > worst_rsqrt)
+      worst_rsqrt = e;
+  }
+  CHECK(fm_sqrtf(0.0f) == 0.0f, "sqrtf(0) = %g", fm_sqrtf(0.0f));
+  CHECK(fm_sqrtf(-1.0f) == 0.0f, "sqrtf(-1) = %g", fm_sqrtf(-1.0f));
+  CHECK(worst_sqrt <= SQRTF_MAX_REL, "sqrtf max error %.6f", worst_sqrt);
+  CHECK(worst_rsqrt <= SQRTF_MAX_REL, "rsqrtf max error %.6f", worst_rsqrt);
+}
+
+static void test_sincosf(void) {
+  double worst_sin = 0, worst_cos = 0;
+  for (float x = -20.0f; x < 20.0f; x += 0.00013f) {
+    double e = fabs(fm_sinf(x) - sin(x));
+    if (e > worst_sin)
+      worst_sin = e;
+    e = fabs(fm_cosf(x) - cos(x));
+    if (e > worst_cos)
+      worst_cos = e;
+  }
+  CHECK(worst_sin <= SINF_MAX, "sinf max error %.2e", worst_sin);
+  CHECK(worst_cos <= SINF_MAX, "cosf max error %.2e", worst_cos);
+}
+
+static void test_roundf(void) {
+  unsigned bad = 0;
+  float first_bad = 0;
+  for (float x = -1e5f; x < 1e5f; x += 0.25f * 1.0001f) {
+    if (fm_roundf(x) != roundf(x) && !bad++)
+      first_bad = x;
+  }
+  CHECK(!bad, "roundf: %u mismatches, first at %.9g", bad, first_bad);
+
+  // Половины — от нуля; чуть меньше половины — вниз
+  static const float edges[] = {0.5f,  -0.5f, 1.5f,        -2.5f,
+                                2.5f, 0.49999997f, -0.49999997f,
+                                8388607.5f, -8388607.5f};
+  for (unsigned i = 0; i < sizeof(edges) / sizeof(edges[0]); i++)
+    CHECK(fm_roundf(edges[i]) == roundf(edges[i]), "roundf(%.9g) = %.9g",
+          edges[i], fm_roundf(edges[i]));
+}
+
+static void test_atan2_bam(void) {
+  double worst = 0;
+  for (int32_t y = -65535; y < 65536; y += 31) {
+    for (int32_t x = -65535; x < 65536; x += 47) {
+      double e = wrap(fm_atan2_bam(y, x) - atan2(y, x) * 32768 / M_PI, 65536);
+      if (e > worst)
+        worst = e;
+    }
+  }
+  CHECK(fm_atan2_bam(0, 0) == 0, "atan2_bam(0, 0) = %d", fm_atan2_bam(0, 0));
+  CHECK(fm_atan2_bam(1, 0) == 16384, "atan2_bam(1, 0) = %d",
+        fm_atan2_bam(1, 0));
+  CHECK(fm_atan2_bam(0, -1) == -32768, "atan2_bam(0, -1) = %d",
+        fm_atan2_bam(0, -1));
+  CHECK(worst <= ATAN2_BAM_MAX, "atan2_bam max error %.3f units", worst);
+}
+
+static void test_sin_bam(void) {
+  double worst = 0;
+  for (uint32_t a = 0; a < 65536; a++) {
+    double e = fabs(fm_sin_bam(a) - sin(a * M_PI / 32768) * 32767);
+    if (e > worst)
+      worst = e;
+    e = fabs(fm_cos_bam(a) - cos(a * M_PI / 32768) * 32767);
+    if (e > worst)
+      worst = e;
+  }
+  CHECK(worst <= SIN_BAM_MAX, "sin/cos_bam max error %.3f q15", worst);
+}
+
+// floor(sqrt(v)) ровно: на всех границах квадратов и по всему диапазону
+static void test_isqrt32(void) {
+  unsigned bad = 0;
+  uint32_t first_bad = 0;
+  for (uint32_t k = 1; k <= 65535; k++) {
+    uint32_t sq = k * k;
+    if (fm_isqrt32(sq) != k || fm_isqrt32(sq - 1) != k - 1) {
+      if (!bad++)
+        first_bad = sq;
+    }
+  }
+  for (uint64_t v = 0; v <= 0xFFFFFFFFull; v += (v < 100000 ? 1 : 7919)) {
+    uint64_t r = fm_isqrt32((uint32_t)v);
+    if (r * r > v || (r + 1) * (r + 1) <= v) {
+      if (!bad++)
+        first_bad = (uint32_t)v;
+    }
+  }
+  CHECK(fm_isqrt32(0xFFFFFFFFu) == 65535, "isqrt32(2^32-1) = %u",
+        fm_isqrt32(0xFFFFFFFFu));
+  CHECK(!bad, "isqrt32: %u wrong, first at %lu", bad,
+        (unsigned long)first_bad);
+}
+
+int main(void) {
+  test_atan2f();
+  test_sqrtf();
+  test_sincosf();
+  test_roundf();
+  test_atan2_bam();
+  test_sin_bam();
+  test_isqrt32();
+  return check_done("fastmath");
+}
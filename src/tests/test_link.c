@@ -0,0 +1,278 @@
+// Кодек канала MCU1 → MCU2 (lib/Link): кадры туда и обратно и поток с
+// порчей — инвертированные биты, оборванные кадры, потерянные
+// разделители, текст и случайный мусор между кадрами. Испорченный кадр
+// может пропасть, но не должен выдать чужие углы, а следующий целый кадр
+// должен приниматься.
+#include "../lib/Link/link.h"
+#include "check.h"
+
+#include <string.h>
+
+// Воспроизводимый генератор: xorshift32
+static uint32_t rng = 0x12345678;
+static uint32_t next_rand(void) {
+  rng ^= rng << 13;
+  rng ^= rng >> 17;
+  rng ^= rng << 5;
+  return rng;
+}
+
+static LinkFrame random_frame(uint8_t seq) {
+  LinkFrame f;
+  f.seq = seq;
+  f.mode = next_rand() & 0x0F;
+  // Чаще нули и крайние значения: на них COBS работает больше всего
+  static const int16_t special[] = {0, 1, -1, 256, -256, 32767, -32768,
+                                    18000, -18000};
+  uint32_t r = next_rand();
+  f.roll_cd = (r & 3) ? (int16_t)r : special[(r >> 8) % 9];
+  r = next_rand();
+  f.pitch_cd = (r & 3) ? (int16_t)r : special[(r >> 8) % 9];
+  return f;
+}
+
+static bool same(const LinkFrame *a, const LinkFrame *b) {
+  return a->seq == b->seq && a->mode == b->mode && a->roll_cd == b->roll_cd &&
+         a->pitch_cd == b->pitch_cd;
+}
+
+// Поток в декодер. Каждый принятый кадр сверяется с ожидаемыми: чужой
+// (ни один из expected) считается ложным
+typedef struct {
+  LinkDecoder dec;
+  unsigned accepted;
+  unsigned wrong;
+  const LinkFrame *expected;
+  unsigned expected_count;
+} Sink;
+
+static void sink_init(Sink *s, const LinkFrame *expected, unsigned count) {
+  link_decoder_init(&s->dec);
+  s->accepted = 0;
+  s->wrong = 0;
+  s->expected = expected;
+  s->expected_count = count;
+}
+
+static void feed(Sink *s, const uint8_t *data, unsigned n) {
+  for (unsigned i = 0; i < n; i++) {
+    LinkFrame f;
+    if (!link_decode_byte(&s->dec, data[i], &f))
+      continue;
+    s->accepted++;
+    bool known = false;
+    for (unsigned j = 0; j < s->expected_count && !known; j++)
+      known = same(&f, &s->expected[j]);
+    if (!known)
+      s->wrong++;
+  }
+}
+
+// Кадр: нули только по краям, длина LINK_FRAME_MAX, обратно — то же
+static void test_round_trip(void) {
+  unsigned bad_shape = 0, bad_decode = 0;
+  for (unsigned i = 0; i < 100000; i++) {
+    LinkFrame f = random_frame(i);
+    uint8_t out[LINK_FRAME_MAX];
+    uint8_t n = link_encode(&f, out);
+    bool shape = n == LINK_FRAME_MAX && out[0] == 0 && out[n - 1] == 0;
+    for (uint8_t j = 1; j + 1 < n; j++)
+      if (!out[j])
+        shape = false;
+    if (!shape)
+      bad_shape++;
+
+    Sink s;
+    sink_init(&s, &f, 1);
+    feed(&s, out, n);
+    if (s.accepted != 1 || s.wrong || s.dec.errors)
+      bad_decode++;
+  }
+  CHECK(!bad_shape, "round trip: %u frames with bad framing", bad_shape);
+  CHECK(!bad_decode, "round trip: %u frames not decoded back", bad_decode);
+}
+
+// Кадры подряд: все приняты, ни ошибок, ни потерь; пропуск номеров
+// виден в lost
+static void test_stream(void) {
+  LinkFrame frames[64];
+  Sink s;
+  sink_init(&s, frames, 64);
+  for (unsigned i = 0; i < 64; i++) {
+    frames[i] = random_frame(i < 40 ? i : i + 3); // 3 номера пропущены
+    uint8_t out[LINK_FRAME_MAX];
+    feed(&s, out, link_encode(&frames[i], out));
+  }
+  CHECK(s.accepted == 64 && !s.wrong, "stream: %u accepted, %u wrong",
+        s.accepted, s.wrong);
+  CHECK(s.dec.frames == 64 && s.dec.errors == 0,
+        "stream: frames %u errors %u", s.dec.frames, s.dec.errors);
+  CHECK(s.dec.lost == 3, "stream: lost %u, expected 3", s.dec.lost);
+}
+
+// Каждый бит каждого байта кадра (и разделителей): испорченный кадр не
+// выдаёт чужих углов, следующий целый — принимается
+static void test_bit_flips(void) {
+  unsigned wrong = 0, not_recovered = 0, total = 0;
+  for (unsigned i = 0; i < 2000; i++) {
+    LinkFrame pair[2] = {random_frame(2 * i), random_frame(2 * i + 1)};
+    uint8_t a[LINK_FRAME_MAX], b[LINK_FRAME_MAX];
+    uint8_t na = link_encode(&pair[0], a);
+    uint8_t nb = link_encode(&pair[1], b);
+    for (uint8_t byte = 0; byte < na; byte++) {
+      for (uint8_t bit = 0; bit < 8; bit++) {
+        uint8_t bad[LINK_FRAME_MAX];
+        memcpy(bad, a, na);
+        bad[byte] ^= 1 << bit;
+
+        // pair[0] после порчи принят быть не может
+        Sink s;
+        sink_init(&s, &pair[1], 1);
+        feed(&s, bad, na);
+        unsigned before = s.accepted;
+        feed(&s, b, nb);
+        wrong += s.wrong;
+        // Порча последнего нуля склеивает кадры до нуля в начале b —
+        // b всё равно принят
+        if (s.accepted - before != 1)
+          not_recovered++;
+        total++;
+      }
+    }
+  }
+  CHECK(!wrong, "bit flips: %u of %u corrupted frames accepted", wrong,
+        total);
+  CHECK(!not_recovered, "bit flips: next frame lost %u of %u times",
+        not_recovered, total);
+}
+
+// Кадр оборван на любом байте (передатчик сброшен, линия выдернута) —
+// следующий кадр принимается благодаря нулю в его начале
+static void test_truncation(void) {
+  unsigned wrong = 0, lost = 0, total = 0;
+  for (unsigned i = 0; i < 2000; i++) {
+    LinkFrame pair[2] = {random_frame(2 * i), random_frame(2 * i + 1)};
+    uint8_t a[LINK_FRAME_MAX], b[LINK_FRAME_MAX];
+    uint8_t na = link_encode(&pair[0], a);
+    uint8_t nb = link_encode(&pair[1], b);
+    for (uint8_t cut = 1; cut < na - 1; cut++) {
+      Sink s;
+      sink_init(&s, &pair[1], 1);
+      feed(&s, a, cut);
+      feed(&s, b, nb);
+      wrong += s.wrong;
+      if (s.accepted != 1)
+        lost++;
+      total++;
+    }
+  }
+  CHECK(!wrong, "truncation: %u wrong frames", wrong);
+  CHECK(!lost, "truncation: next frame lost %u of %u times", lost, total);
+}
+
+// Пропал один из нулей между кадрами: второй разделитель спасает оба.
+// Пропали оба — склеенный кусок отбрасывается, третий кадр принят
+static void test_lost_delimiter(void) {
+  unsigned one_lost = 0, both_wrong = 0, both_not_recovered = 0;
+  for (unsigned i = 0; i < 2000; i++) {
+    LinkFrame f[3] = {random_frame(3 * i), random_frame(3 * i + 1),
+                      random_frame(3 * i + 2)};
+    uint8_t e[3][LINK_FRAME_MAX];
+    uint8_t n[3];
+    for (int k = 0; k < 3; k++)
+      n[k] = link_encode(&f[k], e[k]);
+
+    // Без хвостового нуля первого кадра
+    Sink s;
+    sink_init(&s, f, 2);
+    feed(&s, e[0], n[0] - 1);
+    feed(&s, e[1], n[1]);
+    if (s.accepted != 2 || s.wrong)
+      one_lost++;
+
+    // Без начального нуля второго
+    sink_init(&s, f, 2);
+    feed(&s, e[0], n[0]);
+    feed(&s, e[1] + 1, n[1] - 1);
+    if (s.accepted != 2 || s.wrong)
+      one_lost++;
+
+    // Без обоих: первые два склеены
+    sink_init(&s, f, 3);
+    feed(&s, e[0], n[0] - 1);
+    feed(&s, e[1] + 1, n[1] - 1);
+    feed(&s, e[2], n[2]);
+    both_wrong += s.wrong;
+    if (s.accepted != 1)
+      both_not_recovered++;
+  }
+  CHECK(!one_lost, "lost 0x00: %u frames lost to a single missing zero",
+        one_lost);
+  CHECK(!both_wrong, "lost 0x00: %u merged frames accepted", both_wrong);
+  CHECK(!both_not_recovered, "lost 0x00: frame after merge lost %u times",
+        both_not_recovered);
+}
+
+// Текст в линии перед кадром (отчёт старта, профилировщик) — без нуля
+// на конце. Кадр после него принимается
+static void test_text_before_frame(void) {
+  static const char text[] = "boot display 685.2 ms\r\nprof frame us=1234\r\n";
+  LinkFrame f = random_frame(7);
+  uint8_t out[LINK_FRAME_MAX];
+  uint8_t n = link_encode(&f, out);
+  Sink s;
+  sink_init(&s, &f, 1);
+  feed(&s, (const uint8_t *)text, sizeof(text) - 1);
+  feed(&s, out, n);
+  CHECK(s.accepted == 1 && !s.wrong, "text: %u accepted, %u wrong",
+        s.accepted, s.wrong);
+  CHECK(s.dec.errors == 1, "text: %u errors, expected 1", s.dec.errors);
+}
+
+// Случайный мусор между кадрами: каждый целый кадр после мусора принят,
+// из самого мусора кадров почти не бывает (CRC-8 и версия — 1 из 4096
+// для куска правильной длины и с правильным COBS)
+static void test_garbage(void) {
+  enum { ROUNDS = 20000 };
+  unsigned lost = 0;
+  Sink s;
+  LinkFrame f;
+  sink_init(&s, &f, 1);
+  unsigned garbage_bytes = 0, false_frames = 0;
+  for (unsigned i = 0; i < ROUNDS; i++) {
+    // Мусор: 0..63 байт, нули в нём реже прочих
+    unsigned k = next_rand() % 64;
+    for (unsigned j = 0; j < k; j++) {
+      uint8_t c = next_rand() >> 24;
+      unsigned before = s.accepted;
+      feed(&s, &c, 1);
+      false_frames += s.accepted - before;
+    }
+    garbage_bytes += k;
+    s.wrong = 0; // ложные кадры из мусора считаются выше
+
+    f = random_frame(i);
+    uint8_t out[LINK_FRAME_MAX];
+    uint8_t n = link_encode(&f, out);
+    unsigned before = s.accepted;
+    feed(&s, out, n);
+    if (s.accepted - before != 1 || s.wrong)
+      lost++;
+  }
+  CHECK(!lost, "garbage: %u of %u frames lost after garbage", lost,
+        (unsigned)ROUNDS);
+  CHECK(false_frames * 100000ull <= garbage_bytes,
+        "garbage: %u false frames from %u bytes", false_frames,
+        garbage_bytes);
+}
+
+int main(void) {
+  test_round_trip();
+  test_stream();
+  test_bit_flips();
+  test_truncation();
+  test_lost_delimiter();
+  test_text_before_frame();
+  test_garbage();
+  return check_done("link");
+}
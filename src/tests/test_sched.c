@@ -0,0 +1,163 @@
+// Планировщик на имитированных часах: timebase_micros() отдаёт счётчик
+// теста, задачи «тратят» время, сдвигая его. Проверяются сроки без
+// дрейфа, приоритет, учёт перегрузок, sched_yield внутри долгой задачи
+// и переход часов через 2^32.
+#include "../lib/Sched/sched.h"
+#include "check.h"
+
+static uint32_t now_us;
+
+uint32_t timebase_micros(void) { return now_us; }
+
+// Главный цикл: если ничего не наступило, часы идут дальше
+static void run_until(uint32_t end_us) {
+  while ((int32_t)(now_us - end_us) < 0) {
+    uint32_t before = now_us;
+    sched_run();
+    if (now_us == before)
+      now_us += 10;
+  }
+}
+
+// Журнал запусков: кто и когда
+#define LOG_SIZE 256
+static char log_name[LOG_SIZE];
+static uint32_t log_time[LOG_SIZE];
+static unsigned log_len;
+
+static void log_run(char name) {
+  if (log_len < LOG_SIZE) {
+    log_name[log_len] = name;
+    log_time[log_len] = now_us;
+    log_len++;
+  }
+}
+
+static void task_fast(void) {
+  log_run('f');
+  now_us += 100;
+}
+
+static void task_mid(void) {
+  log_run('m');
+  now_us += 300;
+}
+
+static void task_slow(void) {
+  log_run('s');
+  now_us += 2500;
+}
+
+// Долгая задача: 10 кусков по 500 мкс, между ними — sched_yield
+static void task_render(void) {
+  log_run('r');
+  for (int i = 0; i < 10; i++) {
+    now_us += 500;
+    sched_yield();
+  }
+}
+
+static unsigned background_runs;
+static void task_background(void) { background_runs++; }
+
+static void start(SchedTask *tasks, uint8_t count, uint32_t t0) {
+  now_us = t0;
+  log_len = 0;
+  background_runs = 0;
+  sched_init(tasks, count);
+}
+
+// Сроки отсчитываются от прошлого срока: за 100 периодов ровно 100
+// запусков, каждый — в свой срок
+static void test_period(void) {
+  SchedTask tasks[] = {{.run = task_mid, .period_us = 1000}};
+  start(tasks, 1, 0);
+  run_until(100000);
+  CHECK(tasks[0].runs == 100, "period: %u runs", tasks[0].runs);
+  CHECK(tasks[0].overruns == 0, "period: %u overruns", tasks[0].overruns);
+  CHECK(tasks[0].worst_us == 300, "period: worst %lu us",
+        (unsigned long)tasks[0].worst_us);
+  unsigned late = 0;
+  for (unsigned i = 0; i < log_len; i++)
+    if (log_time[i] - i * 1000 > 10)
+      late++;
+  CHECK(!late, "period: %u runs later than 10 us", late);
+}
+
+// Из наступивших первой идёт задача выше в массиве; фоновые — только
+// когда сроков нет
+static void test_priority(void) {
+  SchedTask tasks[] = {{.run = task_fast, .period_us = 1000},
+                       {.run = task_mid, .period_us = 1000},
+                       {.run = task_background, .period_us = 0}};
+  start(tasks, 3, 0);
+  sched_run();
+  sched_run();
+  CHECK(log_len == 2 && log_name[0] == 'f' && log_name[1] == 'm',
+        "priority: order %.*s", (int)log_len, log_name);
+  CHECK(background_runs == 0, "priority: background ran while due");
+  sched_run();
+  CHECK(background_runs == 1, "priority: background %u runs",
+        background_runs);
+}
+
+// Задача дольше своего периода: пропущенные сроки считаются, следующий
+// срок — от момента запуска, без очереди догоняющих запусков
+static void test_overrun(void) {
+  SchedTask tasks[] = {{.run = task_slow, .period_us = 1000}};
+  start(tasks, 1, 0);
+  run_until(10000);
+  CHECK(tasks[0].runs == 4, "overrun: %u runs", tasks[0].runs);
+  CHECK(tasks[0].overruns == 3, "overrun: %u overruns", tasks[0].overruns);
+  for (unsigned i = 1; i < log_len; i++)
+    CHECK(log_time[i] - log_time[i - 1] == 2500, "overrun: gap %lu us",
+          (unsigned long)(log_time[i] - log_time[i - 1]));
+}
+
+// Во время долгой задачи срочная отрабатывает из sched_yield с
+// задержкой не больше куска; время вложенных задач не идёт в worst_us
+// долгой
+static void test_yield(void) {
+  SchedTask tasks[] = {{.run = task_fast, .period_us = 1000},
+                       {.run = task_render, .period_us = 30000}};
+  start(tasks, 2, 0);
+  run_until(60000);
+  CHECK(tasks[0].overruns == 0, "yield: fast %u overruns",
+        tasks[0].overruns);
+  CHECK(tasks[0].runs >= 59, "yield: fast %u runs", tasks[0].runs);
+  CHECK(tasks[1].runs == 2, "yield: render %u runs", tasks[1].runs);
+  CHECK(tasks[1].worst_us == 5000, "yield: render worst %lu us",
+        (unsigned long)tasks[1].worst_us);
+  CHECK(tasks[0].worst_us == 100, "yield: fast worst %lu us",
+        (unsigned long)tasks[0].worst_us);
+
+  uint32_t deadline = 0, worst_delay = 0;
+  for (unsigned i = 0; i < log_len; i++) {
+    if (log_name[i] != 'f')
+      continue;
+    uint32_t delay = log_time[i] - deadline;
+    if (delay > worst_delay)
+      worst_delay = delay;
+    deadline += 1000;
+  }
+  CHECK(worst_delay <= 600, "yield: fast delayed by %lu us",
+        (unsigned long)worst_delay);
+}
+
+// Часы переходят через 2^32 (≈71 мин): сроки сравниваются по разности
+static void test_wrap(void) {
+  SchedTask tasks[] = {{.run = task_mid, .period_us = 1000}};
+  start(tasks, 1, 0u - 4500);
+  run_until(5500);
+  CHECK(tasks[0].runs == 10, "wrap: %u runs", tasks[0].runs);
+  CHECK(tasks[0].overruns == 0, "wrap: %u overruns", tasks[0].overruns);
+}
+
+int main(void) {
+  test_period();
+  test_priority();
+  test_overrun();
+  test_yield();
+  test_wrap();
+  return check_done("sched");
+}
@@ -0,0 +1,348 @@
+// Передача UART на имитированной линии: прерывание UDRE вызывается раз
+// в байт линии, ушедшие байты разбираются, как их разобрали бы MCU2 и
+// хост. Пакеты ориентации идут через слот, кадры записи (lib/Record) или
+// телеметрии (lib/Telemetry) — через кольцо, вперемешку и с разными
+// фазами. Ни один кадр не должен разорваться другим, пакет ориентации не
+// ждёт дольше кадра кольца. Строки текста уходят только в свободную
+// линию и пакетов не рвут.
+#include "../lib/Link/link.h"
+#include "../lib/Record/record.h"
+#include "../lib/Telemetry/telemetry.h"
+#include "../lib/UART/uart.h"
+#include "check.h"
+
+#include <avr/interrupt.h>
+#include <stdio.h>
+#include <string.h>
+
+void USART_UDRE_vect(void);
+
+// Байт на линии: старт, 8 бит, стоп
+#define BYTE_US (10 * 1000000UL / UART_BAUD_REAL)
+
+static uint32_t now_us;
+
+// Приёмник: MCU2 (LinkDecoder) и хост — кадры между нулями по тегу
+typedef struct {
+  LinkDecoder link;
+  uint8_t chunk[256];
+  uint16_t len;
+  unsigned link_frames; // пакетов ориентации, проверенных по отправленным
+  unsigned link_wrong;  // пакет не совпал с отправленным
+  uint32_t link_delay_max_us;
+  unsigned frames; // кадров записи или телеметрии
+  unsigned gaps;   // разрывы их номеров
+  unsigned broken; // кадр не разобрался или отсчёт не тот
+  uint8_t seq;
+  bool have_seq;
+} Receiver;
+
+// Отправленные пакеты ориентации: время и кадр, по номеру
+typedef struct {
+  LinkFrame frame;
+  uint32_t sent_us;
+} Sent;
+static Sent sent[256];
+
+// Отсчёт номер k: по метке времени хост восстанавливает k и проверяет
+// остальное. Значения кратны 257 — в кадрах есть нулевые байты.
+#define SAMPLE_STEP_US 1000
+
+static MPU6050Sample test_sample(uint32_t k) {
+  MPU6050Sample s;
+  for (int i = 0; i < 3; i++) {
+    s.accel[i] = (int16_t)(k * 257 * (i + 1));
+    s.gyro[i] = (int16_t)(-k * (i + 3));
+  }
+  s.temp = (int16_t)k;
+  s.timestamp = k * SAMPLE_STEP_US;
+  return s;
+}
+
+// Температура в пачке телеметрии — одна на пачку, её не сравниваем
+static bool check_sample(const MPU6050Sample *s, bool temp) {
+  MPU6050Sample e = test_sample(s->timestamp / SAMPLE_STEP_US);
+  for (int i = 0; i < 3; i++)
+    if (s->accel[i] != e.accel[i] || s->gyro[i] != e.gyro[i])
+      return false;
+  return s->timestamp == e.timestamp && (!temp || s->temp == e.temp);
+}
+
+static void check_seq(Receiver *r, uint8_t seq) {
+  if (r->have_seq && seq != (uint8_t)(r->seq + 1))
+    r->gaps++;
+  r->seq = seq;
+  r->have_seq = true;
+  r->frames++;
+}
+
+static void receive_chunk(Receiver *r) {
+  uint8_t n, seq, flags;
+  if (!link_cobs_decode(r->chunk, r->len, &n) || !n) {
+    r->broken++;
+    return;
+  }
+  uint8_t tag = r->chunk[0] >> 4;
+  if (tag == LINK_VERSION) {
+    return; // пакеты ориентации проверяет LinkDecoder
+  } else if (tag == RECORD_TAG) {
+    MPU6050Sample s;
+    if (!record_parse(r->chunk, n, &s, &seq, &flags) ||
+        !check_sample(&s, true)) {
+      r->broken++;
+      return;
+    }
+    check_seq(r, seq);
+  } else if (tag == TELEMETRY_TAG) {
+    TelemetrySample samples[TELEMETRY_BATCH_LIMIT];
+    TelemetryStatus status;
+    uint8_t count = 0;
+    int8_t kind = telemetry_parse(r->chunk, n, &seq, &flags, samples, &count,
+                                  &status);
+    if (kind < 0) {
+      r->broken++;
+      return;
+    }
+    for (uint8_t i = 0; i < count; i++)
+      if (!check_sample(&samples[i].sample, false))
+        r->broken++;
+    check_seq(r, seq);
+  } else {
+    r->broken++;
+  }
+}
+
+static void receive(Receiver *r, uint8_t c) {
+  LinkFrame f;
+  if (link_decode_byte(&r->link, c, &f)) {
+    const Sent *s = &sent[f.seq];
+    if (memcmp(&f, &s->frame, sizeof(f)) != 0)
+      r->link_wrong++;
+    uint32_t delay = now_us - s->sent_us;
+    if (delay > r->link_delay_max_us)
+      r->link_delay_max_us = delay;
+    r->link_frames++;
+  }
+
+  if (c != 0x00) {
+    if (r->len < sizeof(r->chunk))
+      r->chunk[r->len++] = c;
+    return;
+  }
+  if (r->len)
+    receive_chunk(r);
+  r->len = 0;
+}
+
+static void receiver_init(Receiver *r) {
+  memset(r, 0, sizeof(*r));
+  link_decoder_init(&r->link);
+}
+
+// Один байт времени линии: если передатчик просит байт, UDRE
+static void line_step(Receiver *r) {
+  now_us += BYTE_US;
+  if (!(UCSR0B & (1 << UDRIE0)))
+    return;
+  UCSR0A &= ~(1 << TXC0);
+  USART_UDRE_vect();
+  if (UCSR0A & (1 << TXC0))
+    receive(r, UDR0);
+}
+
+static unsigned attitude_sent;
+
+// Как task_link: кадр в слот, по номеру запоминается отправленное
+static void send_attitude(void) {
+  uint8_t seq = attitude_sent++;
+  LinkFrame f = {.seq = seq,
+                 .mode = seq & 1,
+                 .roll_cd = (int16_t)(seq * 100 - 9000),
+                 .pitch_cd = (int16_t)(4500 - seq * 37)};
+  uint8_t buf[LINK_FRAME_MAX];
+  sent[f.seq] = (Sent){f, now_us};
+  uart_send_latest(buf, link_encode(&f, buf));
+}
+
+static void start(Receiver *r) {
+  now_us = 0;
+  attitude_sent = 0;
+  uart_tx_replaced = 0;
+  receiver_init(r);
+  sei();
+  uart_init_send();
+}
+
+// Линия до опустошения передатчика
+static void drain(Receiver *r) {
+  for (unsigned i = 0; i < 10000 && (UCSR0B & (1 << UDRIE0)); i++)
+    line_step(r);
+}
+
+// Поток кольца: как imu_stream и task_telemetry на MCU1
+typedef enum { STREAM_RECORDS, STREAM_TELEMETRY } Stream;
+
+typedef struct {
+  Stream kind;
+  uint8_t seq;
+  uint32_t samples;
+  unsigned written, dropped;
+  TelemetryBatch batch;
+} Producer;
+
+// Без ожидания, как telemetry_send: не влез — пропал, номер растёт
+static void produce_frame(Producer *p, const uint8_t *frame, uint8_t n) {
+  if (uart_write(frame, n))
+    p->written++;
+  else
+    p->dropped++;
+  p->seq++;
+}
+
+static void produce_sample(Producer *p) {
+  MPU6050Sample s = test_sample(p->samples++);
+  if (p->kind == STREAM_RECORDS) {
+    uint8_t buf[RECORD_FRAME_MAX];
+    produce_frame(p, buf, record_encode(&s, p->seq, 0, buf));
+    return;
+  }
+  if (!telemetry_add(&p->batch, &s, s.gyro[0], s.gyro[1])) {
+    uint8_t buf[TELEMETRY_FRAME_MAX];
+    produce_frame(p, buf, telemetry_encode_batch(&p->batch, p->seq, 0, buf));
+    telemetry_add(&p->batch, &s, s.gyro[0], s.gyro[1]);
+  }
+}
+
+// Кадр состояния телеметрии, раз в секунду
+static void produce_status(Producer *p) {
+  TelemetryStatus status = {.tx_replaced = uart_tx_replaced,
+                            .dropped = p->dropped};
+  uint8_t buf[TELEMETRY_STATUS_FRAME_MAX];
+  produce_frame(p, buf, telemetry_encode_status(&status, p->seq, 0, buf));
+}
+
+// Пакеты ориентации раз в 30 мс и отсчёты потока с периодом sample_us;
+// фаза phase_us сдвигает поток относительно пакетов
+static void run_mix(Stream kind, uint32_t sample_us, uint32_t phase_us,
+                    const char *name) {
+  enum { SECONDS = 10 };
+  Receiver r;
+  start(&r);
+  Producer p = {.kind = kind};
+  uint32_t next_attitude = 0, next_sample = phase_us;
+  uint32_t next_status = 1000000UL + phase_us;
+  while (now_us < SECONDS * 1000000UL) {
+    if ((int32_t)(now_us - next_attitude) >= 0) {
+      send_attitude();
+      next_attitude += 30000;
+    }
+    if ((int32_t)(now_us - next_sample) >= 0) {
+      produce_sample(&p);
+      next_sample += sample_us;
+    }
+    if (kind == STREAM_TELEMETRY && (int32_t)(now_us - next_status) >= 0) {
+      produce_status(&p);
+      next_status += 1000000UL;
+    }
+    line_step(&r);
+  }
+  drain(&r);
+
+  CHECK(!r.broken, "%s: %u broken frames", name, r.broken);
+  CHECK(!r.link_wrong, "%s: %u wrong attitude frames", name, r.link_wrong);
+  CHECK(r.link.errors == r.frames,
+        "%s: MCU2 rejected %u frames, %u of them from the ring", name,
+        r.link.errors, r.frames);
+  CHECK(r.link_frames + uart_tx_replaced == attitude_sent,
+        "%s: %u attitude sent, %u received, %u replaced", name,
+        attitude_sent, r.link_frames, uart_tx_replaced);
+  CHECK(r.frames == p.written && (p.dropped || !r.gaps),
+        "%s: %u frames written, %u received, %u gaps", name, p.written,
+        r.frames, r.gaps);
+  // Пакет ждёт не дольше кадра кольца и уходит сам
+  uint32_t ring_max =
+      kind == STREAM_RECORDS ? RECORD_FRAME_MAX : TELEMETRY_FRAME_MAX;
+  uint32_t limit = (ring_max + LINK_FRAME_MAX + 1) * BYTE_US;
+  CHECK(r.link_delay_max_us <= limit, "%s: attitude waited %lu us, max %lu",
+        name, (unsigned long)r.link_delay_max_us, (unsigned long)limit);
+}
+
+// Запись с пакетами ориентации (IMU_STREAM): пакет приходит в разные
+// места кадра записи, а на 222 Гц кольцо забито почти до отказа
+static void test_record_mix(void) {
+  for (uint32_t phase = 0; phase < 10000; phase += 700) {
+    char name[32];
+    snprintf(name, sizeof(name), "records 100 Hz +%lu us",
+             (unsigned long)phase);
+    run_mix(STREAM_RECORDS, 10000, phase, name);
+  }
+  run_mix(STREAM_RECORDS, 4500, 777, "records 222 Hz");
+}
+
+// Телеметрия с пакетами ориентации (TELEMETRY): пачка из
+// TELEMETRY_BATCH отсчётов — 85 байт, ~14 мс на 57600, дольше половины
+// периода пакетов; раз в секунду — кадр состояния
+static void test_telemetry_mix(void) {
+  for (uint32_t phase = 0; phase < 10000; phase += 1300) {
+    char name[40];
+    snprintf(name, sizeof(name), "telemetry 100 Hz +%lu us",
+             (unsigned long)phase);
+    run_mix(STREAM_TELEMETRY, 10000, phase, name);
+  }
+  run_mix(STREAM_TELEMETRY, 4000, 333, "telemetry 250 Hz");
+}
+
+// Отчёт профилировщика (SCREEN_PROFILE на MCU1): строки кадрами «0x00,
+// строка, 0x00» и только в свободную линию. Пакеты ориентации целы,
+// каждую строку MCU2 отбрасывает одной ошибкой, пакет ждёт не дольше
+// строки
+static void test_text_lines(void) {
+  enum { SECONDS = 10 };
+  static const char text[] =
+      "prof frame us=12345 spi_us=6789 bytes=40960 busy=87 sck_khz=8000\n";
+  uint8_t line[sizeof(text) + 1];
+  line[0] = 0x00;
+  memcpy(line + 1, text, sizeof(text) - 1);
+  line[sizeof(line) - 1] = 0x00;
+
+  Receiver r;
+  start(&r);
+  unsigned lines = 0;
+  bool pending = false;
+  uint32_t next_attitude = 0, next_line = 0;
+  while (now_us < SECONDS * 1000000UL) {
+    if ((int32_t)(now_us - next_attitude) >= 0) {
+      send_attitude();
+      next_attitude += 30000;
+    }
+    if ((int32_t)(now_us - next_line) >= 0) {
+      pending = true;
+      next_line += 5000;
+    }
+    if (pending && uart_tx_idle() && uart_write(line, sizeof(line))) {
+      pending = false;
+      lines++;
+    }
+    line_step(&r);
+  }
+  drain(&r);
+
+  CHECK(lines > SECONDS * 10, "text: only %u lines sent", lines);
+  CHECK(!r.link_wrong, "text: %u wrong attitude frames", r.link_wrong);
+  CHECK(r.link.errors == lines && r.broken == lines,
+        "text: %u lines, MCU2 rejected %u, host %u", lines, r.link.errors,
+        r.broken);
+  CHECK(r.link_frames + uart_tx_replaced == attitude_sent,
+        "text: %u attitude sent, %u received, %u replaced", attitude_sent,
+        r.link_frames, uart_tx_replaced);
+  uint32_t limit = (sizeof(line) + LINK_FRAME_MAX + 1) * BYTE_US;
+  CHECK(r.link_delay_max_us <= limit, "text: attitude waited %lu us, max %lu",
+        (unsigned long)r.link_delay_max_us, (unsigned long)limit);
+}
+
+int main(void) {
+  test_record_mix();
+  test_telemetry_mix();
+  test_text_lines();
+  return check_done("uart");
+}
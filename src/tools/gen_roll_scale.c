@@ -0,0 +1,192 @@
+// Генератор таблиц шкалы крена: tools/gen_roll_scale <ширина> <высота> > roll_scale_WxH.h
+//
+// Единственный расчёт геометрии шкалы (дуга, риски, подписи) во float —
+// на хосте и один раз при сборке: draw_roll_ui в mcu.h только обходит
+// таблицы из PROGMEM, без sinf/cosf и подбора подписей при каждом входе
+// в режим.
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define PI_F 3.14159265358979323846f
+
+typedef struct {
+  int x, y;
+} Pt;
+
+static int width, height;
+
+static Pt arc[64];
+static int arc_n = 0;
+
+static int ticks[8][4];
+static int tick_n = 0;
+
+static struct {
+  int x, y;
+  const char *text;
+} labels[8];
+static int label_n = 0;
+
+static void arc_break(void) {
+  if (arc_n > 0 && arc[arc_n - 1].x >= 0)
+    arc[arc_n++] = (Pt){-1, -1};
+}
+
+static void build(void) {
+  const int R = (int)(0.35f * width);
+  const int cy = R + (int)(0.05f * height);
+  const int cx = width / 2;
+
+  const int tick_len = (int)(0.022f * width);
+  const int label_dist = tick_len + (int)(0.03f * width);
+
+  const int MIN_COORD = -75;
+  const int MAX_COORD = 75;
+  const int steps = 61;
+
+  // Дуга: точки вне экрана рвут ломаную
+  for (int i = 0; i <= steps; ++i) {
+    float coord_deg = MIN_COORD + (MAX_COORD - MIN_COORD) * i / (float)steps;
+    float rad = coord_deg * (PI_F / 180.0f);
+
+    int x = cx - (int)(R * sinf(rad));
+    int y = cy - (int)(R * cosf(rad));
+
+    if (x < 0 || x >= width || y < 0 || y >= height) {
+      arc_break();
+      continue;
+    }
+    arc[arc_n++] = (Pt){x, y};
+  }
+  if (arc_n > 0 && arc[arc_n - 1].x < 0)
+    arc_n--;
+
+  static const int coord_angles[] = {-60, -30, 0, 30, 60};
+  for (int i = 0; i < 5; ++i) {
+    int coord_deg = coord_angles[i];
+    float rad = coord_deg * (PI_F / 180.0f);
+
+    int x_c = cx - (int)(R * sinf(rad));
+    int y_c = cy - (int)(R * cosf(rad));
+
+    float nx = -sinf(rad);
+    float ny = -cosf(rad);
+
+    ticks[tick_n][0] = x_c;
+    ticks[tick_n][1] = y_c;
+    ticks[tick_n][2] = x_c + (int)(nx * tick_len);
+    ticks[tick_n][3] = y_c + (int)(ny * tick_len);
+    tick_n++;
+
+    // Подписи: шкала подписана «наоборот» (-60 у отметки 30° и т.д.),
+    // боковые отодвинуты дальше и ниже — как в исходной разметке
+    const char *text;
+    int label_x, label_y;
+    if (coord_deg == -60 || coord_deg == 60 || coord_deg == 0) {
+      text = (coord_deg == -60) ? "-30" : (coord_deg == 60) ? "+30" : "0";
+      label_x = x_c + (int)(nx * label_dist);
+      label_y = y_c + (int)(ny * label_dist);
+    } else {
+      text = (coord_deg == -30) ? "-60" : "+60";
+      float ext_factor = 1.8f;
+      label_x = x_c + (int)(nx * label_dist * ext_factor);
+      label_y = y_c + (int)(ny * label_dist * ext_factor) + (int)(0.08f * height);
+    }
+
+    if (label_x < 2 || label_x > width - 20 || label_y < 2 ||
+        label_y > height - 12)
+      continue;
+
+    int text_w;
+    if (strcmp(text, "0") == 0)
+      text_w = 6;
+    else if (text[1] == '3' || text[1] == '6')
+      text_w = 10;
+    else
+      text_w = 8;
+
+    float asym_factor = 1.0f;
+    if (coord_deg == 60)
+      asym_factor = 3.8f;
+    else if (coord_deg == -60)
+      asym_factor = 1.1f;
+    else if (coord_deg == 0)
+      asym_factor = 1.5f;
+    else if (coord_deg == 30)
+      asym_factor = 4.2f;
+    else if (coord_deg == -30)
+      asym_factor = 0.7f;
+
+    label_x -= (int)(text_w * asym_factor / 2.0f);
+
+    if (coord_deg == -60 || coord_deg == 0 || coord_deg == 60)
+      label_y -= 2;
+    if (coord_deg == -30 || coord_deg == 0 || coord_deg == 30)
+      label_y -= 6;
+
+    labels[label_n].x = label_x;
+    labels[label_n].y = label_y;
+    labels[label_n].text = text;
+    label_n++;
+  }
+}
+
+int main(int argc, char **argv) {
+  if (argc != 3) {
+    fprintf(stderr, "usage: %s <width> <height>\n", argv[0]);
+    return 1;
+  }
+  width = atoi(argv[1]);
+  height = atoi(argv[2]);
+  // Точки дуги хранятся байтами, 0xFF — разрыв
+  if (width < 32 || height < 32 || width > 255 || height > 255) {
+    fprintf(stderr, "gen_roll_scale: unsupported geometry %dx%d\n", width,
+            height);
+    return 1;
+  }
+
+  build();
+
+  printf("// Сгенерировано tools/gen_roll_scale.c для экрана %dx%d — не "
+         "редактировать\n",
+         width, height);
+  printf("#ifndef ROLL_SCALE_TABLE_H\n#define ROLL_SCALE_TABLE_H\n\n");
+  printf("#include <avr/pgmspace.h>\n#include <stdint.h>\n\n");
+  printf("#define ROLL_SCALE_WIDTH %d\n#define ROLL_SCALE_HEIGHT %d\n\n", width,
+         height);
+
+  printf("// Дуга шкалы — ломаная; точка {ROLL_SCALE_BREAK, ...} — разрыв\n");
+  printf("#define ROLL_SCALE_BREAK 0xFF\n");
+  printf("#define ROLL_SCALE_ARC_POINTS %d\n", arc_n);
+  printf("static const uint8_t roll_scale_arc[ROLL_SCALE_ARC_POINTS][2] "
+         "PROGMEM = {\n");
+  for (int i = 0; i < arc_n; i++) {
+    if (arc[i].x < 0)
+      printf("    {ROLL_SCALE_BREAK, ROLL_SCALE_BREAK},\n");
+    else
+      printf("    {%d, %d},\n", arc[i].x, arc[i].y);
+  }
+  printf("};\n\n");
+
+  printf("// Штрихи: x0, y0, x1, y1\n");
+  printf("#define ROLL_SCALE_TICKS %d\n", tick_n);
+  printf("static const int16_t roll_scale_ticks[ROLL_SCALE_TICKS][4] PROGMEM = "
+         "{\n");
+  for (int i = 0; i < tick_n; i++)
+    printf("    {%d, %d, %d, %d},\n", ticks[i][0], ticks[i][1], ticks[i][2],
+           ticks[i][3]);
+  printf("};\n\n");
+
+  printf("// Подписи: левый верхний угол и текст\n");
+  printf("typedef struct {\n    int16_t x, y;\n    char text[4];\n} "
+         "RollScaleLabel;\n\n");
+  printf("#define ROLL_SCALE_LABELS %d\n", label_n);
+  printf("static const RollScaleLabel roll_scale_labels[ROLL_SCALE_LABELS] "
+         "PROGMEM = {\n");
+  for (int i = 0; i < label_n; i++)
+    printf("    {%d, %d, \"%s\"},\n", labels[i].x, labels[i].y, labels[i].text);
+  printf("};\n\n#endif // ROLL_SCALE_TABLE_H\n");
+  return 0;
+}
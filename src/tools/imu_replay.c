@@ -0,0 +1,295 @@
+// Воспроизведение записи MPU6050 через оценщики ориентации на хосте: тот
+// же attitude.c / mahony.c, что на MCU1, с теми же флагами сборки.
+// Отсчёты и шаг — как в attitude_filter из mcu1.c, поэтому углы совпадают
+// с прошивкой, пока в записи нет пропусков.
+//
+//   tools/imu_replay_float -c dump.bin walk.imu
+//     поток MCU1 (IMU_STREAM=1 или TELEMETRY=1), снятый с UART как есть,
+//     → файл записи; кадры MCU2, состояния и текст старта пропускаются
+//   tools/imu_replay_float [-e compl|mahony] [-q] walk.imu > trace.txt
+//     углы по отсчётам в stdout, скорость оценщика — в stderr
+//
+// Формат записи и кадра — lib/Record/record.h.
+#include "../lib/Attitude/attitude.h"
+#include "../lib/Link/link.h"
+#include "../lib/Record/record.h"
+#include "../lib/Telemetry/telemetry.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Шаг первого отсчёта без FIFO — SENSOR_PERIOD_US в mcu1.c
+#define SENSOR_PERIOD_US 10000
+// Воспроизведений для замера скорости — не короче
+#define BENCH_MIN_NS 200000000ull
+
+static const Estimator *const estimators[] = {
+    &COMPLEMENTARY_ESTIMATOR,
+    &MAHONY_ESTIMATOR,
+};
+
+typedef struct {
+  MPU6050Sample *samples;
+  size_t n, cap;
+  uint8_t flags;
+  uint16_t period_us;
+} Recording;
+
+static void push(Recording *r, const MPU6050Sample *s) {
+  if (r->n == r->cap) {
+    r->cap = r->cap ? 2 * r->cap : 4096;
+    r->samples = realloc(r->samples, r->cap * sizeof(*r->samples));
+    if (!r->samples) {
+      perror("imu_replay");
+      exit(1);
+    }
+  }
+  r->samples[r->n++] = *s;
+}
+
+static uint64_t now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000u + ts.tv_nsec;
+}
+
+// --- Файл записи ---
+
+static int write_recording(const char *path, const Recording *r) {
+  FILE *f = fopen(path, "wb");
+  if (!f) {
+    perror(path);
+    return 1;
+  }
+  uint8_t h[RECORD_FILE_HEADER_LEN] = {0};
+  memcpy(h, RECORD_FILE_MAGIC, 4);
+  h[4] = RECORD_FILE_VERSION;
+  h[5] = r->flags;
+  h[6] = r->period_us & 0xFF;
+  h[7] = r->period_us >> 8;
+  fwrite(h, 1, sizeof(h), f);
+  for (size_t i = 0; i < r->n; i++) {
+    uint8_t buf[RECORD_SAMPLE_LEN];
+    record_pack(&r->samples[i], buf);
+    fwrite(buf, 1, sizeof(buf), f);
+  }
+  int err = ferror(f);
+  if (fclose(f) != 0 || err) {
+    perror(path);
+    return 1;
+  }
+  return 0;
+}
+
+static int read_recording(const char *path, Recording *r) {
+  FILE *f = fopen(path, "rb");
+  if (!f) {
+    perror(path);
+    return 1;
+  }
+  uint8_t h[RECORD_FILE_HEADER_LEN];
+  if (fread(h, 1, sizeof(h), f) != sizeof(h) ||
+      memcmp(h, RECORD_FILE_MAGIC, 4) != 0 || h[4] != RECORD_FILE_VERSION) {
+    fprintf(stderr, "%s: not a version %d IMU recording\n", path,
+            RECORD_FILE_VERSION);
+    fclose(f);
+    return 1;
+  }
+  r->flags = h[5];
+  r->period_us = h[6] | (h[7] << 8);
+
+  uint8_t buf[RECORD_SAMPLE_LEN];
+  size_t got;
+  while ((got = fread(buf, 1, sizeof(buf), f)) == sizeof(buf)) {
+    MPU6050Sample s;
+    record_unpack(buf, &s);
+    push(r, &s);
+  }
+  fclose(f);
+  if (got)
+    fprintf(stderr, "%s: truncated last sample ignored\n", path);
+  return 0;
+}
+
+// --- Снятый поток → запись ---
+
+// Отсчёт из потока; contiguous — перед ним ничего не пропало
+static void add_sample(Recording *r, const MPU6050Sample *s, int fifo,
+                       int contiguous) {
+  // Период FIFO — шаг меток между соседними отсчётами
+  if (fifo && contiguous && r->n && !r->period_us)
+    r->period_us = s->timestamp - r->samples[r->n - 1].timestamp;
+  if (fifo)
+    r->flags |= RECORD_FIFO;
+  push(r, s);
+}
+
+static int capture(const char *dump_path, const char *out_path) {
+  FILE *f = fopen(dump_path, "rb");
+  if (!f) {
+    perror(dump_path);
+    return 1;
+  }
+
+  Recording r = {0};
+  // Самый длинный кадр — пачка телеметрии: нагрузка и байт COBS
+  uint8_t frame[TELEMETRY_HEADER_LEN +
+                TELEMETRY_BATCH_LIMIT * TELEMETRY_SAMPLE_LEN + 2];
+  unsigned len = 0;
+  int overflow = 0, have_seq = 0;
+  uint8_t last_seq = 0;
+  unsigned long lost = 0, errors = 0, attitude = 0;
+
+  int c;
+  while ((c = fgetc(f)) != EOF) {
+    if (c != 0x00) {
+      if (len < sizeof(frame))
+        frame[len++] = c;
+      else
+        overflow = 1;
+      continue;
+    }
+
+    uint8_t n, seq, flags, count;
+    MPU6050Sample s;
+    TelemetrySample batch[TELEMETRY_BATCH_LIMIT];
+    TelemetryStatus status;
+    int8_t kind;
+    if (len == 0) {
+      // одиночный разделитель
+    } else if (overflow || !link_cobs_decode(frame, len, &n)) {
+      errors++;
+    } else if (n == LINK_PAYLOAD_LEN && (frame[0] >> 4) == LINK_VERSION) {
+      attitude++; // пакет MCU2
+    } else if (record_parse(frame, n, &s, &seq, &flags)) {
+      uint8_t gap = have_seq ? (uint8_t)(seq - last_seq - 1) : 0;
+      lost += gap;
+      add_sample(&r, &s, flags & RECORD_FIFO, gap == 0);
+      last_seq = seq;
+      have_seq = 1;
+    } else if ((kind = telemetry_parse(frame, n, &seq, &flags, batch, &count,
+                                       &status)) >= 0) {
+      uint8_t gap = have_seq ? (uint8_t)(seq - last_seq - 1) : 0;
+      lost += gap;
+      for (uint8_t i = 0; kind == TELEMETRY_SAMPLES && i < count; i++)
+        add_sample(&r, &batch[i].sample, flags & TELEMETRY_FIFO,
+                   gap == 0 || i > 0);
+      last_seq = seq;
+      have_seq = 1;
+    } else {
+      errors++; // текст старта и сбои
+    }
+    len = 0;
+    overflow = 0;
+  }
+  fclose(f);
+
+  if (!(r.flags & RECORD_FIFO) || !r.period_us)
+    r.period_us = SENSOR_PERIOD_US;
+  fprintf(stderr,
+          "%s: %zu samples%s, %lu frames lost, %lu attitude frames, "
+          "%lu bad frames\n",
+          dump_path, r.n, (r.flags & RECORD_FIFO) ? " (FIFO)" : "", lost,
+          attitude, errors);
+  if (!r.n) {
+    fprintf(stderr,
+            "%s: no IMU samples, was MCU1 built with IMU_STREAM=1 or "
+            "TELEMETRY=1?\n",
+            dump_path);
+    return 1;
+  }
+  return write_recording(out_path, &r);
+}
+
+// --- Воспроизведение ---
+
+// Шаг отсчёта i — как attitude_filter в mcu1.c
+static uint16_t step_us(const Recording *r, size_t i) {
+  if ((r->flags & RECORD_FIFO) || i == 0)
+    return r->period_us;
+  uint32_t elapsed = r->samples[i].timestamp - r->samples[i - 1].timestamp;
+  return elapsed > 0xFFFF ? 0xFFFF : elapsed;
+}
+
+static void replay(const Estimator *e, const Recording *r, int trace) {
+  e->reset();
+  if (trace)
+    printf("# %s, %zu samples\n# t_us roll_deg pitch_deg%s\n", e->name, r->n,
+           e->yaw ? " yaw_deg" : "");
+  for (size_t i = 0; i < r->n; i++) {
+    const MPU6050Sample *s = &r->samples[i];
+    e->update(s->accel, s->gyro, step_us(r, i));
+    if (!trace)
+      continue;
+    printf("%lu %.3f %.3f", (unsigned long)s->timestamp,
+           ATTITUDE_TO_DEG(e->roll()), ATTITUDE_TO_DEG(e->pitch()));
+    if (e->yaw)
+      printf(" %.3f", ATTITUDE_TO_DEG(e->yaw()));
+    putchar('\n');
+  }
+}
+
+// Скорость: запись целиком, пока не наберётся BENCH_MIN_NS
+static void bench(const Estimator *e, const Recording *r) {
+  uint64_t ns = 0, updates = 0;
+  while (ns < BENCH_MIN_NS) {
+    uint64_t t0 = now_ns();
+    replay(e, r, 0);
+    ns += now_ns() - t0;
+    updates += r->n;
+  }
+  fprintf(stderr, "# %s: %.1f ns/update, %.0f updates/s\n", e->name,
+          (double)ns / updates, updates * 1e9 / ns);
+}
+
+static void usage(void) {
+  fprintf(stderr, "usage: imu_replay -c dump.bin out.imu\n"
+                  "       imu_replay [-e compl|mahony] [-q] rec.imu\n");
+  exit(2);
+}
+
+int main(int argc, char **argv) {
+  if (argc == 4 && strcmp(argv[1], "-c") == 0)
+    return capture(argv[2], argv[3]);
+
+  const Estimator *e = estimators[0];
+  int trace = 1;
+  const char *path = NULL;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "-e") == 0 && i + 1 < argc) {
+      const char *name = argv[++i];
+      e = NULL;
+      for (size_t k = 0; k < sizeof(estimators) / sizeof(estimators[0]); k++) {
+        if (strcmp(estimators[k]->name, name) == 0)
+          e = estimators[k];
+      }
+      if (!e) {
+        fprintf(stderr, "imu_replay: unknown estimator %s\n", name);
+        return 2;
+      }
+    } else if (strcmp(argv[i], "-q") == 0) {
+      trace = 0;
+    } else if (argv[i][0] != '-' && !path) {
+      path = argv[i];
+    } else {
+      usage();
+    }
+  }
+  if (!path)
+    usage();
+
+  Recording r = {0};
+  if (read_recording(path, &r) != 0)
+    return 1;
+  if (!r.n) {
+    fprintf(stderr, "%s: empty recording\n", path);
+    return 1;
+  }
+
+  replay(e, &r, trace);
+  bench(e, &r);
+  free(r.samples);
+  return 0;
+}
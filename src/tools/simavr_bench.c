@@ -0,0 +1,448 @@
+// Прогон bench_sim.elf в simavr: такты на операцию, на кадр и на
+// обработчик прерывания, проверка бюджета кадра.
+//
+//   tools/simavr_bench [-b бюджет_мкс] [-t предел_с] bench_sim.elf
+//
+// Прошивка размечает операции номером в GPIOR0 (0 — конец, вложенные —
+// стопкой), имена печатает в UART строками «op <номер> <имя>», такт
+// рендера — «period <мкс>»: это бюджет кадра, если не задан -b. Время
+// обработчиков — от входа до reti по сигналам контроллера прерываний.
+// Датчик — модель MPU6050 на TWI: на каждое чтение с регистра
+// ACCEL_XOUT_H — следующий отсчёт качания, 10 мс движения.
+// GPIOR1 = 1 — байты из TX идут обратно в RX.
+//
+// Код выхода: 0 — кадры в бюджете, 1 — бюджет превышен, 2 — прогон
+// не дошёл до «done» (сбой, предел времени, нет прошивки).
+#include "../lib/Bytes/bytes.h"
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <simavr/avr_twi.h>
+#include <simavr/avr_uart.h>
+#include <simavr/sim_avr.h>
+#include <simavr/sim_elf.h>
+#include <simavr/sim_interrupts.h>
+#include <simavr/sim_io.h>
+
+#define PI 3.14159265358979323846
+
+// Адреса в пространстве данных ATmega328P
+#define GPIOR0_ADDR 0x3E
+#define GPIOR1_ADDR 0x4A
+
+#define MAX_OPS 32
+#define MAX_DEPTH 8
+#define MAX_VECTORS 26
+
+typedef struct {
+  char name[32];
+  uint64_t count, total, min, max;
+} Stat;
+
+static Stat ops[MAX_OPS];
+static Stat isrs[MAX_VECTORS];
+
+static const char *const vector_names[MAX_VECTORS] = {
+    [1] = "INT0",          [2] = "INT1",         [3] = "PCINT0",
+    [4] = "PCINT1",        [5] = "PCINT2",       [6] = "WDT",
+    [7] = "TIMER2_COMPA",  [8] = "TIMER2_COMPB", [9] = "TIMER2_OVF",
+    [10] = "TIMER1_CAPT",  [11] = "TIMER1_COMPA", [12] = "TIMER1_COMPB",
+    [13] = "TIMER1_OVF",   [14] = "TIMER0_COMPA", [15] = "TIMER0_COMPB",
+    [16] = "TIMER0_OVF",   [17] = "SPI_STC",     [18] = "USART_RX",
+    [19] = "USART_UDRE",   [20] = "USART_TX",    [21] = "ADC",
+    [22] = "EE_READY",     [23] = "ANALOG_COMP", [24] = "TWI",
+    [25] = "SPM_READY",
+};
+
+static avr_t *avr;
+
+static void stat_add(Stat *s, uint64_t cycles) {
+  if (s->count == 0 || cycles < s->min)
+    s->min = cycles;
+  if (cycles > s->max)
+    s->max = cycles;
+  s->total += cycles;
+  s->count++;
+}
+
+// --- Разметка операций: GPIOR0 ---
+
+static struct {
+  uint8_t op;
+  uint64_t start;
+} stack[MAX_DEPTH];
+static int depth = 0;
+static int stack_errors = 0;
+
+static void gpior0_write(avr_t *a, avr_io_addr_t addr, uint8_t v,
+                         void *param) {
+  (void)param;
+  a->data[addr] = v;
+  if (v) {
+    if (depth == MAX_DEPTH || v >= MAX_OPS) {
+      stack_errors++;
+      return;
+    }
+    stack[depth].op = v;
+    stack[depth].start = a->cycle;
+    depth++;
+    return;
+  }
+  if (depth == 0) {
+    stack_errors++;
+    return;
+  }
+  depth--;
+  stat_add(&ops[stack[depth].op], a->cycle - stack[depth].start);
+}
+
+// --- Обработчики прерываний: вход → reti ---
+
+static uint64_t isr_start[MAX_VECTORS];
+
+static void isr_running(avr_irq_t *irq, uint32_t value, void *param) {
+  (void)irq;
+  int v = (int)(intptr_t)param;
+  if (value)
+    isr_start[v] = avr->cycle;
+  else
+    stat_add(&isrs[v], avr->cycle - isr_start[v]);
+}
+
+// --- UART: текст прошивки и петля TX → RX ---
+
+static avr_irq_t *uart_rx;
+static uint8_t loop_buf[256];
+static uint8_t loop_head, loop_tail;
+static int uart_xoff = 0;
+static int loopback = 0;
+
+static char line[128];
+static int line_len = 0;
+static int line_binary = 0;
+static int done = 0;
+static double period_us = 0; // такт рендера из прошивки
+
+static void gpior1_write(avr_t *a, avr_io_addr_t addr, uint8_t v,
+                         void *param) {
+  (void)param;
+  a->data[addr] = v;
+  loopback = v & 1;
+}
+
+static void loop_pump(void) {
+  while (!uart_xoff && loop_tail != loop_head)
+    avr_raise_irq(uart_rx, loop_buf[loop_tail++]);
+}
+
+static void uart_xon(avr_irq_t *irq, uint32_t value, void *param) {
+  (void)irq, (void)value, (void)param;
+  uart_xoff = 0;
+  loop_pump();
+}
+
+static void uart_xoff_hook(avr_irq_t *irq, uint32_t value, void *param) {
+  (void)irq, (void)value, (void)param;
+  uart_xoff = 1;
+}
+
+// Строка прошивки: имя операции, конец прогона или просто вывод
+static void fw_line(void) {
+  line[line_len] = '\0';
+  unsigned id;
+  char name[32];
+  if (sscanf(line, "op %u %31s", &id, name) == 2 && id < MAX_OPS)
+    snprintf(ops[id].name, sizeof(ops[id].name), "%s", name);
+  else if (sscanf(line, "period %u", &id) == 1)
+    period_us = id;
+  else if (strcmp(line, "done") == 0)
+    done = 1;
+  else if (line_len)
+    printf("fw: %s\n", line);
+}
+
+static void uart_out(avr_irq_t *irq, uint32_t value, void *param) {
+  (void)irq, (void)param;
+  uint8_t c = value;
+  if (loopback) {
+    loop_buf[loop_head++] = c;
+    loop_pump();
+    return;
+  }
+  // Кадры канала среди текста: строку с двоичными байтами отбрасываем
+  if (c == '\n') {
+    if (!line_binary)
+      fw_line();
+    line_len = 0;
+    line_binary = 0;
+  } else if (c == 0) {
+    line_len = 0;
+    line_binary = 0;
+  } else if (c != '\r') {
+    if (c < 0x20 || c > 0x7E || line_len == sizeof(line) - 1)
+      line_binary = 1;
+    else
+      line[line_len++] = c;
+  }
+}
+
+// --- MPU6050 на TWI ---
+
+#define MPU_ADDR 0xD0
+#define MPU_WHO_AM_I 0x75
+#define MPU_ACCEL_XOUT_H 0x3B
+
+static struct {
+  avr_irq_t *irq;
+  uint8_t regs[256];
+  uint8_t reg;
+  uint8_t selected;
+  int reg_written; // указатель регистра уже принят в этой записи
+  uint32_t sample;
+} mpu;
+
+// Качание: 0 → 45° → -45° → 0 за 180 отсчётов по 10 мс, тангаж — 2/3
+// крена. Угол в градусах и скорость в °/с.
+#define SWEEP_SAMPLES 180
+#define SAMPLE_S 0.01
+
+static void sweep(uint32_t k, double *deg, double *rate) {
+  int phase = k % SWEEP_SAMPLES;
+  if (phase < 45) {
+    *deg = phase;
+    *rate = 1.0 / SAMPLE_S;
+  } else if (phase < 135) {
+    *deg = 90 - phase;
+    *rate = -1.0 / SAMPLE_S;
+  } else {
+    *deg = phase - 180;
+    *rate = 1.0 / SAMPLE_S;
+  }
+}
+
+// Регистр датчика: с насыщением, старшим байтом первым
+static void put16(uint8_t *p, double v) {
+  long x = lround(v);
+  if (x > 32767)
+    x = 32767;
+  if (x < -32768)
+    x = -32768;
+  put_be16(p, (uint16_t)x);
+}
+
+// Следующий отсчёт в регистры 0x3B..0x48: ±2g, ±250 °/с
+static void mpu_next_sample(void) {
+  double roll, roll_rate;
+  sweep(mpu.sample++, &roll, &roll_rate);
+  double pitch = roll * 2 / 3, pitch_rate = roll_rate * 2 / 3;
+  double r = roll * PI / 180, p = pitch * PI / 180;
+
+  uint8_t *d = &mpu.regs[MPU_ACCEL_XOUT_H];
+  put16(d + 0, -16384 * sin(p));
+  put16(d + 2, 16384 * sin(r) * cos(p));
+  put16(d + 4, 16384 * cos(r) * cos(p));
+  put16(d + 6, (25 - 36.53) * 340); // 25 °C
+  put16(d + 8, 131 * roll_rate);
+  put16(d + 10, 131 * pitch_rate);
+  put16(d + 12, 0);
+}
+
+static void mpu_twi(avr_irq_t *irq, uint32_t value, void *param) {
+  (void)irq, (void)param;
+  avr_twi_msg_irq_t v = {.u.v = value};
+
+  if (v.u.twi.msg & TWI_COND_STOP)
+    mpu.selected = 0;
+
+  if (v.u.twi.msg & TWI_COND_START) {
+    mpu.selected = 0;
+    mpu.reg_written = 0;
+    if ((v.u.twi.addr & ~1) == MPU_ADDR) {
+      mpu.selected = v.u.twi.addr;
+      avr_raise_irq(mpu.irq + TWI_IRQ_INPUT,
+                    avr_twi_irq_msg(TWI_COND_ACK, mpu.selected, 1));
+      if ((v.u.twi.addr & 1) && mpu.reg == MPU_ACCEL_XOUT_H)
+        mpu_next_sample();
+    }
+  }
+
+  if (!mpu.selected)
+    return;
+
+  if (v.u.twi.msg & TWI_COND_WRITE) {
+    avr_raise_irq(mpu.irq + TWI_IRQ_INPUT,
+                  avr_twi_irq_msg(TWI_COND_ACK, mpu.selected, 1));
+    if (!mpu.reg_written) {
+      mpu.reg = v.u.twi.data;
+      mpu.reg_written = 1;
+    } else if (mpu.reg != MPU_WHO_AM_I) {
+      mpu.regs[mpu.reg++] = v.u.twi.data;
+    }
+  }
+
+  if (v.u.twi.msg & TWI_COND_READ) {
+    avr_raise_irq(mpu.irq + TWI_IRQ_INPUT,
+                  avr_twi_irq_msg(TWI_COND_READ, mpu.selected,
+                                  mpu.regs[mpu.reg++]));
+  }
+}
+
+static void mpu_attach(void) {
+  mpu.irq = avr_alloc_irq(&avr->irq_pool, 0, 2, NULL);
+  mpu.regs[MPU_WHO_AM_I] = 0x68;
+  mpu.regs[0x6B] = 0x40; // PWR_MGMT_1 после сброса: сон
+  mpu_next_sample();
+  mpu.sample = 0;
+
+  avr_connect_irq(mpu.irq + TWI_IRQ_INPUT,
+                  avr_io_getirq(avr, AVR_IOCTL_TWI_GETIRQ(0), TWI_IRQ_INPUT));
+  avr_connect_irq(avr_io_getirq(avr, AVR_IOCTL_TWI_GETIRQ(0), TWI_IRQ_OUTPUT),
+                  mpu.irq + TWI_IRQ_OUTPUT);
+  avr_irq_register_notify(mpu.irq + TWI_IRQ_OUTPUT, mpu_twi, NULL);
+}
+
+// --- Отчёт ---
+
+static double us(uint64_t cycles) {
+  return cycles * 1e6 / avr->frequency;
+}
+
+static void report_row(const char *kind, const char *name, const Stat *s) {
+  uint64_t avg = (s->total + s->count / 2) / s->count;
+  printf("%-4s %-22s %6llu %10llu %10llu %10llu %9.1f %9.1f\n", kind, name,
+         (unsigned long long)s->count, (unsigned long long)s->min,
+         (unsigned long long)avg, (unsigned long long)s->max, us(avg),
+         us(s->max));
+}
+
+static void usage(const char *argv0) {
+  fprintf(stderr, "usage: %s [-b budget_us] [-t limit_s] firmware.elf\n",
+          argv0);
+  exit(2);
+}
+
+int main(int argc, char **argv) {
+  double budget_us = 0; // 0 — такт рендера из прошивки
+  double limit_s = 120;
+  const char *path = NULL;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "-b") == 0 && i + 1 < argc)
+      budget_us = atof(argv[++i]);
+    else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc)
+      limit_s = atof(argv[++i]);
+    else if (argv[i][0] != '-' && !path)
+      path = argv[i];
+    else
+      usage(argv[0]);
+  }
+  if (!path)
+    usage(argv[0]);
+
+  elf_firmware_t f;
+  memset(&f, 0, sizeof(f));
+  if (elf_read_firmware(path, &f) != 0) {
+    fprintf(stderr, "simavr_bench: cannot load %s\n", path);
+    return 2;
+  }
+  // Прошивка без секции .mmcu — плата MCU1/MCU2
+  if (!f.mmcu[0])
+    strcpy(f.mmcu, "atmega328p");
+  if (!f.frequency)
+    f.frequency = 16000000;
+
+  avr = avr_make_mcu_by_name(f.mmcu);
+  if (!avr) {
+    fprintf(stderr, "simavr_bench: unknown MCU %s\n", f.mmcu);
+    return 2;
+  }
+  avr_init(avr);
+  avr_load_firmware(avr, &f);
+
+  avr_register_io_write(avr, GPIOR0_ADDR, gpior0_write, NULL);
+  avr_register_io_write(avr, GPIOR1_ADDR, gpior1_write, NULL);
+
+  for (int v = 1; v < MAX_VECTORS; v++) {
+    avr_irq_t *irq = avr_get_interrupt_irq(avr, v);
+    if (irq)
+      avr_irq_register_notify(irq + AVR_INT_IRQ_RUNNING, isr_running,
+                              (void *)(intptr_t)v);
+  }
+
+  // UART без вывода simavr в stdout: текст разбираем сами
+  uint32_t flags = 0;
+  avr_ioctl(avr, AVR_IOCTL_UART_GET_FLAGS('0'), &flags);
+  flags &= ~AVR_UART_FLAG_STDIO;
+  avr_ioctl(avr, AVR_IOCTL_UART_SET_FLAGS('0'), &flags);
+  avr_irq_register_notify(
+      avr_io_getirq(avr, AVR_IOCTL_UART_GETIRQ('0'), UART_IRQ_OUTPUT),
+      uart_out, NULL);
+  avr_irq_register_notify(
+      avr_io_getirq(avr, AVR_IOCTL_UART_GETIRQ('0'), UART_IRQ_OUT_XON),
+      uart_xon, NULL);
+  avr_irq_register_notify(
+      avr_io_getirq(avr, AVR_IOCTL_UART_GETIRQ('0'), UART_IRQ_OUT_XOFF),
+      uart_xoff_hook, NULL);
+  uart_rx = avr_io_getirq(avr, AVR_IOCTL_UART_GETIRQ('0'), UART_IRQ_INPUT);
+
+  mpu_attach();
+
+  uint64_t limit = (uint64_t)(limit_s * avr->frequency);
+  int state = cpu_Running;
+  while (!done && avr->cycle < limit) {
+    state = avr_run(avr);
+    if (state == cpu_Done || state == cpu_Crashed)
+      break;
+  }
+
+  printf("%s: %s, %u Hz, %.3f s simulated, %u sensor samples\n", path,
+         f.mmcu, (unsigned)avr->frequency, avr->cycle / (double)avr->frequency,
+         mpu.sample);
+  printf("%-4s %-22s %6s %10s %10s %10s %9s %9s\n", "", "operation", "n",
+         "min cyc", "avg cyc", "max cyc", "avg us", "max us");
+  for (int i = 1; i < MAX_OPS; i++) {
+    if (ops[i].count)
+      report_row("op", ops[i].name[0] ? ops[i].name : "?", &ops[i]);
+  }
+  for (int v = 1; v < MAX_VECTORS; v++) {
+    if (isrs[v].count)
+      report_row("isr", vector_names[v], &isrs[v]);
+  }
+
+  if (!done) {
+    fprintf(stderr, "simavr_bench: firmware did not finish (%s)\n",
+            state == cpu_Crashed ? "crashed" : "cycle limit");
+    return 2;
+  }
+  if (stack_errors || depth) {
+    fprintf(stderr, "simavr_bench: unbalanced GPIOR0 markers\n");
+    return 2;
+  }
+
+  // Бюджет — на каждый кадр, по худшему
+  if (!budget_us)
+    budget_us = period_us;
+  if (!budget_us) {
+    fprintf(stderr, "simavr_bench: no budget: firmware sent no period\n");
+    return 2;
+  }
+  int over = 0, frames = 0;
+  for (int i = 1; i < MAX_OPS; i++) {
+    if (!ops[i].count || strncmp(ops[i].name, "frame_", 6) != 0)
+      continue;
+    frames++;
+    double worst = us(ops[i].max);
+    int ok = worst <= budget_us;
+    printf("budget %s: max %.1f us of %.0f us — %s\n", ops[i].name, worst,
+           budget_us, ok ? "ok" : "EXCEEDED");
+    over |= !ok;
+  }
+  if (!frames) {
+    fprintf(stderr, "simavr_bench: no frame_* operations measured\n");
+    return 2;
+  }
+  return over ? 1 : 0;
+}
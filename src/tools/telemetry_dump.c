@@ -0,0 +1,138 @@
+// Разбор телеметрии MCU1 (TELEMETRY=1) на ПК: отсчёты и кадры состояния
+// текстом, по мере прихода — можно читать порт вживую.
+//
+//   stty -F /dev/ttyUSB0 57600 raw && tools/telemetry_dump - < /dev/ttyUSB0
+//   tools/telemetry_dump [-s] dump.bin > field.txt
+//
+// Строка отсчёта: метка времени, сырые accel/gyro, температура в °C и
+// углы фильтра в градусах. Строки «#» — состояние и разрывы номеров;
+// -s оставляет только их. Итог — в stderr. Формат кадров —
+// lib/Telemetry/telemetry.h.
+#include "../lib/Attitude/attitude.h"
+#include "../lib/Link/link.h"
+#include "../lib/Telemetry/telemetry.h"
+
+#include <stdio.h>
+#include <string.h>
+
+// Задачи в порядке tasks[] из mcu1.c
+static const char *const task_names[TELEMETRY_TASKS] = {
+    "sensor", "link", "telemetry", "render"};
+
+static void print_status(uint8_t seq, const TelemetryStatus *st) {
+  printf("# status seq=%u read_errors=%u fifo_overflows=%u tx_replaced=%u "
+         "dropped=%u gap_max_us=%u",
+         seq, st->read_errors, st->fifo_overflows, st->tx_replaced,
+         st->dropped, st->gap_max_us);
+  for (int i = 0; i < TELEMETRY_TASKS; i++)
+    printf(" %s=%u/%u", task_names[i], st->task_worst_us[i],
+           st->task_overruns[i]);
+  putchar('\n');
+}
+
+static void print_sample(const TelemetrySample *s) {
+  const MPU6050Sample *m = &s->sample;
+  printf("%lu %d %d %d %d %d %d %.2f %.3f %.3f\n", (unsigned long)m->timestamp,
+         m->accel[0], m->accel[1], m->accel[2], m->gyro[0], m->gyro[1],
+         m->gyro[2], m->temp / 340.0 + 36.53, ATTITUDE_TO_DEG(s->roll),
+         ATTITUDE_TO_DEG(s->pitch));
+}
+
+int main(int argc, char **argv) {
+  int samples_out = 1;
+  const char *path = NULL;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "-s") == 0)
+      samples_out = 0;
+    else if (!path)
+      path = argv[i];
+    else {
+      path = NULL;
+      break;
+    }
+  }
+  if (!path) {
+    fprintf(stderr, "usage: telemetry_dump [-s] dump.bin|-\n");
+    return 2;
+  }
+  FILE *f = strcmp(path, "-") == 0 ? stdin : fopen(path, "rb");
+  if (!f) {
+    perror(path);
+    return 1;
+  }
+
+  printf("# t_us ax ay az gx gy gz temp_c roll_deg pitch_deg\n");
+  // Кадр без разделителя: нагрузка и байт COBS
+  uint8_t frame[TELEMETRY_HEADER_LEN +
+                TELEMETRY_BATCH_LIMIT * TELEMETRY_SAMPLE_LEN + 2];
+  unsigned len = 0;
+  int overflow = 0, have_seq = 0;
+  uint8_t last_seq = 0;
+  unsigned long frames = 0, samples = 0, lost = 0, bad = 0, attitude = 0;
+  uint32_t first_ts = 0, last_ts = 0;
+
+  int c;
+  while ((c = fgetc(f)) != EOF) {
+    if (c != 0x00) {
+      if (len < sizeof(frame))
+        frame[len++] = c;
+      else
+        overflow = 1;
+      continue;
+    }
+
+    uint8_t n, seq, flags, count;
+    TelemetrySample batch[TELEMETRY_BATCH_LIMIT];
+    TelemetryStatus status;
+    int8_t kind = -1;
+    int is_attitude = 0, empty = (len == 0);
+    if (!empty && !overflow && link_cobs_decode(frame, len, &n)) {
+      is_attitude = n == LINK_PAYLOAD_LEN && (frame[0] >> 4) == LINK_VERSION;
+      if (!is_attitude)
+        kind = telemetry_parse(frame, n, &seq, &flags, batch, &count, &status);
+    }
+    len = 0;
+    overflow = 0;
+    if (is_attitude) {
+      attitude++; // пакет MCU2
+      continue;
+    }
+    if (kind < 0) {
+      if (!empty)
+        bad++; // текст старта, сбои
+      continue;
+    }
+
+    frames++;
+    if (have_seq && (uint8_t)(seq - last_seq - 1)) {
+      uint8_t gap = seq - last_seq - 1;
+      lost += gap;
+      printf("# lost %u frames before seq %u\n", gap, seq);
+    }
+    last_seq = seq;
+    have_seq = 1;
+
+    if (kind == TELEMETRY_STATUS) {
+      print_status(seq, &status);
+    } else {
+      for (uint8_t i = 0; i < count; i++) {
+        if (!samples++)
+          first_ts = batch[i].sample.timestamp;
+        last_ts = batch[i].sample.timestamp;
+        if (samples_out)
+          print_sample(&batch[i]);
+      }
+    }
+    fflush(stdout);
+  }
+  if (f != stdin)
+    fclose(f);
+
+  fprintf(stderr, "%lu telemetry frames, %lu samples", frames, samples);
+  if (samples > 1 && last_ts != first_ts)
+    fprintf(stderr, " (%.1f Hz)",
+            (samples - 1) * 1e6 / (uint32_t)(last_ts - first_ts));
+  fprintf(stderr, ", %lu lost, %lu attitude frames, %lu bad frames\n", lost,
+          attitude, bad);
+  return 0;
+}